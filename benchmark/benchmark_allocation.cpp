@@ -0,0 +1,61 @@
+/***************************************************************************
+* Copyright (c) 2017, Johan Mabille, Sylvain Corlay, Wolf Vollprecht and   *
+* Martin Renou                                                             *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include "benchmark_fixture.hpp"
+
+namespace xf
+{
+    namespace bench
+    {
+        template <class L>
+        void allocation_xaxis_construction(benchmark::State& state)
+        {
+            auto labels = make_labels<L>(static_cast<std::size_t>(state.range(0)), state.range(1) != 0);
+            reset_allocation_stats();
+            for (auto _ : state)
+            {
+                xaxis<L, std::size_t, counting_tag> a(labels);
+                benchmark::DoNotOptimize(a);
+            }
+            report_allocations(state);
+        }
+        BENCHMARK_TEMPLATE(allocation_xaxis_construction, int)->Apply(size_and_sortedness);
+        BENCHMARK_TEMPLATE(allocation_xaxis_construction, fstring)->Apply(size_and_sortedness);
+
+        void allocation_xvariable_assign_aligned(benchmark::State& state)
+        {
+            std::size_t size = static_cast<std::size_t>(state.range(0));
+            auto a = make_variable<counting_variable_type>(size);
+            auto b = make_variable<counting_variable_type>(size);
+            reset_allocation_stats();
+            for (auto _ : state)
+            {
+                counting_variable_type res = a + b;
+                benchmark::DoNotOptimize(res.data().value().data());
+            }
+            report_allocations(state);
+        }
+        BENCHMARK(allocation_xvariable_assign_aligned)->Apply(variable_size);
+
+        void allocation_xvariable_assign_realigned(benchmark::State& state)
+        {
+            std::size_t size = static_cast<std::size_t>(state.range(0));
+            auto a = make_variable<counting_variable_type>(size);
+            auto b = make_variable<counting_variable_type>(size, true, size / 2);
+            reset_allocation_stats();
+            for (auto _ : state)
+            {
+                counting_variable_type res = a + b;
+                benchmark::DoNotOptimize(res.data().value().data());
+            }
+            report_allocations(state);
+        }
+        BENCHMARK(allocation_xvariable_assign_realigned)->Apply(variable_size);
+    }
+}
@@ -0,0 +1,164 @@
+/***************************************************************************
+* Copyright (c) 2017, Johan Mabille, Sylvain Corlay, Wolf Vollprecht and   *
+* Martin Renou                                                             *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XFRAME_BENCHMARK_FIXTURE_HPP
+#define XFRAME_BENCHMARK_FIXTURE_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+#include "xtensor/xarray.hpp"
+#include "xtensor/xoptional_assembly.hpp"
+#include "xframe/xallocator.hpp"
+#include "xframe/xvariable.hpp"
+
+namespace xf
+{
+    namespace bench
+    {
+        using saxis_type = xaxis<fstring, std::size_t>;
+        using iaxis_type = xaxis<int, std::size_t>;
+        using dimension_type = xdimension<fstring, std::size_t>;
+        using data_type = xt::xoptional_assembly<xt::xarray<double>, xt::xarray<bool>>;
+        using coordinate_type = xcoordinate<fstring>;
+        using variable_type = xvariable_container<coordinate_type, data_type>;
+
+        // Types allocating through xcounting_allocator
+        using counting_tag = allocator_tag<hash_map_tag, xcounting_allocator<char>>;
+        using counting_coordinate_type = xcoordinate<fstring, XFRAME_DEFAULT_LABEL_LIST, std::size_t, counting_tag>;
+        using counting_data_type = XFRAME_ALLOCATOR_DATA_CONTAINER(double, xcounting_allocator<double>);
+        using counting_variable_type = xvariable_container<counting_coordinate_type, counting_data_type>;
+
+        // Benchmark arguments are { size, sorted }, sizes ranging
+        // from 8 to 8 << 12.
+        constexpr std::int64_t min_size = 8;
+        constexpr std::int64_t max_size = 8 << 12;
+
+        inline void size_and_sortedness(benchmark::internal::Benchmark* b)
+        {
+            b->ArgNames({"size", "sorted"});
+            for (std::int64_t sorted = 0; sorted < 2; ++sorted)
+            {
+                for (std::int64_t size = min_size; size <= max_size; size *= 8)
+                {
+                    b->Args({size, sorted});
+                }
+            }
+        }
+
+        // Sizes of the square variables, the number of elements being size * size.
+        inline void variable_size(benchmark::internal::Benchmark* b)
+        {
+            b->ArgName("size");
+            for (std::int64_t size = 16; size <= 1024; size *= 4)
+            {
+                b->Arg(size);
+            }
+        }
+
+        /***************
+         * label lists *
+         ***************/
+
+        template <class L>
+        struct label_generator;
+
+        template <>
+        struct label_generator<int>
+        {
+            static int get(std::size_t i)
+            {
+                return static_cast<int>(i);
+            }
+        };
+
+        template <>
+        struct label_generator<fstring>
+        {
+            static fstring get(std::size_t i)
+            {
+                return fstring("label_" + std::to_string(i));
+            }
+        };
+
+        // Generates size distinct labels starting at offset, optionally shuffled
+        // with a fixed seed so that runs are comparable.
+        template <class L>
+        inline std::vector<L> make_labels(std::size_t size, bool sorted, std::size_t offset = 0)
+        {
+            std::vector<L> labels(size);
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                labels[i] = label_generator<L>::get(i + offset);
+            }
+            if (sorted)
+            {
+                std::sort(labels.begin(), labels.end());
+            }
+            else
+            {
+                std::mt19937 generator(42);
+                std::shuffle(labels.begin(), labels.end(), generator);
+            }
+            return labels;
+        }
+
+        template <class L, class MT = hash_map_tag>
+        inline xaxis<L, std::size_t, MT> make_axis(std::size_t size, bool sorted, std::size_t offset = 0)
+        {
+            return xaxis<L, std::size_t, MT>(make_labels<L>(size, sorted, offset));
+        }
+
+        /*************
+         * variables *
+         *************/
+
+        // Square variable with a string "abscissa" axis and an integral
+        // "ordinate" axis; one value out of seven is missing.
+        template <class V = variable_type>
+        inline V make_variable(std::size_t size, bool sorted = true, std::size_t offset = 0)
+        {
+            using coordinate_t = typename V::coordinate_type;
+            using map_tag_t = typename coordinate_t::axis_type::map_container_tag;
+            coordinate_t c = {{fstring("abscissa"), make_axis<fstring, map_tag_t>(size, sorted, offset)},
+                              {fstring("ordinate"), make_axis<int, map_tag_t>(size, sorted, offset)}};
+            V var(std::move(c), dimension_type({"abscissa", "ordinate"}));
+            auto& values = var.data().value();
+            auto& flags = var.data().has_value();
+            for (std::size_t i = 0; i < values.size(); ++i)
+            {
+                values.data()[i] = static_cast<double>(i);
+                flags.data()[i] = (i % 7) != 0;
+            }
+            return var;
+        }
+
+        /***************
+         * allocations *
+         ***************/
+
+        // Reports the allocations made through xcounting_allocator since
+        // the reset, per iteration
+        inline void report_allocations(benchmark::State& state)
+        {
+            xallocation_stats stats = get_allocation_stats();
+            double iterations = static_cast<double>(state.iterations());
+            state.counters["allocs"] = static_cast<double>(stats.m_allocations) / iterations;
+            state.counters["bytes"] = static_cast<double>(stats.m_allocated_bytes) / iterations;
+        }
+    }
+}
+
+#endif
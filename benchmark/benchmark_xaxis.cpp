@@ -0,0 +1,98 @@
+/***************************************************************************
+* Copyright (c) 2017, Johan Mabille, Sylvain Corlay, Wolf Vollprecht and   *
+* Martin Renou                                                             *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include "benchmark_fixture.hpp"
+
+namespace xf
+{
+    namespace bench
+    {
+        template <class L>
+        void xaxis_construction(benchmark::State& state)
+        {
+            auto labels = make_labels<L>(static_cast<std::size_t>(state.range(0)), state.range(1) != 0);
+            for (auto _ : state)
+            {
+                xaxis<L, std::size_t> a(labels);
+                benchmark::DoNotOptimize(a);
+            }
+            state.SetItemsProcessed(state.iterations() * state.range(0));
+        }
+        BENCHMARK_TEMPLATE(xaxis_construction, int)->Apply(size_and_sortedness);
+        BENCHMARK_TEMPLATE(xaxis_construction, fstring)->Apply(size_and_sortedness);
+
+        template <class L>
+        void xaxis_lookup(benchmark::State& state)
+        {
+            auto labels = make_labels<L>(static_cast<std::size_t>(state.range(0)), state.range(1) != 0);
+            xaxis<L, std::size_t> a(labels);
+            for (auto _ : state)
+            {
+                for (const auto& l : labels)
+                {
+                    benchmark::DoNotOptimize(a[l]);
+                }
+            }
+            state.SetItemsProcessed(state.iterations() * state.range(0));
+        }
+        BENCHMARK_TEMPLATE(xaxis_lookup, int)->Apply(size_and_sortedness);
+        BENCHMARK_TEMPLATE(xaxis_lookup, fstring)->Apply(size_and_sortedness);
+
+        template <class L>
+        void xaxis_positions(benchmark::State& state)
+        {
+            auto labels = make_labels<L>(static_cast<std::size_t>(state.range(0)), state.range(1) != 0);
+            xaxis<L, std::size_t> a(labels);
+            std::vector<std::size_t> res(labels.size());
+            for (auto _ : state)
+            {
+                a.positions(labels.cbegin(), labels.cend(), res.begin());
+                benchmark::DoNotOptimize(res.data());
+            }
+            state.SetItemsProcessed(state.iterations() * state.range(0));
+        }
+        BENCHMARK_TEMPLATE(xaxis_positions, int)->Apply(size_and_sortedness);
+        BENCHMARK_TEMPLATE(xaxis_positions, fstring)->Apply(size_and_sortedness);
+
+        // Axes overlapping on half of their labels
+        template <class L>
+        void xaxis_merge(benchmark::State& state)
+        {
+            std::size_t size = static_cast<std::size_t>(state.range(0));
+            bool sorted = state.range(1) != 0;
+            auto a1 = make_axis<L>(size, sorted);
+            auto a2 = make_axis<L>(size, sorted, size / 2);
+            for (auto _ : state)
+            {
+                xaxis<L, std::size_t> res;
+                benchmark::DoNotOptimize(merge_axes(res, a1, a2));
+            }
+            state.SetItemsProcessed(state.iterations() * state.range(0) * 2);
+        }
+        BENCHMARK_TEMPLATE(xaxis_merge, int)->Apply(size_and_sortedness);
+        BENCHMARK_TEMPLATE(xaxis_merge, fstring)->Apply(size_and_sortedness);
+
+        template <class L>
+        void xaxis_intersect(benchmark::State& state)
+        {
+            std::size_t size = static_cast<std::size_t>(state.range(0));
+            bool sorted = state.range(1) != 0;
+            auto a1 = make_axis<L>(size, sorted);
+            auto a2 = make_axis<L>(size, sorted, size / 2);
+            for (auto _ : state)
+            {
+                xaxis<L, std::size_t> res = a1;
+                benchmark::DoNotOptimize(intersect_axes(res, a2));
+            }
+            state.SetItemsProcessed(state.iterations() * state.range(0) * 2);
+        }
+        BENCHMARK_TEMPLATE(xaxis_intersect, int)->Apply(size_and_sortedness);
+        BENCHMARK_TEMPLATE(xaxis_intersect, fstring)->Apply(size_and_sortedness);
+    }
+}
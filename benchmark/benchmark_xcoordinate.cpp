@@ -0,0 +1,79 @@
+/***************************************************************************
+* Copyright (c) 2017, Johan Mabille, Sylvain Corlay, Wolf Vollprecht and   *
+* Martin Renou                                                             *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include "benchmark_fixture.hpp"
+
+#include "xframe/xcoordinate_cache.hpp"
+
+namespace xf
+{
+    namespace bench
+    {
+        // Broadcasting identical coordinates, the common case of
+        // operations between variables sharing their axes.
+        void xcoordinate_broadcast_same(benchmark::State& state)
+        {
+            std::size_t size = static_cast<std::size_t>(state.range(0));
+            bool sorted = state.range(1) != 0;
+            auto c1 = make_variable(size, sorted).coordinates();
+            auto c2 = c1;
+            for (auto _ : state)
+            {
+                coordinate_type res;
+                benchmark::DoNotOptimize(broadcast_coordinates<join::outer>(res, c1, c2));
+            }
+        }
+        BENCHMARK(xcoordinate_broadcast_same)->Apply(size_and_sortedness);
+
+        template <class Join>
+        void xcoordinate_broadcast(benchmark::State& state)
+        {
+            std::size_t size = static_cast<std::size_t>(state.range(0));
+            bool sorted = state.range(1) != 0;
+            auto c1 = make_variable(size, sorted).coordinates();
+            auto c2 = make_variable(size, sorted, size / 2).coordinates();
+            for (auto _ : state)
+            {
+                coordinate_type res;
+                benchmark::DoNotOptimize(broadcast_coordinates<Join>(res, c1, c2));
+            }
+        }
+        BENCHMARK_TEMPLATE(xcoordinate_broadcast, join::outer)->Apply(size_and_sortedness);
+        BENCHMARK_TEMPLATE(xcoordinate_broadcast, join::inner)->Apply(size_and_sortedness);
+
+        // Broadcasting through a full coordinate cache that never holds the
+        // result, the cost paid by every new expression when the cache is
+        // enabled; to be compared with xcoordinate_broadcast<join::outer>.
+        void xcoordinate_cache_miss(benchmark::State& state)
+        {
+            using cache_type = xcoordinate_cache<coordinate_type, 64>;
+            std::size_t size = static_cast<std::size_t>(state.range(0));
+            bool sorted = state.range(1) != 0;
+            auto c1 = make_variable(size, sorted).coordinates();
+            auto c2 = make_variable(size, sorted, size / 2).coordinates();
+            auto& cache = cache_type::instance();
+            cache.clear();
+            std::size_t stamp = 0;
+            for (auto _ : state)
+            {
+                auto key = detail::make_coordinate_cache_key<join::outer>();
+                key.push_back(stamp++);
+                coordinate_type res;
+                xtrivial_broadcast trivial;
+                if (!cache.find(key, res, trivial))
+                {
+                    trivial = broadcast_coordinates<join::outer>(res, c1, c2);
+                    cache.insert(std::move(key), res, trivial);
+                }
+                benchmark::DoNotOptimize(trivial);
+            }
+        }
+        BENCHMARK(xcoordinate_cache_miss)->Apply(size_and_sortedness);
+    }
+}
@@ -0,0 +1,43 @@
+/***************************************************************************
+* Copyright (c) 2017, Johan Mabille, Sylvain Corlay, Wolf Vollprecht and   *
+* Martin Renou                                                             *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include "xframe/xreindex_view.hpp"
+
+#include "benchmark_fixture.hpp"
+
+namespace xf
+{
+    namespace bench
+    {
+        // Iterates over a view reindexed on an axis twice as large as the
+        // original one, half of the values being missing
+        void xreindex_view_iteration(benchmark::State& state)
+        {
+            std::size_t size = static_cast<std::size_t>(state.range(0));
+            auto var = make_variable(size);
+            auto abscissa = make_labels<fstring>(2 * size, true);
+            auto view = reindex(var, {{"abscissa", xaxis<fstring, std::size_t>(abscissa)}});
+            for (auto _ : state)
+            {
+                double sum = 0.;
+                for (std::size_t i = 0; i < 2 * size; ++i)
+                {
+                    for (std::size_t j = 0; j < size; ++j)
+                    {
+                        auto v = view.iselect({{"abscissa", i}, {"ordinate", j}});
+                        sum += v.has_value() ? v.value() : 0.;
+                    }
+                }
+                benchmark::DoNotOptimize(sum);
+            }
+            state.SetItemsProcessed(state.iterations() * state.range(0) * state.range(0) * 2);
+        }
+        BENCHMARK(xreindex_view_iteration)->Apply(variable_size);
+    }
+}
@@ -0,0 +1,90 @@
+/***************************************************************************
+* Copyright (c) 2017, Johan Mabille, Sylvain Corlay, Wolf Vollprecht and   *
+* Martin Renou                                                             *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <vector>
+
+#include "benchmark_fixture.hpp"
+
+namespace xf
+{
+    namespace bench
+    {
+        void xvariable_locate(benchmark::State& state)
+        {
+            std::size_t size = static_cast<std::size_t>(state.range(0));
+            auto var = make_variable(size);
+            auto abscissa = make_labels<fstring>(size, true);
+            auto ordinate = make_labels<int>(size, true);
+            for (auto _ : state)
+            {
+                for (std::size_t i = 0; i < size; ++i)
+                {
+                    benchmark::DoNotOptimize(var.locate(abscissa[i], ordinate[size - i - 1]));
+                }
+            }
+            state.SetItemsProcessed(state.iterations() * state.range(0));
+        }
+        BENCHMARK(xvariable_locate)->Apply(variable_size);
+
+        void xvariable_select(benchmark::State& state)
+        {
+            std::size_t size = static_cast<std::size_t>(state.range(0));
+            auto var = make_variable(size);
+            auto abscissa = make_labels<fstring>(size, true);
+            auto ordinate = make_labels<int>(size, true);
+            for (auto _ : state)
+            {
+                for (std::size_t i = 0; i < size; ++i)
+                {
+                    benchmark::DoNotOptimize(var.select({{"abscissa", abscissa[i]}, {"ordinate", ordinate[size - i - 1]}}));
+                }
+            }
+            state.SetItemsProcessed(state.iterations() * state.range(0));
+        }
+        BENCHMARK(xvariable_select)->Apply(variable_size);
+
+        void xvariable_select_batch(benchmark::State& state)
+        {
+            using batch_type = variable_type::batch_selector_type;
+            std::size_t size = static_cast<std::size_t>(state.range(0));
+            auto var = make_variable(size);
+            auto abscissa = make_labels<fstring>(size, true);
+            auto ordinate = make_labels<int>(size, true);
+            batch_type batch({"abscissa", "ordinate"});
+            batch.reserve(size);
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                batch.push_back({abscissa[i], ordinate[size - i - 1]});
+            }
+            std::vector<variable_type::value_type> res(size);
+            for (auto _ : state)
+            {
+                var.select_batch(batch, res.begin());
+                benchmark::DoNotOptimize(res.data());
+            }
+            state.SetItemsProcessed(state.iterations() * state.range(0));
+        }
+        BENCHMARK(xvariable_select_batch)->Apply(variable_size);
+
+        void xvariable_iselect(benchmark::State& state)
+        {
+            std::size_t size = static_cast<std::size_t>(state.range(0));
+            auto var = make_variable(size);
+            for (auto _ : state)
+            {
+                for (std::size_t i = 0; i < size; ++i)
+                {
+                    benchmark::DoNotOptimize(var.iselect({{"abscissa", i}, {"ordinate", size - i - 1}}));
+                }
+            }
+            state.SetItemsProcessed(state.iterations() * state.range(0));
+        }
+        BENCHMARK(xvariable_iselect)->Apply(variable_size);
+    }
+}
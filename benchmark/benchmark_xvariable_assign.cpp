@@ -0,0 +1,69 @@
+/***************************************************************************
+* Copyright (c) 2017, Johan Mabille, Sylvain Corlay, Wolf Vollprecht and   *
+* Martin Renou                                                             *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include "benchmark_fixture.hpp"
+
+namespace xf
+{
+    namespace bench
+    {
+        // Operands sharing their coordinates: no realignment
+        void xvariable_assign_aligned(benchmark::State& state)
+        {
+            std::size_t size = static_cast<std::size_t>(state.range(0));
+            auto a = make_variable(size);
+            auto b = make_variable(size);
+            for (auto _ : state)
+            {
+                variable_type res = a + b;
+                benchmark::DoNotOptimize(res.data().value().data());
+            }
+            state.SetItemsProcessed(state.iterations() * state.range(0) * state.range(0));
+        }
+        BENCHMARK(xvariable_assign_aligned)->Apply(variable_size);
+
+        // Operands overlapping on half of their labels: the assignment
+        // goes through the label-based realignment
+        void xvariable_assign_realigned(benchmark::State& state)
+        {
+            std::size_t size = static_cast<std::size_t>(state.range(0));
+            auto a = make_variable(size);
+            auto b = make_variable(size, true, size / 2);
+            for (auto _ : state)
+            {
+                variable_type res = a + b;
+                benchmark::DoNotOptimize(res.data().value().data());
+            }
+            state.SetItemsProcessed(state.iterations() * state.range(0) * state.range(0));
+        }
+        BENCHMARK(xvariable_assign_realigned)->Apply(variable_size);
+
+        // End-to-end scenario: a chain of element-wise operations followed by
+        // the selection of a handful of results
+        void xvariable_scenario_pipeline(benchmark::State& state)
+        {
+            std::size_t size = static_cast<std::size_t>(state.range(0));
+            auto a = make_variable(size);
+            auto b = make_variable(size, true, size / 4);
+            auto c = make_variable(size, true, size / 2);
+            auto abscissa = make_labels<fstring>(size, true, size / 2);
+            auto ordinate = make_labels<int>(size, true, size / 2);
+            for (auto _ : state)
+            {
+                variable_type res = (a + b) * 2. - c / 3.;
+                for (std::size_t i = 0; i < size / 2; i += 8)
+                {
+                    benchmark::DoNotOptimize(res.locate(abscissa[i], ordinate[i]));
+                }
+            }
+            state.SetItemsProcessed(state.iterations() * state.range(0) * state.range(0));
+        }
+        BENCHMARK(xvariable_scenario_pipeline)->Apply(variable_size);
+    }
+}
@@ -0,0 +1,55 @@
+/***************************************************************************
+* Copyright (c) 2017, Johan Mabille, Sylvain Corlay, Wolf Vollprecht and   *
+* Martin Renou                                                             *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include "xframe/xvariable_masked_view.hpp"
+
+#include "benchmark_fixture.hpp"
+
+namespace xf
+{
+    namespace bench
+    {
+        // Assigns a scalar through a view masking half of the ordinates
+        void xvariable_masked_view_write(benchmark::State& state)
+        {
+            std::size_t size = static_cast<std::size_t>(state.range(0));
+            auto var = make_variable(size);
+            int threshold = static_cast<int>(size / 2);
+            for (auto _ : state)
+            {
+                auto masked = where(var, var.axis<int>("ordinate") < threshold);
+                masked = 1.;
+                benchmark::DoNotOptimize(var.data().value().data());
+            }
+            state.SetItemsProcessed(state.iterations() * state.range(0) * state.range(0));
+        }
+        BENCHMARK(xvariable_masked_view_write)->Apply(variable_size);
+
+        void xvariable_masked_view_read(benchmark::State& state)
+        {
+            std::size_t size = static_cast<std::size_t>(state.range(0));
+            auto var = make_variable(size);
+            auto masked = where(var, var.axis<int>("ordinate") < static_cast<int>(size / 2));
+            for (auto _ : state)
+            {
+                std::size_t count = 0;
+                for (std::size_t i = 0; i < size; ++i)
+                {
+                    for (std::size_t j = 0; j < size; ++j)
+                    {
+                        count += masked.iselect({{"abscissa", i}, {"ordinate", j}}).has_value() ? 1u : 0u;
+                    }
+                }
+                benchmark::DoNotOptimize(count);
+            }
+            state.SetItemsProcessed(state.iterations() * state.range(0) * state.range(0));
+        }
+        BENCHMARK(xvariable_masked_view_read)->Apply(variable_size);
+    }
+}
@@ -0,0 +1,105 @@
+/***************************************************************************
+* Copyright (c) 2017, Johan Mabille, Sylvain Corlay, Wolf Vollprecht and   *
+* Martin Renou                                                             *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include "xframe/xvariable_view.hpp"
+
+#include "benchmark_fixture.hpp"
+
+namespace xf
+{
+    namespace bench
+    {
+        // Ordinate slices selecting every other label: a stepped range,
+        // read through the strided data, and the equivalent keep slice,
+        // read through the dynamic view.
+        template <class E>
+        inline auto make_range_view(E& var, std::size_t size)
+        {
+            return iselect(var, {{"ordinate", irange(0, static_cast<int>(size), 2)}});
+        }
+
+        template <class E>
+        inline auto make_keep_view(E& var, std::size_t size)
+        {
+            std::vector<std::ptrdiff_t> indices;
+            for (std::size_t i = 0; i < size; i += 2)
+            {
+                indices.push_back(static_cast<std::ptrdiff_t>(i));
+            }
+            return iselect(var, {{"ordinate", ikeep(std::move(indices))}});
+        }
+
+        template <class V>
+        inline void read_view(benchmark::State& state, V& view, std::size_t size)
+        {
+            std::size_t half = (size + 1) / 2;
+            for (auto _ : state)
+            {
+                std::size_t count = 0;
+                for (std::size_t i = 0; i < size; ++i)
+                {
+                    for (std::size_t j = 0; j < half; ++j)
+                    {
+                        count += view(i, j).has_value() ? 1u : 0u;
+                    }
+                }
+                benchmark::DoNotOptimize(count);
+            }
+            state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(size * half));
+        }
+
+        template <class V>
+        inline void copy_view(benchmark::State& state, const V& view, std::size_t size)
+        {
+            std::size_t half = (size + 1) / 2;
+            for (auto _ : state)
+            {
+                variable_type res = view;
+                benchmark::DoNotOptimize(res.data().value().data());
+            }
+            state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(size * half));
+        }
+
+        void xvariable_view_read_range(benchmark::State& state)
+        {
+            std::size_t size = static_cast<std::size_t>(state.range(0));
+            auto var = make_variable(size);
+            auto view = make_range_view(var, size);
+            read_view(state, view, size);
+        }
+        BENCHMARK(xvariable_view_read_range)->Apply(variable_size);
+
+        void xvariable_view_read_keep(benchmark::State& state)
+        {
+            std::size_t size = static_cast<std::size_t>(state.range(0));
+            auto var = make_variable(size);
+            auto view = make_keep_view(var, size);
+            read_view(state, view, size);
+        }
+        BENCHMARK(xvariable_view_read_keep)->Apply(variable_size);
+
+        void xvariable_view_copy_range(benchmark::State& state)
+        {
+            std::size_t size = static_cast<std::size_t>(state.range(0));
+            auto var = make_variable(size);
+            auto view = make_range_view(var, size);
+            copy_view(state, view, size);
+        }
+        BENCHMARK(xvariable_view_copy_range)->Apply(variable_size);
+
+        void xvariable_view_copy_keep(benchmark::State& state)
+        {
+            std::size_t size = static_cast<std::size_t>(state.range(0));
+            auto var = make_variable(size);
+            auto view = make_keep_view(var, size);
+            copy_view(state, view, size);
+        }
+        BENCHMARK(xvariable_view_copy_keep)->Apply(variable_size);
+    }
+}
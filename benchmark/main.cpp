@@ -0,0 +1,30 @@
+/***************************************************************************
+* Copyright (c) 2017, Johan Mabille, Sylvain Corlay, Wolf Vollprecht and   *
+* Martin Renou                                                             *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <string>
+
+#include "benchmark/benchmark.h"
+
+#include "xframe/xframe_config.hpp"
+
+int main(int argc, char* argv[])
+{
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv))
+    {
+        return 1;
+    }
+    benchmark::AddCustomContext("xframe_version",
+                                std::to_string(XFRAME_VERSION_MAJOR) + "." +
+                                std::to_string(XFRAME_VERSION_MINOR) + "." +
+                                std::to_string(XFRAME_VERSION_PATCH));
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
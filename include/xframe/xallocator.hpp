@@ -0,0 +1,209 @@
+/***************************************************************************
+* Copyright (c) 2017, Johan Mabille, Sylvain Corlay and Wolf Vollprecht    *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XFRAME_XALLOCATOR_HPP
+#define XFRAME_XALLOCATOR_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+
+namespace xf
+{
+
+    /*********************
+     * xallocation_stats *
+     *********************/
+
+    /**
+     * @class xallocation_stats
+     * @brief Snapshot of the allocations made through xcounting_allocator.
+     */
+    struct xallocation_stats
+    {
+        std::size_t m_allocations = 0;
+        std::size_t m_deallocations = 0;
+        std::size_t m_allocated_bytes = 0;
+        std::size_t m_deallocated_bytes = 0;
+
+        std::size_t live_bytes() const noexcept;
+    };
+
+    xallocation_stats get_allocation_stats() noexcept;
+    void reset_allocation_stats() noexcept;
+
+    /***********************
+     * xcounting_allocator *
+     ***********************/
+
+    /**
+     * @class xcounting_allocator
+     * @brief Allocator adaptor recording the number and the size of allocations.
+     *
+     * The statistics are global and can be read with get_allocation_stats.
+     * Using it in the map tag of the coordinates (see allocator_tag) and in
+     * the data container (see XFRAME_ALLOCATOR_DATA_CONTAINER) makes it possible
+     * to measure the allocations of an operation.
+     *
+     * @tparam T the value type.
+     * @tparam A the underlying allocator.
+     */
+    template <class T, class A = std::allocator<T>>
+    class xcounting_allocator : private std::allocator_traits<A>::template rebind_alloc<T>
+    {
+    public:
+
+        using base_type = typename std::allocator_traits<A>::template rebind_alloc<T>;
+        using base_traits = std::allocator_traits<base_type>;
+
+        using value_type = T;
+        using pointer = typename base_traits::pointer;
+        using const_pointer = typename base_traits::const_pointer;
+        using size_type = typename base_traits::size_type;
+        using difference_type = typename base_traits::difference_type;
+
+        using propagate_on_container_copy_assignment = typename base_traits::propagate_on_container_copy_assignment;
+        using propagate_on_container_move_assignment = typename base_traits::propagate_on_container_move_assignment;
+        using propagate_on_container_swap = typename base_traits::propagate_on_container_swap;
+
+        template <class U>
+        struct rebind
+        {
+            using other = xcounting_allocator<U, typename std::allocator_traits<A>::template rebind_alloc<U>>;
+        };
+
+        xcounting_allocator() = default;
+        explicit xcounting_allocator(const base_type& alloc) noexcept;
+
+        template <class U, class B>
+        xcounting_allocator(const xcounting_allocator<U, B>& rhs) noexcept;
+
+        pointer allocate(size_type n);
+        void deallocate(pointer p, size_type n);
+
+        const base_type& base() const noexcept;
+    };
+
+    template <class T1, class A1, class T2, class A2>
+    bool operator==(const xcounting_allocator<T1, A1>& lhs, const xcounting_allocator<T2, A2>& rhs) noexcept;
+
+    template <class T1, class A1, class T2, class A2>
+    bool operator!=(const xcounting_allocator<T1, A1>& lhs, const xcounting_allocator<T2, A2>& rhs) noexcept;
+
+    /************************************
+     * xallocation_stats implementation *
+     ************************************/
+
+    namespace detail
+    {
+        struct xallocation_storage
+        {
+            std::atomic<std::size_t> m_allocations{0};
+            std::atomic<std::size_t> m_deallocations{0};
+            std::atomic<std::size_t> m_allocated_bytes{0};
+            std::atomic<std::size_t> m_deallocated_bytes{0};
+        };
+
+        inline xallocation_storage& allocation_storage() noexcept
+        {
+            static xallocation_storage storage;
+            return storage;
+        }
+    }
+
+    /**
+     * Returns the number of bytes allocated and not deallocated yet.
+     */
+    inline std::size_t xallocation_stats::live_bytes() const noexcept
+    {
+        return m_allocated_bytes - m_deallocated_bytes;
+    }
+
+    /**
+     * Returns the statistics of the allocations made through xcounting_allocator.
+     */
+    inline xallocation_stats get_allocation_stats() noexcept
+    {
+        const auto& storage = detail::allocation_storage();
+        xallocation_stats res;
+        res.m_allocations = storage.m_allocations.load(std::memory_order_relaxed);
+        res.m_deallocations = storage.m_deallocations.load(std::memory_order_relaxed);
+        res.m_allocated_bytes = storage.m_allocated_bytes.load(std::memory_order_relaxed);
+        res.m_deallocated_bytes = storage.m_deallocated_bytes.load(std::memory_order_relaxed);
+        return res;
+    }
+
+    /**
+     * Sets the allocation statistics to zero.
+     */
+    inline void reset_allocation_stats() noexcept
+    {
+        auto& storage = detail::allocation_storage();
+        storage.m_allocations.store(0, std::memory_order_relaxed);
+        storage.m_deallocations.store(0, std::memory_order_relaxed);
+        storage.m_allocated_bytes.store(0, std::memory_order_relaxed);
+        storage.m_deallocated_bytes.store(0, std::memory_order_relaxed);
+    }
+
+    /**************************************
+     * xcounting_allocator implementation *
+     **************************************/
+
+    template <class T, class A>
+    inline xcounting_allocator<T, A>::xcounting_allocator(const base_type& alloc) noexcept
+        : base_type(alloc)
+    {
+    }
+
+    template <class T, class A>
+    template <class U, class B>
+    inline xcounting_allocator<T, A>::xcounting_allocator(const xcounting_allocator<U, B>& rhs) noexcept
+        : base_type(rhs.base())
+    {
+    }
+
+    template <class T, class A>
+    inline auto xcounting_allocator<T, A>::allocate(size_type n) -> pointer
+    {
+        pointer res = base_traits::allocate(static_cast<base_type&>(*this), n);
+        auto& storage = detail::allocation_storage();
+        storage.m_allocations.fetch_add(1, std::memory_order_relaxed);
+        storage.m_allocated_bytes.fetch_add(n * sizeof(T), std::memory_order_relaxed);
+        return res;
+    }
+
+    template <class T, class A>
+    inline void xcounting_allocator<T, A>::deallocate(pointer p, size_type n)
+    {
+        base_traits::deallocate(static_cast<base_type&>(*this), p, n);
+        auto& storage = detail::allocation_storage();
+        storage.m_deallocations.fetch_add(1, std::memory_order_relaxed);
+        storage.m_deallocated_bytes.fetch_add(n * sizeof(T), std::memory_order_relaxed);
+    }
+
+    template <class T, class A>
+    inline auto xcounting_allocator<T, A>::base() const noexcept -> const base_type&
+    {
+        return *this;
+    }
+
+    template <class T1, class A1, class T2, class A2>
+    inline bool operator==(const xcounting_allocator<T1, A1>& lhs, const xcounting_allocator<T2, A2>& rhs) noexcept
+    {
+        return lhs.base() == typename xcounting_allocator<T1, A1>::base_type(rhs.base());
+    }
+
+    template <class T1, class A1, class T2, class A2>
+    inline bool operator!=(const xcounting_allocator<T1, A1>& lhs, const xcounting_allocator<T2, A2>& rhs) noexcept
+    {
+        return !(lhs == rhs);
+    }
+}
+
+#endif
@@ -0,0 +1,797 @@
+/***************************************************************************
+* Copyright (c) 2017, Johan Mabille, Sylvain Corlay and Wolf Vollprecht    *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XFRAME_XARROW_HPP
+#define XFRAME_XARROW_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "xtensor/xarray.hpp"
+#include "xtensor/xbuffer_adaptor.hpp"
+#include "xtensor/xoptional_assembly.hpp"
+
+#include "xcoordinate.hpp"
+#include "xdimension.hpp"
+#include "xvariable.hpp"
+
+/****************************
+ * Arrow C data interface   *
+ ****************************/
+
+// Structures defined by the Arrow C data interface specification. They are
+// ABI-stable and may already have been declared by another library.
+
+#ifndef ARROW_C_DATA_INTERFACE
+#define ARROW_C_DATA_INTERFACE
+
+#define ARROW_FLAG_DICTIONARY_ORDERED 1
+#define ARROW_FLAG_NULLABLE 2
+#define ARROW_FLAG_MAP_KEYS_SORTED 4
+
+extern "C"
+{
+    struct ArrowSchema
+    {
+        const char* format;
+        const char* name;
+        const char* metadata;
+        int64_t flags;
+        int64_t n_children;
+        struct ArrowSchema** children;
+        struct ArrowSchema* dictionary;
+        void (*release)(struct ArrowSchema*);
+        void* private_data;
+    };
+
+    struct ArrowArray
+    {
+        int64_t length;
+        int64_t null_count;
+        int64_t offset;
+        int64_t n_buffers;
+        int64_t n_children;
+        const void** buffers;
+        struct ArrowArray** children;
+        struct ArrowArray* dictionary;
+        void (*release)(struct ArrowArray*);
+        void* private_data;
+    };
+}
+
+#endif
+
+namespace xf
+{
+    namespace detail
+    {
+        template <class T>
+        using arrow_value_adaptor = xt::xarray_adaptor<xt::xbuffer_adaptor<T*, xt::no_ownership>,
+                                                       xt::layout_type::row_major,
+                                                       xt::dynamic_shape<std::size_t>>;
+    }
+
+    /**
+     * Variable type returned by adapt_arrow. Its values alias the value
+     * buffer of the imported Arrow array.
+     * @tparam T the value type.
+     * @tparam C the coordinate type.
+     */
+    template <class T, class C = xcoordinate<fstring>>
+    using xarrow_variable_adaptor = xvariable_container<C, xt::xoptional_assembly<detail::arrow_value_adaptor<T>, xt::xarray<bool>>>;
+
+    template <class CCT, class ECT>
+    void to_arrow(const xvariable_container<CCT, ECT>& variable, ArrowSchema* schema, ArrowArray* array,
+                  const std::string& value_name = "value");
+
+    template <class T, class C = xcoordinate<fstring>>
+    xvariable<T, C> from_arrow(const ArrowSchema& schema, const ArrowArray& array);
+
+    template <class T, class C = xcoordinate<fstring>>
+    xarrow_variable_adaptor<T, C> adapt_arrow(const ArrowSchema& schema, const ArrowArray& array);
+
+    /*************************
+     * arrow implementation  *
+     *************************/
+
+    namespace detail
+    {
+        template <class T>
+        inline std::enable_if_t<std::is_arithmetic<T>::value, const char*> arrow_format()
+        {
+            if (std::is_same<T, bool>::value)
+            {
+                return "b";
+            }
+            if (std::is_floating_point<T>::value)
+            {
+                switch (sizeof(T))
+                {
+                case 4:
+                    return "f";
+                case 8:
+                    return "g";
+                default:
+                    throw std::runtime_error("arrow: unsupported floating point type");
+                }
+            }
+            switch (sizeof(T))
+            {
+            case 1:
+                return std::is_signed<T>::value ? "c" : "C";
+            case 2:
+                return std::is_signed<T>::value ? "s" : "S";
+            case 4:
+                return std::is_signed<T>::value ? "i" : "I";
+            case 8:
+                return std::is_signed<T>::value ? "l" : "L";
+            default:
+                throw std::runtime_error("arrow: unsupported integral type");
+            }
+        }
+
+        template <class T>
+        inline std::enable_if_t<!std::is_arithmetic<T>::value, const char*> arrow_format()
+        {
+            return "u";
+        }
+
+        template <class T>
+        inline std::enable_if_t<std::is_arithmetic<T>::value, std::string> arrow_name(const T& name)
+        {
+            return std::to_string(name);
+        }
+
+        template <class T>
+        inline std::enable_if_t<!std::is_arithmetic<T>::value, std::string> arrow_name(const T& name)
+        {
+            return std::string(name.cbegin(), name.cend());
+        }
+
+        inline bool arrow_bit(const void* bitmap, std::int64_t i)
+        {
+            return (static_cast<const std::uint8_t*>(bitmap)[i >> 3] >> (i & 7)) & 1;
+        }
+
+        /**********************
+         * lifetime handling  *
+         **********************/
+
+        // Releases and deletes an exported structure; structures whose
+        // release callback is null have been moved out by the consumer.
+        struct arrow_deleter
+        {
+            void operator()(ArrowSchema* schema) const
+            {
+                if (schema->release != nullptr)
+                {
+                    schema->release(schema);
+                }
+                delete schema;
+            }
+
+            void operator()(ArrowArray* array) const
+            {
+                if (array->release != nullptr)
+                {
+                    array->release(array);
+                }
+                delete array;
+            }
+        };
+
+        using arrow_schema_ptr = std::unique_ptr<ArrowSchema, arrow_deleter>;
+        using arrow_array_ptr = std::unique_ptr<ArrowArray, arrow_deleter>;
+
+        inline arrow_schema_ptr make_arrow_schema_ptr()
+        {
+            return arrow_schema_ptr(new ArrowSchema());
+        }
+
+        inline arrow_array_ptr make_arrow_array_ptr()
+        {
+            return arrow_array_ptr(new ArrowArray());
+        }
+
+        // Transfers the ownership of an exported structure to its parent
+        template <class T>
+        inline void arrow_adopt(std::vector<T*>& children, std::unique_ptr<T, arrow_deleter>& child)
+        {
+            children.push_back(child.get());
+            child.release();
+        }
+
+        struct arrow_schema_private
+        {
+            arrow_schema_private(std::string format, std::string name)
+                : m_format(std::move(format)), m_name(std::move(name))
+            {
+            }
+
+            ~arrow_schema_private()
+            {
+                for (ArrowSchema* child : m_children)
+                {
+                    arrow_deleter()(child);
+                }
+                if (m_dictionary != nullptr)
+                {
+                    arrow_deleter()(m_dictionary);
+                }
+            }
+
+            arrow_schema_private(const arrow_schema_private&) = delete;
+            arrow_schema_private& operator=(const arrow_schema_private&) = delete;
+
+            std::string m_format;
+            std::string m_name;
+            std::vector<ArrowSchema*> m_children;
+            ArrowSchema* m_dictionary = nullptr;
+        };
+
+        struct arrow_array_private
+        {
+            arrow_array_private() = default;
+
+            ~arrow_array_private()
+            {
+                for (ArrowArray* child : m_children)
+                {
+                    arrow_deleter()(child);
+                }
+                if (m_dictionary != nullptr)
+                {
+                    arrow_deleter()(m_dictionary);
+                }
+            }
+
+            arrow_array_private(const arrow_array_private&) = delete;
+            arrow_array_private& operator=(const arrow_array_private&) = delete;
+
+            template <class T>
+            const void* own(std::vector<T>&& buffer)
+            {
+                auto ptr = std::make_shared<std::vector<T>>(std::move(buffer));
+                m_owned.push_back(ptr);
+                return ptr->data();
+            }
+
+            std::vector<std::shared_ptr<void>> m_owned;
+            std::vector<const void*> m_buffers;
+            std::vector<ArrowArray*> m_children;
+            ArrowArray* m_dictionary = nullptr;
+        };
+
+        using arrow_schema_private_ptr = std::unique_ptr<arrow_schema_private>;
+        using arrow_array_private_ptr = std::unique_ptr<arrow_array_private>;
+
+        inline void release_arrow_schema(ArrowSchema* schema)
+        {
+            delete static_cast<arrow_schema_private*>(schema->private_data);
+            schema->release = nullptr;
+        }
+
+        inline void release_arrow_array(ArrowArray* array)
+        {
+            delete static_cast<arrow_array_private*>(array->private_data);
+            array->release = nullptr;
+        }
+
+        // The schema takes the ownership of its private data
+        inline void make_arrow_schema(ArrowSchema* schema, arrow_schema_private_ptr p, std::int64_t flags)
+        {
+            schema->format = p->m_format.c_str();
+            schema->name = p->m_name.c_str();
+            schema->metadata = nullptr;
+            schema->flags = flags;
+            schema->n_children = static_cast<std::int64_t>(p->m_children.size());
+            schema->children = p->m_children.empty() ? nullptr : p->m_children.data();
+            schema->dictionary = p->m_dictionary;
+            schema->release = &release_arrow_schema;
+            schema->private_data = p.release();
+        }
+
+        // The array takes the ownership of its private data
+        inline void make_arrow_array(ArrowArray* array, arrow_array_private_ptr p, std::size_t length, std::size_t null_count)
+        {
+            array->length = static_cast<std::int64_t>(length);
+            array->null_count = static_cast<std::int64_t>(null_count);
+            array->offset = 0;
+            array->n_buffers = static_cast<std::int64_t>(p->m_buffers.size());
+            array->n_children = static_cast<std::int64_t>(p->m_children.size());
+            array->buffers = p->m_buffers.data();
+            array->children = p->m_children.empty() ? nullptr : p->m_children.data();
+            array->dictionary = p->m_dictionary;
+            array->release = &release_arrow_array;
+            array->private_data = p.release();
+        }
+
+        /*****************
+         * dictionaries  *
+         *****************/
+
+        // Arithmetic labels alias the label buffer of the axis
+        template <class LL>
+        inline std::enable_if_t<std::is_arithmetic<typename LL::value_type>::value>
+        export_dictionary(const LL& labels, ArrowSchema* schema, ArrowArray* array)
+        {
+            arrow_array_private_ptr p(new arrow_array_private());
+            p->m_buffers = { nullptr, labels.data() };
+            make_arrow_schema(schema, arrow_schema_private_ptr(new arrow_schema_private(arrow_format<typename LL::value_type>(), "")), 0);
+            make_arrow_array(array, std::move(p), labels.size(), 0);
+        }
+
+        template <class LL>
+        inline std::enable_if_t<!std::is_arithmetic<typename LL::value_type>::value>
+        export_dictionary(const LL& labels, ArrowSchema* schema, ArrowArray* array)
+        {
+            std::vector<std::int32_t> offsets;
+            offsets.reserve(labels.size() + 1);
+            std::vector<char> data;
+            for (const auto& l : labels)
+            {
+                offsets.push_back(static_cast<std::int32_t>(data.size()));
+                data.insert(data.end(), l.cbegin(), l.cend());
+            }
+            if (data.size() > static_cast<std::size_t>(std::numeric_limits<std::int32_t>::max()))
+            {
+                throw std::runtime_error("arrow: labels too large for 32-bit string offsets");
+            }
+            offsets.push_back(static_cast<std::int32_t>(data.size()));
+
+            arrow_array_private_ptr p(new arrow_array_private());
+            p->m_buffers.push_back(nullptr);
+            p->m_buffers.push_back(p->own(std::move(offsets)));
+            p->m_buffers.push_back(p->own(std::move(data)));
+            make_arrow_schema(schema, arrow_schema_private_ptr(new arrow_schema_private("u", "")), 0);
+            make_arrow_array(array, std::move(p), labels.size(), 0);
+        }
+
+        template <class L>
+        inline std::enable_if_t<std::is_arithmetic<L>::value, std::vector<L>>
+        import_dictionary(const ArrowArray& array)
+        {
+            const L* data = static_cast<const L*>(array.buffers[1]) + array.offset;
+            return std::vector<L>(data, data + array.length);
+        }
+
+        template <class L>
+        inline std::enable_if_t<!std::is_arithmetic<L>::value, std::vector<L>>
+        import_dictionary(const ArrowArray& array)
+        {
+            const std::int32_t* offsets = static_cast<const std::int32_t*>(array.buffers[1]) + array.offset;
+            const char* data = static_cast<const char*>(array.buffers[2]);
+            std::vector<L> res;
+            res.reserve(static_cast<std::size_t>(array.length));
+            for (std::int64_t i = 0; i < array.length; ++i)
+            {
+                res.push_back(L(std::string(data + offsets[i], data + offsets[i + 1]).c_str()));
+            }
+            return res;
+        }
+
+        template <class... L>
+        struct arrow_axis_io;
+
+        template <>
+        struct arrow_axis_io<>
+        {
+            template <class A>
+            static void export_labels(const A&, std::size_t, ArrowSchema*, ArrowArray*)
+            {
+                throw std::runtime_error("arrow: unsupported label type");
+            }
+
+            template <class A>
+            static A import_labels(const ArrowSchema& schema, const ArrowArray&)
+            {
+                throw std::runtime_error(std::string("arrow: unsupported dictionary type ") + schema.format);
+            }
+        };
+
+        template <class L0, class... L>
+        struct arrow_axis_io<L0, L...>
+        {
+            template <class A>
+            static void export_labels(const A& axis, std::size_t index, ArrowSchema* schema, ArrowArray* array)
+            {
+                if (index == 0)
+                {
+                    export_dictionary(get_labels<L0>(axis), schema, array);
+                }
+                else
+                {
+                    arrow_axis_io<L...>::export_labels(axis, index - 1, schema, array);
+                }
+            }
+
+            template <class A>
+            static A import_labels(const ArrowSchema& schema, const ArrowArray& array)
+            {
+                if (std::strcmp(schema.format, arrow_format<L0>()) == 0)
+                {
+                    using axis_type = xaxis<L0, typename A::mapped_type, typename A::map_container_tag>;
+                    return A(axis_type(import_dictionary<L0>(array)));
+                }
+                else
+                {
+                    return arrow_axis_io<L...>::template import_labels<A>(schema, array);
+                }
+            }
+        };
+
+        /************
+         * columns  *
+         ************/
+
+        // The offset and length are those of the parent struct array
+        template <class I>
+        inline std::vector<std::size_t> arrow_indices(const ArrowArray& array, std::int64_t offset, std::int64_t length)
+        {
+            const I* data = static_cast<const I*>(array.buffers[1]) + array.offset + offset;
+            std::vector<std::size_t> res(static_cast<std::size_t>(length));
+            for (std::size_t i = 0; i < res.size(); ++i)
+            {
+                res[i] = static_cast<std::size_t>(data[i]);
+            }
+            return res;
+        }
+
+        inline std::vector<std::size_t> arrow_indices(const ArrowSchema& schema, const ArrowArray& array,
+                                                      std::int64_t offset, std::int64_t length)
+        {
+            if (schema.dictionary == nullptr || array.dictionary == nullptr)
+            {
+                throw std::runtime_error("arrow: dimension columns must be dictionary encoded");
+            }
+            if (array.null_count != 0)
+            {
+                throw std::runtime_error("arrow: dimension columns cannot hold null values");
+            }
+            switch (schema.format[0])
+            {
+            case 'c':
+                return arrow_indices<std::int8_t>(array, offset, length);
+            case 's':
+                return arrow_indices<std::int16_t>(array, offset, length);
+            case 'i':
+                return arrow_indices<std::int32_t>(array, offset, length);
+            case 'l':
+                return arrow_indices<std::int64_t>(array, offset, length);
+            default:
+                throw std::runtime_error(std::string("arrow: unsupported dictionary index type ") + schema.format);
+            }
+        }
+
+        template <class T>
+        inline std::enable_if_t<std::is_same<T, bool>::value, T> arrow_value(const ArrowArray& array, std::int64_t i)
+        {
+            return arrow_bit(array.buffers[1], array.offset + i);
+        }
+
+        template <class T>
+        inline std::enable_if_t<!std::is_same<T, bool>::value, T> arrow_value(const ArrowArray& array, std::int64_t i)
+        {
+            return static_cast<const T*>(array.buffers[1])[array.offset + i];
+        }
+
+        template <class E>
+        inline std::enable_if_t<std::is_same<typename E::value_type, bool>::value, const void*>
+        export_values(const E& values, arrow_array_private* p)
+        {
+            std::vector<std::uint8_t> bits((values.size() + 7) / 8, std::uint8_t(0));
+            std::size_t i = 0;
+            for (auto it = values.template cbegin<xt::layout_type::row_major>(); it != values.template cend<xt::layout_type::row_major>(); ++it, ++i)
+            {
+                bits[i >> 3] |= static_cast<std::uint8_t>(std::uint8_t(*it) << (i & 7));
+            }
+            return p->own(std::move(bits));
+        }
+
+        // Row-major contiguous values are aliased, other layouts are copied
+        template <class E>
+        inline std::enable_if_t<!std::is_same<typename E::value_type, bool>::value, const void*>
+        export_values(const E& values, arrow_array_private* p)
+        {
+            if (values.layout() == xt::layout_type::row_major)
+            {
+                return values.raw_data();
+            }
+            std::vector<typename E::value_type> buffer(values.template cbegin<xt::layout_type::row_major>(),
+                                                       values.template cend<xt::layout_type::row_major>());
+            return p->own(std::move(buffer));
+        }
+
+        template <class E>
+        inline std::size_t export_validity(const E& flags, arrow_array_private* p)
+        {
+            std::vector<std::uint8_t> bits((flags.size() + 7) / 8, std::uint8_t(0));
+            std::size_t i = 0;
+            std::size_t null_count = 0;
+            for (auto it = flags.template cbegin<xt::layout_type::row_major>(); it != flags.template cend<xt::layout_type::row_major>(); ++it, ++i)
+            {
+                if (*it)
+                {
+                    bits[i >> 3] |= static_cast<std::uint8_t>(1u << (i & 7));
+                }
+                else
+                {
+                    ++null_count;
+                }
+            }
+            p->m_buffers.push_back(null_count != 0 ? p->own(std::move(bits)) : nullptr);
+            return null_count;
+        }
+
+        template <class C>
+        struct arrow_table_info
+        {
+            using coordinate_type = C;
+            using dimension_type = xdimension<typename C::key_type, typename C::size_type>;
+
+            coordinate_type m_coordinate;
+            dimension_type m_dimension_mapping;
+            std::vector<std::size_t> m_shape;
+            std::vector<std::size_t> m_strides;
+            std::size_t m_size;
+        };
+
+        template <class T, class C>
+        inline arrow_table_info<C> import_arrow_table(const ArrowSchema& schema, const ArrowArray& array)
+        {
+            using info_type = arrow_table_info<C>;
+            using key_type = typename C::key_type;
+            using map_type = typename C::map_type;
+            using axis_type = typename C::axis_type;
+            using io_type = xtl::mpl::cast_t<typename C::label_list, arrow_axis_io>;
+
+            if (std::strcmp(schema.format, "+s") != 0 || schema.n_children < 1 || array.n_children != schema.n_children)
+            {
+                throw std::runtime_error("arrow: expected a struct array holding dimension columns and a value column");
+            }
+            const ArrowSchema& value_schema = *schema.children[schema.n_children - 1];
+            if (std::strcmp(value_schema.format, arrow_format<T>()) != 0)
+            {
+                throw std::runtime_error(std::string("arrow: value type mismatch, got ") + value_schema.format);
+            }
+
+            std::size_t dimension = static_cast<std::size_t>(schema.n_children - 1);
+            map_type coord_map;
+            typename info_type::dimension_type::label_list dim_labels;
+            std::vector<std::size_t> shape(dimension);
+            for (std::size_t d = 0; d < dimension; ++d)
+            {
+                const ArrowSchema& column = *schema.children[d];
+                if (column.dictionary == nullptr || array.children[d]->dictionary == nullptr)
+                {
+                    throw std::runtime_error("arrow: dimension columns must be dictionary encoded");
+                }
+                axis_type axis = io_type::template import_labels<axis_type>(*column.dictionary, *(array.children[d]->dictionary));
+                shape[d] = axis.size();
+                key_type name(column.name);
+                coord_map.emplace(name, std::move(axis));
+                dim_labels.push_back(name);
+            }
+
+            std::vector<std::size_t> strides(dimension);
+            std::size_t size = 1;
+            for (std::size_t d = dimension; d != 0; --d)
+            {
+                strides[d - 1] = size;
+                size *= shape[d - 1];
+            }
+
+            return info_type{ C(std::move(coord_map)), typename info_type::dimension_type(std::move(dim_labels)),
+                              std::move(shape), std::move(strides), size };
+        }
+    }
+
+    /**
+     * Exports a variable as an Arrow struct array. Each dimension becomes a
+     * dictionary encoded column whose dictionary holds the labels of the
+     * corresponding axis, and the values are exported as the last column,
+     * whose validity bitmap is built from the missing mask.
+     *
+     * Row-major values and arithmetic labels are not copied: the exported
+     * buffers alias those of the variable, which must therefore outlive the
+     * exported array. The caller owns the filled structures and must call
+     * their release callback.
+     * @param variable the variable to export.
+     * @param schema the schema to fill.
+     * @param array the array to fill.
+     * @param value_name the name of the value column.
+     */
+    template <class CCT, class ECT>
+    inline void to_arrow(const xvariable_container<CCT, ECT>& variable, ArrowSchema* schema, ArrowArray* array,
+                         const std::string& value_name)
+    {
+        using value_type = typename std::decay_t<decltype(variable.data().value())>::value_type;
+        using io_type = xtl::mpl::cast_t<typename std::decay_t<CCT>::label_list, detail::arrow_axis_io>;
+
+        const char* value_format = detail::arrow_format<value_type>();
+        const auto& dims = variable.dimension_mapping();
+        const auto& values = variable.data().value();
+        std::size_t dimension = dims.size();
+        std::size_t length = values.size();
+
+        // The exported structures are owned by smart pointers until their
+        // parent takes them over, so that nothing leaks if an export throws.
+        detail::arrow_schema_private_ptr schema_private(new detail::arrow_schema_private("+s", ""));
+        detail::arrow_array_private_ptr array_private(new detail::arrow_array_private());
+        array_private->m_buffers.push_back(nullptr);
+
+        std::size_t stride = length;
+        for (std::size_t d = 0; d < dimension; ++d)
+        {
+            const auto& name = dims.labels()[d];
+            const auto& axis = variable.coordinates()[name];
+            std::size_t size = axis.size();
+            if (size > static_cast<std::size_t>(std::numeric_limits<std::int32_t>::max()))
+            {
+                throw std::runtime_error("arrow: axis too large for 32-bit dictionary indices");
+            }
+            stride = size != 0 ? stride / size : 0;
+
+            std::vector<std::int32_t> indices(length);
+            for (std::size_t i = 0; i < length; ++i)
+            {
+                indices[i] = static_cast<std::int32_t>((i / stride) % size);
+            }
+
+            auto dictionary_schema = detail::make_arrow_schema_ptr();
+            auto dictionary_array = detail::make_arrow_array_ptr();
+            io_type::export_labels(axis, axis.labels().storage().index(), dictionary_schema.get(), dictionary_array.get());
+
+            detail::arrow_schema_private_ptr child_schema_private(new detail::arrow_schema_private("i", detail::arrow_name(name)));
+            child_schema_private->m_dictionary = dictionary_schema.release();
+            auto child_schema = detail::make_arrow_schema_ptr();
+            detail::make_arrow_schema(child_schema.get(), std::move(child_schema_private), 0);
+
+            detail::arrow_array_private_ptr child_array_private(new detail::arrow_array_private());
+            child_array_private->m_dictionary = dictionary_array.release();
+            child_array_private->m_buffers.push_back(nullptr);
+            child_array_private->m_buffers.push_back(child_array_private->own(std::move(indices)));
+            auto child_array = detail::make_arrow_array_ptr();
+            detail::make_arrow_array(child_array.get(), std::move(child_array_private), length, 0);
+
+            detail::arrow_adopt(schema_private->m_children, child_schema);
+            detail::arrow_adopt(array_private->m_children, child_array);
+        }
+
+        auto value_schema = detail::make_arrow_schema_ptr();
+        detail::make_arrow_schema(value_schema.get(),
+                                  detail::arrow_schema_private_ptr(new detail::arrow_schema_private(value_format, value_name)),
+                                  ARROW_FLAG_NULLABLE);
+        detail::arrow_array_private_ptr value_private(new detail::arrow_array_private());
+        std::size_t null_count = detail::export_validity(variable.data().has_value(), value_private.get());
+        value_private->m_buffers.push_back(detail::export_values(values, value_private.get()));
+        auto value_array = detail::make_arrow_array_ptr();
+        detail::make_arrow_array(value_array.get(), std::move(value_private), length, null_count);
+        detail::arrow_adopt(schema_private->m_children, value_schema);
+        detail::arrow_adopt(array_private->m_children, value_array);
+
+        detail::make_arrow_schema(schema, std::move(schema_private), 0);
+        detail::make_arrow_array(array, std::move(array_private), length, 0);
+    }
+
+    /**
+     * Imports an Arrow struct array as a variable. The last column holds the
+     * values, the other ones are dictionary encoded dimension columns whose
+     * dictionaries hold the axis labels. Rows can come in any order, and
+     * combinations of labels absent from the table are missing in the result.
+     * @param schema the schema of the table.
+     * @param array the table.
+     * @tparam T the value type of the variable.
+     * @tparam C the coordinate type of the variable.
+     * @sa adapt_arrow
+     */
+    template <class T, class C>
+    inline xvariable<T, C> from_arrow(const ArrowSchema& schema, const ArrowArray& array)
+    {
+        using variable_type = xvariable<T, C>;
+        using data_type = typename variable_type::data_type;
+
+        auto info = detail::import_arrow_table<T, C>(schema, array);
+        std::size_t dimension = info.m_shape.size();
+        typename data_type::shape_type shape(info.m_shape.cbegin(), info.m_shape.cend());
+        data_type data(shape);
+        std::fill(data.begin(), data.end(), xtl::missing<T>());
+
+        std::vector<std::vector<std::size_t>> indices(dimension);
+        for (std::size_t d = 0; d < dimension; ++d)
+        {
+            indices[d] = detail::arrow_indices(*schema.children[d], *array.children[d], array.offset, array.length);
+        }
+
+        const ArrowArray& value_array = *array.children[dimension];
+        std::vector<std::size_t> index(dimension);
+        for (std::int64_t i = 0; i < array.length; ++i)
+        {
+            for (std::size_t d = 0; d < dimension; ++d)
+            {
+                index[d] = indices[d][static_cast<std::size_t>(i)];
+            }
+            std::int64_t row = array.offset + i;
+            bool valid = value_array.buffers[0] == nullptr || detail::arrow_bit(value_array.buffers[0], value_array.offset + row);
+            if (valid)
+            {
+                data.element(index.cbegin(), index.cend()) = detail::arrow_value<T>(value_array, row);
+            }
+        }
+
+        return variable_type(std::move(data), std::move(info.m_coordinate), std::move(info.m_dimension_mapping));
+    }
+
+    /**
+     * Imports an Arrow struct array as a variable without copying its values.
+     * The table must hold one row per combination of labels, in row-major
+     * order, which is the layout produced by to_arrow. The returned variable
+     * aliases the value buffer of the array, which must outlive it; only the
+     * validity bitmap is unpacked.
+     * @param schema the schema of the table.
+     * @param array the table.
+     * @tparam T the value type of the variable.
+     * @tparam C the coordinate type of the variable.
+     * @sa from_arrow
+     */
+    template <class T, class C>
+    inline xarrow_variable_adaptor<T, C> adapt_arrow(const ArrowSchema& schema, const ArrowArray& array)
+    {
+        static_assert(!std::is_same<T, bool>::value, "bit-packed boolean values cannot be adapted");
+        using variable_type = xarrow_variable_adaptor<T, C>;
+        using data_type = typename variable_type::data_type;
+        using value_container = detail::arrow_value_adaptor<T>;
+        using flag_container = xt::xarray<bool>;
+
+        auto info = detail::import_arrow_table<T, C>(schema, array);
+        std::size_t dimension = info.m_shape.size();
+        if (static_cast<std::size_t>(array.length) != info.m_size)
+        {
+            throw std::runtime_error("arrow: table does not hold one row per combination of labels");
+        }
+        for (std::size_t d = 0; d < dimension; ++d)
+        {
+            auto indices = detail::arrow_indices(*schema.children[d], *array.children[d], array.offset, array.length);
+            for (std::size_t i = 0; i < indices.size(); ++i)
+            {
+                if (indices[i] != (i / info.m_strides[d]) % info.m_shape[d])
+                {
+                    throw std::runtime_error("arrow: table rows are not in row-major order, use from_arrow");
+                }
+            }
+        }
+
+        const ArrowArray& value_array = *array.children[dimension];
+        std::int64_t value_offset = value_array.offset + array.offset;
+        T* value_data = const_cast<T*>(static_cast<const T*>(value_array.buffers[1])) + value_offset;
+        xt::dynamic_shape<std::size_t> shape(info.m_shape.cbegin(), info.m_shape.cend());
+        value_container values(xt::xbuffer_adaptor<T*, xt::no_ownership>(value_data, info.m_size), shape);
+
+        typename flag_container::shape_type flag_shape(info.m_shape.cbegin(), info.m_shape.cend());
+        flag_container flags(flag_shape, true);
+        if (value_array.buffers[0] != nullptr)
+        {
+            for (std::size_t i = 0; i < info.m_size; ++i)
+            {
+                flags.data()[i] = detail::arrow_bit(value_array.buffers[0], value_offset + static_cast<std::int64_t>(i));
+            }
+        }
+
+        return variable_type(data_type(std::move(values), std::move(flags)),
+                             std::move(info.m_coordinate), std::move(info.m_dimension_mapping));
+    }
+}
+
+#endif
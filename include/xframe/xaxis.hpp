@@ -12,16 +12,21 @@
 #include <initializer_list>
 #include <iterator>
 #include <algorithm>
+#include <functional>
 #include <map>
+#include <memory>
+#include <stdexcept>
 #include <type_traits>
 #include <unordered_map>
 #include <vector>
 
 #include "xtl/xiterator_base.hpp"
+#include "xtl/xvariant.hpp"
 
 #include "xtensor/xbuilder.hpp"
 
 #include "xaxis_base.hpp"
+#include "xframe_counters.hpp"
 #include "xframe_utils.hpp"
 
 namespace xf
@@ -54,6 +59,28 @@ namespace xf
         using type = std::unordered_map<K, T>;
     };
 
+    /**
+     * Tag selecting the map type of the tag MT (map_tag or hash_map_tag)
+     * with the allocator A, rebound to the value type of the map. The
+     * allocator must be default constructible.
+     */
+    template <class MT, class A>
+    struct allocator_tag {};
+
+    template <class K, class T, class A>
+    struct map_container<K, T, allocator_tag<map_tag, A>>
+    {
+        using allocator_type = typename std::allocator_traits<A>::template rebind_alloc<std::pair<const K, T>>;
+        using type = std::map<K, T, std::less<K>, allocator_type>;
+    };
+
+    template <class K, class T, class A>
+    struct map_container<K, T, allocator_tag<hash_map_tag, A>>
+    {
+        using allocator_type = typename std::allocator_traits<A>::template rebind_alloc<std::pair<const K, T>>;
+        using type = std::unordered_map<K, T, std::hash<K>, std::equal_to<K>, allocator_type>;
+    };
+
     template <class K, class T, class MT>
     using map_container_t = typename map_container<K, T, MT>::type;
 
@@ -73,8 +100,8 @@ namespace xf
      * @tparam T the integer type used to represent positions. Default value is
      *           \c std::size_t.
      * @tparam MT the tag used for choosing the map type which holds the label-
-     *            position pairs. Possible values are \c map_tag and \c hash_map_tag.
-     *            Default value is \c hash_map_tag.
+     *            position pairs. Possible values are \c map_tag and \c hash_map_tag,
+     *            optionally wrapped in \c allocator_tag. Default value is \c hash_map_tag.
      */
     template <class L, class T = std::size_t, class MT = hash_map_tag>
     class xaxis : public xaxis_base<xaxis<L, T, MT>>
@@ -110,11 +137,23 @@ namespace xf
         template <class InputIt>
         xaxis(InputIt first, InputIt last);
 
+        xaxis(const xaxis&) = default;
+        xaxis& operator=(const xaxis&) = default;
+
         bool is_sorted() const noexcept;
 
         bool contains(const key_type& key) const;
         mapped_type operator[](const key_type& key) const;
 
+        template <class It, class O>
+        O positions(It first, It last, O out) const;
+
+        template <class It>
+        bool contains_all(It first, It last) const;
+
+        template <class K>
+        std::pair<mapped_type, mapped_type> range_bounds(const K& first, const K& last) const;
+
         template <class F>
         self_type filter(const F& f) const noexcept;
 
@@ -152,6 +191,9 @@ namespace xf
 
         typename map_type::const_iterator find_index(const key_type& key) const;
 
+        template <class It, class F>
+        bool lookup(It first, It last, F&& f) const;
+
         template <class... Args>
         bool merge_impl(const Args&... axes);
 
@@ -167,7 +209,10 @@ namespace xf
         template <class Arg>
         bool all_sorted(const Arg& a) const noexcept;
 
-        map_type m_index;
+        template <class... Args>
+        bool all_same_labels(const Args&... axes) const;
+
+        std::shared_ptr<map_type> m_index;
         bool m_is_sorted;
 
         friend class xaxis_iterator<L, T, MT>;
@@ -261,6 +306,93 @@ namespace xf
     template <class L, class T, class MT>
     bool operator<(const xaxis_iterator<L, T, MT>& lhs, const xaxis_iterator<L, T, MT>& rhs) noexcept;
 
+    namespace detail
+    {
+        // Queries of another type than the labels are only converted when
+        // neither type is arithmetic: an integral axis queried with 2.5 must
+        // not find the label 2.
+        template <class K, class V>
+        struct is_label_convertible
+            : std::integral_constant<bool, std::is_constructible<K, const V&>::value &&
+                                           !std::is_arithmetic<K>::value && !std::is_arithmetic<V>::value>
+        {
+        };
+
+        // Converts a query to the label type of an axis; queries may be
+        // labels, values convertible to labels or variants of labels.
+        template <class K, class V, bool = is_label_convertible<K, V>::value>
+        struct label_converter
+        {
+            static K apply(const V& v)
+            {
+                return K(v);
+            }
+        };
+
+        // Queries of another label type are rejected at runtime, so that
+        // every alternative of an axis variant can be visited.
+        template <class K, class V>
+        struct label_converter<K, V, false>
+        {
+            static K apply(const V&)
+            {
+                throw std::invalid_argument("label type does not match the label type of the axis");
+            }
+        };
+
+        template <class K, class V>
+        struct label_caster : label_converter<K, V>
+        {
+        };
+
+        template <class K>
+        struct label_caster<K, K>
+        {
+            static const K& apply(const K& v) noexcept
+            {
+                return v;
+            }
+        };
+
+        template <class K, class... V>
+        struct label_caster<K, xtl::variant<V...>>
+        {
+            static const K& apply(const xtl::variant<V...>& v)
+            {
+                return xtl::get<K>(v);
+            }
+        };
+
+        template <class K, class V>
+        inline decltype(auto) label_cast(const V& v)
+        {
+            return label_caster<K, V>::apply(v);
+        }
+
+        // Returns the first position not lower than start whose label is not
+        // less than key, doubling the step before the final binary search.
+        template <class C, class K>
+        inline std::size_t gallop_lower_bound(const C& labels, std::size_t start, const K& key)
+        {
+            std::size_t size = labels.size();
+            if (start == size || !(labels[start] < key))
+            {
+                return start;
+            }
+            std::size_t low = start;
+            std::size_t step = 1;
+            std::size_t high = start + step;
+            while (high < size && labels[high] < key)
+            {
+                low = high;
+                step <<= 1;
+                high = start + step;
+            }
+            high = std::min(high, size);
+            return static_cast<std::size_t>(std::lower_bound(labels.begin() + low + 1, labels.begin() + high, key) - labels.begin());
+        }
+    }
+
     /************************
      * xaxis implementation *
      ************************/
@@ -274,7 +406,7 @@ namespace xf
      */
     template <class L, class T, class MT>
     inline xaxis<L, T, MT>::xaxis()
-        : base_type(), m_index(), m_is_sorted(true)
+        : base_type(), m_index(std::make_shared<map_type>()), m_is_sorted(true)
     {
     }
 
@@ -335,7 +467,7 @@ namespace xf
 
     template <class L, class T, class MT>
     inline xaxis<L, T, MT>::xaxis(label_list&& labels, bool is_sorted)
-        : base_type(labels), m_index(), m_is_sorted(is_sorted)
+        : base_type(std::move(labels)), m_index(), m_is_sorted(is_sorted)
     {
         populate_index();
     }
@@ -401,7 +533,7 @@ namespace xf
     template <class L, class T, class MT>
     inline bool xaxis<L, T, MT>::contains(const key_type& key) const
     {
-        return m_index.count(key) != typename map_type::size_type(0);
+        return m_index->count(key) != typename map_type::size_type(0);
     }
 
     /**
@@ -412,7 +544,76 @@ namespace xf
     template <class L, class T, class MT>
     inline auto xaxis<L, T, MT>::operator[](const key_type& key) const -> mapped_type
     {
-        return m_index.at(key);
+        return m_index->at(key);
+    }
+
+    /**
+     * Writes the positions of the labels in [first, last) to \c out. If a
+     * label is not found, an exception is thrown. When the axis is sorted,
+     * the positions of the leading sorted labels are found with a galloping
+     * merge instead of one hash lookup per label.
+     * @param first iterator to the first label to search for.
+     * @param last iterator past the last label to search for.
+     * @param out the output iterator.
+     * @return the output iterator past the last written position.
+     */
+    template <class L, class T, class MT>
+    template <class It, class O>
+    inline O xaxis<L, T, MT>::positions(It first, It last, O out) const
+    {
+        bool found = lookup(first, last, [&out](mapped_type pos)
+        {
+            *out = pos;
+            ++out;
+        });
+        if (!found)
+        {
+            throw std::out_of_range("xaxis: label not found");
+        }
+        return out;
+    }
+
+    /**
+     * Returns true if the axis contains all the labels in [first, last).
+     * @param first iterator to the first label to search for.
+     * @param last iterator past the last label to search for.
+     */
+    template <class L, class T, class MT>
+    template <class It>
+    inline bool xaxis<L, T, MT>::contains_all(It first, It last) const
+    {
+        return lookup(first, last, [](mapped_type) {});
+    }
+
+    /**
+     * Returns the positions [begin, end) of the labels in the closed range
+     * [first, last]. On a sorted axis, the bounds are found by binary search
+     * and the endpoints do not need to be labels of the axis. On an unsorted
+     * axis, both endpoints must be labels of the axis, otherwise an exception
+     * is thrown.
+     * @param first the first label of the range.
+     * @param last the last label of the range.
+     */
+    template <class L, class T, class MT>
+    template <class K>
+    inline auto xaxis<L, T, MT>::range_bounds(const K& first, const K& last) const -> std::pair<mapped_type, mapped_type>
+    {
+        const auto& first_key = detail::label_cast<key_type>(first);
+        const auto& last_key = detail::label_cast<key_type>(last);
+        if (m_is_sorted)
+        {
+            const label_list& labels = this->labels();
+            auto begin = std::lower_bound(labels.cbegin(), labels.cend(), first_key);
+            auto end = std::upper_bound(begin, labels.cend(), last_key);
+            return std::make_pair(mapped_type(begin - labels.cbegin()), mapped_type(end - labels.cbegin()));
+        }
+        auto first_iter = m_index->find(first_key);
+        auto last_iter = m_index->find(last_key);
+        if (first_iter == m_index->end() || last_iter == m_index->end())
+        {
+            throw std::out_of_range("xaxis: range endpoints not found, ranges of missing labels require a sorted axis");
+        }
+        return std::make_pair(first_iter->second, mapped_type(last_iter->second + 1));
     }
     //@}
 
@@ -458,8 +659,8 @@ namespace xf
     template <class L, class T, class MT>
     inline auto xaxis<L, T, MT>::find(const key_type& key) const -> const_iterator
     {
-        auto map_iter = m_index.find(key);
-        return map_iter != m_index.end() ? cbegin() + map_iter->second : cend();
+        auto map_iter = m_index->find(key);
+        return map_iter != m_index->end() ? cbegin() + map_iter->second : cend();
     }
 
     /**
@@ -497,6 +698,11 @@ namespace xf
     template <class... Args>
     inline bool xaxis<L, T, MT>::merge(const Args&... axes)
     {
+        XFRAME_COUNT(m_axis_merges)
+        if (all_same_labels(axes...))
+        {
+            return true;
+        }
         return this->empty() ? merge_empty(axes...) : merge_impl(axes...);
     }
 
@@ -510,6 +716,11 @@ namespace xf
     template <class... Args>
     inline bool xaxis<L, T, MT>::intersect(const Args&... axes)
     {
+        XFRAME_COUNT(m_axis_intersections)
+        if (all_same_labels(axes...))
+        {
+            return true;
+        }
         bool res = true;
         if (all_sorted(*this, axes...))
         {
@@ -527,10 +738,14 @@ namespace xf
     template <class L, class T, class MT>
     inline void xaxis<L, T, MT>::populate_index()
     {
+        XFRAME_COUNT(m_index_builds)
+        this->update_fingerprint();
+        auto index = std::make_shared<map_type>();
         for(size_type i = 0; i < this->labels().size(); ++i)
         {
-            m_index[this->labels()[i]] = T(i);
+            (*index)[this->labels()[i]] = T(i);
         }
+        m_index = std::move(index);
     }
 
     template <class L, class T, class MT>
@@ -543,7 +758,46 @@ namespace xf
     template <class L, class T, class MT>
     inline auto xaxis<L, T, MT>::find_index(const key_type& key) const -> typename map_type::const_iterator
     {
-        return m_index.find(key);
+        return m_index->find(key);
+    }
+
+    template <class L, class T, class MT>
+    template <class It, class F>
+    inline bool xaxis<L, T, MT>::lookup(It first, It last, F&& f) const
+    {
+        // The queries are merged with the labels of a sorted axis as long as
+        // they are sorted: the first query lower than the label found for its
+        // predecessor ends the merge, and the remaining ones are looked up
+        // in the index.
+        if (m_is_sorted)
+        {
+            const label_list& labels = this->labels();
+            std::size_t pos = 0;
+            for (; first != last; ++first)
+            {
+                const auto& key = detail::label_cast<key_type>(*first);
+                if (pos != labels.size() && key < labels[pos])
+                {
+                    break;
+                }
+                pos = detail::gallop_lower_bound(labels, pos, key);
+                if (pos == labels.size() || key < labels[pos])
+                {
+                    return false;
+                }
+                f(mapped_type(pos));
+            }
+        }
+        for (; first != last; ++first)
+        {
+            auto iter = m_index->find(detail::label_cast<key_type>(*first));
+            if (iter == m_index->end())
+            {
+                return false;
+            }
+            f(iter->second);
+        }
+        return true;
     }
 
     template <class L, class T, class MT>
@@ -559,7 +813,7 @@ namespace xf
         else
         {
             m_is_sorted = false;
-            if (m_index.empty())
+            if (m_index->empty())
             {
                 populate_index();
             }
@@ -602,6 +856,16 @@ namespace xf
         return a.is_sorted();
     }
 
+    template <class L, class T, class MT>
+    template <class... Args>
+    inline bool xaxis<L, T, MT>::all_same_labels(const Args&... axes) const
+    {
+        bool res = true;
+        bool dummy[] = { true, (res = res && detail::same_axis_labels(*this, axes))... };
+        (void)dummy;
+        return res;
+    }
+
     template <class L, class T, class MT>
     template <class Arg, class... Args>
     inline bool xaxis<L, T, MT>::merge_unsorted(bool broadcasting, const Arg& a, const Args&... axes_labels)
@@ -11,7 +11,10 @@
 #define XFRAME_XAXIS_BASE_HPP
 
 #include <algorithm>
+#include <cstddef>
+#include <functional>
 #include <iterator>
+#include <memory>
 #include <vector>
 
 namespace xf
@@ -31,6 +34,8 @@ namespace xf
      * The xaxis_base class defines the common interface for axes, which define the
      * mapping of labels to positions in a given dimension. The axis_base class
      * embeds the list of labels only, the mapping is hold by the inheriting classes.
+     * The list of labels is shared by the copies of an axis and copied on write
+     * only, so that copying an axis does not copy its labels.
      *
      * @tparam D The derived type, i.e. the inheriting class for which xaxis_base
      *           provides the interface.
@@ -65,6 +70,8 @@ namespace xf
         bool empty() const noexcept;
         size_type size() const noexcept;
 
+        std::size_t fingerprint() const noexcept;
+
         const_iterator begin() const noexcept;
         const_iterator end() const noexcept;
 
@@ -86,13 +93,13 @@ namespace xf
 
         ~xaxis_base() = default;
 
+        // Moving an axis shares its labels as copying does, so that
+        // moved-from axes remain valid.
         xaxis_base(const xaxis_base&) = default;
         xaxis_base& operator=(const xaxis_base&) = default;
 
-        xaxis_base(xaxis_base&&) = default;
-        xaxis_base& operator=(xaxis_base&&) = default;
-
-        label_list& mutable_labels() noexcept;
+        label_list& mutable_labels();
+        void update_fingerprint() noexcept;
 
         template <class F>
         label_list filter_labels(const F& f) const noexcept;
@@ -100,7 +107,8 @@ namespace xf
         template <class F>
         label_list filter_labels(const F& f, size_type size) const noexcept;
 
-        label_list m_labels;
+        std::shared_ptr<label_list> m_labels;
+        std::size_t m_fingerprint;
     };
 
     template <class D1, class D2>
@@ -116,6 +124,15 @@ namespace xf
      * is_axis metafunction *
      ************************/
 
+    namespace detail
+    {
+        template <class L>
+        std::size_t labels_fingerprint(const L& labels) noexcept;
+
+        template <class A1, class A2>
+        bool same_axis_labels(const A1& lhs, const A2& rhs);
+    }
+
     template <class T>
     struct is_axis : std::is_base_of<xaxis_base<T>, T>
     {
@@ -127,32 +144,32 @@ namespace xf
 
     template <class D>
     inline xaxis_base<D>::xaxis_base()
-        : m_labels()
+        : m_labels(std::make_shared<label_list>()), m_fingerprint(0)
     {
     }
 
     template <class D>
     inline xaxis_base<D>::xaxis_base(const label_list& labels)
-        : m_labels(labels)
+        : m_labels(std::make_shared<label_list>(labels)), m_fingerprint(0)
     {
     }
 
     template <class D>
     inline xaxis_base<D>::xaxis_base(label_list&& labels)
-        : m_labels(std::move(labels))
+        : m_labels(std::make_shared<label_list>(std::move(labels))), m_fingerprint(0)
     {
     }
 
     template <class D>
     inline xaxis_base<D>::xaxis_base(std::initializer_list<key_type> init)
-        : m_labels(init)
+        : m_labels(std::make_shared<label_list>(init)), m_fingerprint(0)
     {
     }
 
     template <class D>
     template <class InputIt>
     inline xaxis_base<D>::xaxis_base(InputIt first, InputIt last)
-        : m_labels(first, last)
+        : m_labels(std::make_shared<label_list>(first, last)), m_fingerprint(0)
     {
     }
 
@@ -201,7 +218,7 @@ namespace xf
     template <class D>
     inline auto xaxis_base<D>::labels() const noexcept -> const label_list&
     {
-        return m_labels;
+        return *m_labels;
     }
 
     /**
@@ -211,7 +228,7 @@ namespace xf
     template <class D>
     inline auto xaxis_base<D>::label(size_type i) const -> key_type
     {
-        return m_labels[i];
+        return (*m_labels)[i];
     }
 
     /**
@@ -220,7 +237,7 @@ namespace xf
     template <class D>
     inline bool xaxis_base<D>::empty() const noexcept
     {
-        return m_labels.empty();
+        return m_labels->empty();
     }
 
     /**
@@ -229,7 +246,18 @@ namespace xf
     template <class D>
     inline auto xaxis_base<D>::size() const noexcept -> size_type
     {
-        return m_labels.size();
+        return m_labels->size();
+    }
+
+    /**
+     * Returns a hash of the labels of the axis. Axes with the same labels
+     * have the same fingerprint; axes with different fingerprints have
+     * different labels.
+     */
+    template <class D>
+    inline std::size_t xaxis_base<D>::fingerprint() const noexcept
+    {
+        return m_fingerprint;
     }
     //@}
 
@@ -299,9 +327,21 @@ namespace xf
     //@}
 
     template <class D>
-    inline auto xaxis_base<D>::mutable_labels() noexcept -> label_list&
+    inline auto xaxis_base<D>::mutable_labels() -> label_list&
     {
-        return m_labels;
+        if (m_labels.use_count() != 1)
+        {
+            m_labels = std::make_shared<label_list>(*m_labels);
+        }
+        return *m_labels;
+    }
+
+    // Must be called by the inheriting classes each time they modify
+    // the labels.
+    template <class D>
+    inline void xaxis_base<D>::update_fingerprint() noexcept
+    {
+        m_fingerprint = detail::labels_fingerprint(*m_labels);
     }
 
     template <class D>
@@ -309,7 +349,7 @@ namespace xf
     inline auto xaxis_base<D>::filter_labels(const F& f) const noexcept -> label_list
     {
         label_list l;
-        std::copy_if(m_labels.cbegin(), m_labels.cend(), std::back_inserter(l), f);
+        std::copy_if(m_labels->cbegin(), m_labels->cend(), std::back_inserter(l), f);
         return l;
     }
 
@@ -318,10 +358,51 @@ namespace xf
     inline auto xaxis_base<D>::filter_labels(const F& f, size_type size) const noexcept -> label_list
     {
         label_list l(size);
-        std::copy_if(m_labels.cbegin(), m_labels.cend(), l.begin(), f);
+        std::copy_if(m_labels->cbegin(), m_labels->cend(), l.begin(), f);
         return l;
     }
 
+    namespace detail
+    {
+        template <class L>
+        inline bool same_label_storage(const L& lhs, const L& rhs) noexcept
+        {
+            return &lhs == &rhs;
+        }
+
+        template <class L1, class L2>
+        inline bool same_label_storage(const L1& /*lhs*/, const L2& /*rhs*/) noexcept
+        {
+            return false;
+        }
+
+        template <class L>
+        inline std::size_t labels_fingerprint(const L& labels) noexcept
+        {
+            std::hash<typename L::value_type> hasher;
+            std::size_t seed = 0;
+            for (const auto& label : labels)
+            {
+                seed ^= hasher(label) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+            }
+            return seed;
+        }
+
+        /**
+         * Returns true if \c lhs and \c rhs hold the same labels. Axes sharing
+         * their labels are detected without reading them, and axes with
+         * different fingerprints without comparing them.
+         */
+        template <class A1, class A2>
+        inline bool same_axis_labels(const A1& lhs, const A2& rhs)
+        {
+            const auto& llabels = lhs.labels();
+            const auto& rlabels = rhs.labels();
+            return same_label_storage(llabels, rlabels) ||
+                (lhs.fingerprint() == rhs.fingerprint() && llabels == rlabels);
+        }
+    }
+
     /**
      * Returns true is \c lhs and \c rhs are equivalent axes, i.e. they contain the same
      * label - position pairs.
@@ -331,7 +412,7 @@ namespace xf
     template <class D1, class D2>
     inline bool operator==(const xaxis_base<D1>& lhs, const xaxis_base<D2>& rhs) noexcept
     {
-        return lhs.labels() == rhs.labels();
+        return detail::same_axis_labels(lhs, rhs);
     }
 
     /**
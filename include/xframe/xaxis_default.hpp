@@ -10,6 +10,11 @@
 #ifndef XFRAME_XAXIS_DEFAULT_HPP
 #define XFRAME_XAXIS_DEFAULT_HPP
 
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
 #include <utility>
 #include <vector>
 #include <ostream>
@@ -75,6 +80,15 @@ namespace xf
         bool contains(const key_type& key) const;
         mapped_type operator[](const key_type& key) const;
 
+        template <class It, class O>
+        O positions(It first, It last, O out) const;
+
+        template <class It>
+        bool contains_all(It first, It last) const;
+
+        template <class K>
+        std::pair<mapped_type, mapped_type> range_bounds(const K& first, const K& last) const;
+
         template <class F>
         axis_type filter(const F& f) const noexcept;
 
@@ -222,6 +236,81 @@ namespace xf
         return mapped_type(this->labels().at(key));
     }
 
+    /**
+     * Writes the positions of the labels in [first, last) to \c out. If a
+     * label is not found, an exception is thrown.
+     * @param first iterator to the first label to search for.
+     * @param last iterator past the last label to search for.
+     * @param out the output iterator.
+     * @return the output iterator past the last written position.
+     */
+    template <class L, class T>
+    template <class It, class O>
+    inline O xaxis_default<L, T>::positions(It first, It last, O out) const
+    {
+        for (; first != last; ++first, ++out)
+        {
+            const auto& key = detail::label_cast<key_type>(*first);
+            if (!contains(key))
+            {
+                throw std::out_of_range("xaxis_default: label not found");
+            }
+            *out = mapped_type(key);
+        }
+        return out;
+    }
+
+    /**
+     * Returns true if the axis contains all the labels in [first, last).
+     * @param first iterator to the first label to search for.
+     * @param last iterator past the last label to search for.
+     */
+    template <class L, class T>
+    template <class It>
+    inline bool xaxis_default<L, T>::contains_all(It first, It last) const
+    {
+        return std::all_of(first, last, [this](const auto& arg) { return contains(detail::label_cast<key_type>(arg)); });
+    }
+
+    namespace detail
+    {
+        // Position of a label of a default axis, clamped in std::ptrdiff_t so
+        // that the bounds of a range can be computed without overflowing the
+        // label type.
+        template <class K>
+        inline std::ptrdiff_t default_axis_position(const K& key, std::true_type) noexcept
+        {
+            return static_cast<std::ptrdiff_t>(key);
+        }
+
+        template <class K>
+        inline std::ptrdiff_t default_axis_position(const K& key, std::false_type) noexcept
+        {
+            constexpr std::size_t max_position = static_cast<std::size_t>(std::numeric_limits<std::ptrdiff_t>::max());
+            return static_cast<std::size_t>(key) > max_position ? std::numeric_limits<std::ptrdiff_t>::max()
+                                                                 : static_cast<std::ptrdiff_t>(key);
+        }
+    }
+
+    /**
+     * Returns the positions [begin, end) of the labels in the closed range
+     * [first, last]. The endpoints do not need to be labels of the axis.
+     * @param first the first label of the range.
+     * @param last the last label of the range.
+     */
+    template <class L, class T>
+    template <class K>
+    inline auto xaxis_default<L, T>::range_bounds(const K& first, const K& last) const -> std::pair<mapped_type, mapped_type>
+    {
+        using is_signed_key = std::is_signed<key_type>;
+        const std::ptrdiff_t first_pos = detail::default_axis_position(detail::label_cast<key_type>(first), is_signed_key());
+        const std::ptrdiff_t last_pos = detail::default_axis_position(detail::label_cast<key_type>(last), is_signed_key());
+        const std::ptrdiff_t size = static_cast<std::ptrdiff_t>(this->size());
+        std::ptrdiff_t begin = first_pos < 0 ? 0 : std::min(first_pos, size);
+        std::ptrdiff_t end = last_pos < begin ? begin : (last_pos >= size ? size : last_pos + 1);
+        return std::make_pair(static_cast<mapped_type>(begin), static_cast<mapped_type>(end));
+    }
+
     /**
      * Builds an return a new axis by applying the given filter to the axis.
      * @param f the filter used to select the labels to keep in the new axis.
@@ -286,6 +375,7 @@ namespace xf
         {
             labels.push_back(key_type(i));
         }
+        this->update_fingerprint();
     }
 
     template <class L, class T>
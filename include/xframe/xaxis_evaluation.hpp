@@ -0,0 +1,278 @@
+/***************************************************************************
+* Copyright (c) 2017, Johan Mabille, Sylvain Corlay and Wolf Vollprecht    *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XFRAME_XAXIS_EVALUATION_HPP
+#define XFRAME_XAXIS_EVALUATION_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <iterator>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "xtensor/xstorage.hpp"
+
+namespace xf
+{
+
+    /********************
+     * xaxis_evaluation *
+     ********************/
+
+    /**
+     * @class xaxis_evaluation
+     * @brief Values of an axis expression over all the labels of its axes.
+     *
+     * The values are stored densely over the dimensions the expression
+     * depends on only; a predicate on a single axis is a vector whatever
+     * the number of dimensions of the variable it is applied to.
+     * Dimensions are identified by their position in a dimension mapping
+     * and are stored in increasing order.
+     *
+     * @tparam T the value type.
+     */
+    template <class T>
+    class xaxis_evaluation
+    {
+    public:
+
+        using value_type = T;
+        using size_type = std::size_t;
+        using storage_type = xt::uvector<T>;
+        using index_list = std::vector<size_type>;
+
+        explicit xaxis_evaluation(const value_type& value);
+        xaxis_evaluation(index_list dimensions, index_list shape);
+
+        const index_list& dimensions() const noexcept;
+        const index_list& shape() const noexcept;
+        const index_list& strides() const noexcept;
+        size_type size() const noexcept;
+
+        storage_type& values() noexcept;
+        const storage_type& values() const noexcept;
+
+        template <class It>
+        const value_type& element(It first, It last) const;
+
+        index_list broadcast_strides(const index_list& dimensions) const;
+
+    private:
+
+        index_list m_dimensions;
+        index_list m_shape;
+        index_list m_strides;
+        storage_type m_values;
+    };
+
+    /***********************************
+     * xaxis_evaluation implementation *
+     ***********************************/
+
+    /**
+     * Builds a 0-D evaluation holding \c value.
+     */
+    template <class T>
+    inline xaxis_evaluation<T>::xaxis_evaluation(const value_type& value)
+        : m_dimensions(), m_shape(), m_strides(), m_values(size_type(1), value)
+    {
+    }
+
+    /**
+     * Builds an uninitialized evaluation over the given dimensions.
+     * @param dimensions the positions of the dimensions, in increasing order.
+     * @param shape the number of labels of each dimension.
+     */
+    template <class T>
+    inline xaxis_evaluation<T>::xaxis_evaluation(index_list dimensions, index_list shape)
+        : m_dimensions(std::move(dimensions)), m_shape(std::move(shape)), m_strides(m_shape.size()), m_values()
+    {
+        size_type size = 1;
+        for (size_type i = m_shape.size(); i != 0; --i)
+        {
+            m_strides[i - 1] = size;
+            size *= m_shape[i - 1];
+        }
+        m_values.resize(size);
+    }
+
+    template <class T>
+    inline auto xaxis_evaluation<T>::dimensions() const noexcept -> const index_list&
+    {
+        return m_dimensions;
+    }
+
+    template <class T>
+    inline auto xaxis_evaluation<T>::shape() const noexcept -> const index_list&
+    {
+        return m_shape;
+    }
+
+    template <class T>
+    inline auto xaxis_evaluation<T>::strides() const noexcept -> const index_list&
+    {
+        return m_strides;
+    }
+
+    template <class T>
+    inline auto xaxis_evaluation<T>::size() const noexcept -> size_type
+    {
+        return m_values.size();
+    }
+
+    template <class T>
+    inline auto xaxis_evaluation<T>::values() noexcept -> storage_type&
+    {
+        return m_values;
+    }
+
+    template <class T>
+    inline auto xaxis_evaluation<T>::values() const noexcept -> const storage_type&
+    {
+        return m_values;
+    }
+
+    /**
+     * Returns the value at the given index. The index holds a position for
+     * each dimension of the dimension mapping; missing trailing positions
+     * are considered to be 0.
+     */
+    template <class T>
+    template <class It>
+    inline auto xaxis_evaluation<T>::element(It first, It last) const -> const value_type&
+    {
+        size_type offset = 0;
+        size_type index_size = static_cast<size_type>(std::distance(first, last));
+        for (size_type i = 0; i < m_dimensions.size() && m_dimensions[i] < index_size; ++i)
+        {
+            offset += static_cast<size_type>(*(first + static_cast<std::ptrdiff_t>(m_dimensions[i]))) * m_strides[i];
+        }
+        return m_values[offset];
+    }
+
+    /**
+     * Returns the strides of the evaluation when broadcast to \c dimensions,
+     * which must contain the dimensions of the evaluation.
+     */
+    template <class T>
+    inline auto xaxis_evaluation<T>::broadcast_strides(const index_list& dimensions) const -> index_list
+    {
+        index_list res(dimensions.size(), size_type(0));
+        size_type j = 0;
+        for (size_type i = 0; i < dimensions.size() && j < m_dimensions.size(); ++i)
+        {
+            if (dimensions[i] == m_dimensions[j])
+            {
+                res[i] = m_strides[j++];
+            }
+        }
+        return res;
+    }
+
+    /***********************
+     * combine_evaluations *
+     ***********************/
+
+    namespace detail
+    {
+        template <class E>
+        inline void merge_evaluation_dimensions(std::vector<std::size_t>& dims, std::vector<std::size_t>& shape, const E& e)
+        {
+            for (std::size_t i = 0; i < e.dimensions().size(); ++i)
+            {
+                auto iter = std::lower_bound(dims.begin(), dims.end(), e.dimensions()[i]);
+                if (iter == dims.end() || *iter != e.dimensions()[i])
+                {
+                    shape.insert(shape.begin() + (iter - dims.begin()), e.shape()[i]);
+                    dims.insert(iter, e.dimensions()[i]);
+                }
+            }
+        }
+
+        template <class... E>
+        inline bool same_evaluation_dimensions(const std::vector<std::size_t>& dims, const E&... e)
+        {
+            std::array<bool, sizeof...(E)> same = {{(e.dimensions().empty() || e.dimensions() == dims)...}};
+            return std::all_of(same.cbegin(), same.cend(), [](bool b) { return b; });
+        }
+
+        template <class R, class F, class... T, std::size_t... I>
+        inline xaxis_evaluation<R> combine_evaluations_impl(std::index_sequence<I...>, const F& f, const xaxis_evaluation<T>&... e)
+        {
+            using index_list = std::vector<std::size_t>;
+            constexpr std::size_t nb_args = sizeof...(T);
+
+            index_list dims;
+            index_list shape;
+            int dummy[] = {(merge_evaluation_dimensions(dims, shape, e), 0)...};
+            (void)dummy;
+            xaxis_evaluation<R> res(dims, shape);
+            auto& values = res.values();
+
+            // Arguments depending on the same dimensions as the result or on
+            // none of them: single flat loop.
+            if (same_evaluation_dimensions(dims, e...))
+            {
+                std::array<std::size_t, nb_args> flat = {{(e.dimensions().empty() ? std::size_t(0) : std::size_t(1))...}};
+                for (std::size_t i = 0; i < values.size(); ++i)
+                {
+                    values[i] = f(e.values()[i * flat[I]]...);
+                }
+                return res;
+            }
+
+            // Broadcasting: outer loop over all dimensions but the last one,
+            // inner strided loop over the last dimension.
+            std::array<index_list, nb_args> strides = {{e.broadcast_strides(dims)...}};
+            const std::size_t rank = dims.size();
+            const std::size_t inner_size = shape.back();
+            std::array<std::size_t, nb_args> inner_strides = {{strides[I].back()...}};
+            index_list index(rank, std::size_t(0));
+            std::size_t out = 0;
+            while (out < values.size())
+            {
+                std::array<std::size_t, nb_args> base = {};
+                for (std::size_t k = 0; k < nb_args; ++k)
+                {
+                    for (std::size_t d = 0; d + 1 < rank; ++d)
+                    {
+                        base[k] += index[d] * strides[k][d];
+                    }
+                }
+                for (std::size_t j = 0; j < inner_size; ++j)
+                {
+                    values[out + j] = f(e.values()[base[I] + j * inner_strides[I]]...);
+                }
+                out += inner_size;
+                for (std::size_t d = rank - 1; d != 0; --d)
+                {
+                    if (++index[d - 1] != shape[d - 1])
+                    {
+                        break;
+                    }
+                    index[d - 1] = 0;
+                }
+            }
+            return res;
+        }
+
+        /**
+         * Applies \c f to evaluations, broadcasting them over the union of
+         * their dimensions.
+         */
+        template <class R, class F, class... T>
+        inline xaxis_evaluation<R> combine_evaluations(const F& f, const xaxis_evaluation<T>&... e)
+        {
+            return combine_evaluations_impl<R>(std::make_index_sequence<sizeof...(T)>(), f, e...);
+        }
+    }
+}
+
+#endif
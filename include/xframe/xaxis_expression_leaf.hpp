@@ -10,6 +10,8 @@
 #ifndef XFRAME_XAXIS_EXPRESSION_LEAF_HPP
 #define XFRAME_XAXIS_EXPRESSION_LEAF_HPP
 
+#include <algorithm>
+
 #include "xtl/xvariant.hpp"
 #include "xtl/xmeta_utils.hpp"
 
@@ -18,6 +20,7 @@
 #include "xframe_config.hpp"
 #include "xframe_utils.hpp"
 #include "xframe_expression.hpp"
+#include "xaxis_evaluation.hpp"
 
 namespace xf
 {
@@ -63,6 +66,9 @@ namespace xf
         template <std::size_t N = std::numeric_limits<size_type>::max()>
         const_reference operator()(const selector_sequence_type<N>& selector) const;
 
+        template <class DM>
+        xaxis_evaluation<value_type> evaluate_axes(const DM& dim_mapping) const;
+
     private:
 
         xaxis_closure_t<CTA> m_named_axis;
@@ -100,6 +106,25 @@ namespace xf
         }
         throw std::runtime_error(std::string("Missing label for axis ") + std::string(m_named_axis.name()));
     }
+
+    /**
+     * Returns the labels of the xnamed_axis, laid out along the dimension
+     * with the same name in the dimension mapping.
+     * @param dim_mapping the dimension mapping.
+     */
+    template <class CTA>
+    template <class DM>
+    auto xaxis_expression_leaf<CTA>::evaluate_axes(const DM& dim_mapping) const -> xaxis_evaluation<value_type>
+    {
+        if (!dim_mapping.contains(m_named_axis.name()))
+        {
+            throw std::runtime_error(std::string("Missing label for axis ") + std::string(m_named_axis.name()));
+        }
+        const auto& labels = get_labels(m_named_axis);
+        xaxis_evaluation<value_type> res({dim_mapping[m_named_axis.name()]}, {labels.size()});
+        std::copy(labels.cbegin(), labels.cend(), res.values().begin());
+        return res;
+    }
 }
 
 #endif
@@ -16,6 +16,7 @@
 #include "xframe_expression.hpp"
 #include "xframe_utils.hpp"
 #include "xaxis_meta.hpp"
+#include "xaxis_evaluation.hpp"
 #include "xaxis_expression_leaf.hpp"
 
 namespace xf
@@ -64,11 +65,17 @@ namespace xf
         template <std::size_t N = dynamic()>
         const_reference operator()(const selector_sequence_type<N>& selector) const;
 
+        template <class DM>
+        xaxis_evaluation<value_type> evaluate_axes(const DM& dim_mapping) const;
+
     private:
 
         template <std::size_t N, std::size_t... I>
         const_reference evaluate(std::index_sequence<I...>, const selector_sequence_type<N>& selector) const;
 
+        template <class DM, std::size_t... I>
+        xaxis_evaluation<value_type> evaluate_axes_impl(std::index_sequence<I...>, const DM& dim_mapping) const;
+
         std::tuple<xaxis_expression_closure_t<CT>...> m_e;
         functor_type m_f;
     };
@@ -125,6 +132,42 @@ namespace xf
 #endif
     }
 
+    /**
+     * Evaluates the xaxis_function over all the labels of its axes at once.
+     * Each leaf is evaluated into a vector along its dimension, then the
+     * function is applied to the whole vectors; arguments depending on
+     * different dimensions are combined as outer products, so the cost
+     * only depends on the axes involved in the expression.
+     * Example:
+     * \code{.cpp}
+     * auto axis1 = named_axis("abs", axis(16));
+     * auto axis2 = named_axis("ord", axis({'a', 'c', 'i'}));
+     * auto dim = dimension({"abs", "ord"});
+     *
+     * auto func1 = axis1 < 5 && not_equal(axis2, 'i');
+     *
+     * // res has shape {16, 3}, res.element(...) == func1({{"abs", 10}, {"ord", 1}})
+     * auto res = func1.evaluate_axes(dim);
+     * \endcode
+     *
+     * @param dim_mapping the dimension mapping, giving the position of each
+     *                    axis in the result.
+     * @return the evaluation of the xaxis_function.
+     */
+    template <class F, class R, class... CT>
+    template <class DM>
+    inline auto xaxis_function<F, R, CT...>::evaluate_axes(const DM& dim_mapping) const -> xaxis_evaluation<value_type>
+    {
+        return evaluate_axes_impl(std::make_index_sequence<sizeof...(CT)>(), dim_mapping);
+    }
+
+    template <class F, class R, class... CT>
+    template <class DM, std::size_t... I>
+    inline auto xaxis_function<F, R, CT...>::evaluate_axes_impl(std::index_sequence<I...>, const DM& dim_mapping) const -> xaxis_evaluation<value_type>
+    {
+        return detail::combine_evaluations<value_type>(m_f, std::get<I>(m_e).evaluate_axes(dim_mapping)...);
+    }
+
     /**********************
      * axis_function_mask *
      **********************/
@@ -139,56 +182,29 @@ namespace xf
             using axis_function_type = std::remove_reference_t<AF>;
 
             using value_type = typename axis_function_type::value_type;
-            using name_type = typename axis_function_type::name_type;
-            using size_type = typename axis_function_type::size_type;
-
-            template <std::size_t N = dynamic()>
-            using selector_sequence_type = detail::xselector_sequence_t<std::pair<name_type, size_type>, N>;
+            using evaluation_type = xaxis_evaluation<value_type>;
 
             axis_function_mask_impl(AF&& axis_function, DM&& dim_mapping)
-                : m_axis_function(std::forward<AF>(axis_function)),
-                  m_dimension_mapping(std::forward<DM>(dim_mapping))
+                : m_values(axis_function.evaluate_axes(dim_mapping))
             {
             }
 
             template <class... Args>
             inline value_type operator()(Args... args) const
             {
-                auto selector = make_selector(std::make_index_sequence<sizeof...(Args)>(), args...);
-#ifdef _MSC_VER
-                return m_axis_function.operator()<sizeof...(Args)>(selector);
-#else
-                return m_axis_function.template operator()<sizeof...(Args)>(selector);
-#endif
+                std::array<std::size_t, sizeof...(Args)> index = {{static_cast<std::size_t>(args)...}};
+                return m_values.element(index.cbegin(), index.cend());
             }
 
             template <class It>
             inline value_type element(It first, It last) const
             {
-                // TODO avoid dynamic allocation
-                auto selector = selector_sequence_type<dynamic()>();
-                std::size_t i = 0;
-                for (It it = first; it != last; ++it)
-                {
-                    selector.push_back(std::make_pair(m_dimension_mapping.label(i++), static_cast<size_type>(*it)));
-                }
-#ifdef _MSC_VER
-                return m_axis_function.operator()<dynamic()>(selector);
-#else
-                return m_axis_function.template operator()<dynamic()>(selector);
-#endif
+                return m_values.element(first, last);
             }
 
         private:
 
-            AF m_axis_function;
-            DM m_dimension_mapping;
-
-            template <class... Args, std::size_t... I>
-            inline selector_sequence_type<sizeof...(Args)> make_selector(std::index_sequence<I...>, Args&&... args) const
-            {
-                return {std::make_pair(m_dimension_mapping.label(I), static_cast<size_type>(args))...};
-            }
+            evaluation_type m_values;
         };
     }
 
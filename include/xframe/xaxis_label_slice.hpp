@@ -300,7 +300,8 @@ namespace xf
     template <class A>
     inline auto xaxis_range<V>::build_index_slice(const A& axis) const -> index_slice_type<A>
     {
-        return index_slice_type<A>(axis[m_first], axis[m_last] + 1);
+        auto bounds = axis.range_bounds(m_first, m_last);
+        return index_slice_type<A>(bounds.first, bounds.second);
     }
 
     /**************************************
@@ -323,7 +324,8 @@ namespace xf
     template <class A>
     inline auto xaxis_stepped_range<V>::build_index_slice(const A& axis) const -> index_slice_type<A>
     {
-        return index_slice_type<A>(axis[m_first], axis[m_last] + 1, m_step);
+        auto bounds = axis.range_bounds(m_first, m_last);
+        return index_slice_type<A>(bounds.first, bounds.second, m_step);
     }
 
     /****************************
@@ -359,7 +361,7 @@ namespace xf
     {
         using index_container_type = typename index_slice_type<A>::container_type;
         index_container_type c(m_labels.size());
-        std::transform(m_labels.cbegin(), m_labels.cend(), c.begin(), [&axis](const auto& arg) { return axis[arg]; });
+        axis.positions(m_labels.cbegin(), m_labels.cend(), c.begin());
         index_slice_type<A> res(std::move(c));
         res.normalize(axis.size());
         return res;
@@ -388,7 +390,7 @@ namespace xf
     {
         using index_container_type = typename index_slice_type<A>::container_type;
         index_container_type c(m_labels.size());
-        std::transform(m_labels.cbegin(), m_labels.cend(), c.begin(), [&axis](const auto& arg) { return axis[arg]; });
+        axis.positions(m_labels.cbegin(), m_labels.cend(), c.begin());
         index_slice_type<A> res(std::move(c));
         res.normalize(axis.size());
         return res;
@@ -18,6 +18,7 @@
 #include "xframe_config.hpp"
 #include "xframe_utils.hpp"
 #include "xframe_expression.hpp"
+#include "xaxis_evaluation.hpp"
 
 namespace xf
 {
@@ -51,6 +52,9 @@ namespace xf
         template <std::size_t N = dynamic(), class S>
         const_reference operator()(S&& /*selector*/) const;
 
+        template <class DM>
+        xaxis_evaluation<value_type> evaluate_axes(const DM& dim_mapping) const;
+
     private:
 
         data_type m_data;
@@ -72,6 +76,13 @@ namespace xf
     {
         return m_data;
     }
+
+    template <class CT>
+    template <class DM>
+    auto xaxis_scalar<CT>::evaluate_axes(const DM& /*dim_mapping*/) const -> xaxis_evaluation<value_type>
+    {
+        return xaxis_evaluation<value_type>(m_data());
+    }
 }
 
 #endif
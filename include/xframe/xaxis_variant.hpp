@@ -144,10 +144,20 @@ namespace xf
         size_type size() const;
 
         bool is_sorted() const noexcept;
+        std::size_t fingerprint() const noexcept;
 
         bool contains(const key_type& key) const;
         mapped_type operator[](const key_type& key) const;
 
+        template <class It, class O>
+        O positions(It first, It last, O out) const;
+
+        template <class It>
+        bool contains_all(It first, It last) const;
+
+        template <class K>
+        std::pair<mapped_type, mapped_type> range_bounds(const K& first, const K& last) const;
+
         template <class F>
         self_type filter(const F& f) const;
 
@@ -356,6 +366,15 @@ namespace xf
     {
         return xtl::visit([](auto&& arg) { return arg.is_sorted(); }, m_data);
     }
+
+    /**
+     * Returns a hash of the labels of the axis.
+     */
+    template <class L, class T, class MT>
+    inline std::size_t xaxis_variant<L, T, MT>::fingerprint() const noexcept
+    {
+        return xtl::visit([](auto&& arg) { return arg.fingerprint(); }, m_data);
+    }
     //@}
 
     /**
@@ -392,6 +411,49 @@ namespace xf
         };
         return xtl::visit(lambda, m_data);
     }
+
+    /**
+     * Writes the positions of the labels in [first, last) to \c out. If a
+     * label is not found, an exception is thrown. The labels can be variants
+     * or values of the label type of the axis; the variant holding the axis
+     * is visited once for the whole range.
+     * @param first iterator to the first label to search for.
+     * @param last iterator past the last label to search for.
+     * @param out the output iterator.
+     * @return the output iterator past the last written position.
+     */
+    template <class L, class T, class MT>
+    template <class It, class O>
+    inline O xaxis_variant<L, T, MT>::positions(It first, It last, O out) const
+    {
+        return xtl::visit([first, last, out](const auto& arg) { return arg.positions(first, last, out); }, m_data);
+    }
+
+    /**
+     * Returns true if the axis contains all the labels in [first, last).
+     * @param first iterator to the first label to search for.
+     * @param last iterator past the last label to search for.
+     */
+    template <class L, class T, class MT>
+    template <class It>
+    inline bool xaxis_variant<L, T, MT>::contains_all(It first, It last) const
+    {
+        return xtl::visit([first, last](const auto& arg) { return arg.contains_all(first, last); }, m_data);
+    }
+
+    /**
+     * Returns the positions [begin, end) of the labels in the closed range
+     * [first, last]. On a sorted axis, the endpoints do not need to be labels
+     * of the axis.
+     * @param first the first label of the range.
+     * @param last the last label of the range.
+     */
+    template <class L, class T, class MT>
+    template <class K>
+    inline auto xaxis_variant<L, T, MT>::range_bounds(const K& first, const K& last) const -> std::pair<mapped_type, mapped_type>
+    {
+        return xtl::visit([&first, &last](const auto& arg) { return arg.range_bounds(first, last); }, m_data);
+    }
     //@}
 
     /**
@@ -548,6 +610,11 @@ namespace xf
             return m_axis.is_sorted();
         };
 
+        inline std::size_t fingerprint() const noexcept
+        {
+            return m_axis.fingerprint();
+        };
+
     private:
 
         const axis_variant_type& m_axis;
@@ -0,0 +1,1017 @@
+/***************************************************************************
+* Copyright (c) 2017, Johan Mabille, Sylvain Corlay and Wolf Vollprecht    *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XFRAME_XBITMASK_HPP
+#define XFRAME_XBITMASK_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "xtensor/xarray.hpp"
+#include "xtensor/xutils.hpp"
+
+#include "xmissing_flags.hpp"
+
+namespace xf
+{
+    class xbitmask;
+    class xfull_coordinate;
+
+    /**********************
+     * xbitmask_reference *
+     **********************/
+
+    /**
+     * @class xbitmask_reference
+     * @brief Proxy reference on a bit of an xbitmask.
+     */
+    class xbitmask_reference
+    {
+    public:
+
+        using word_type = std::uint64_t;
+
+        xbitmask_reference(word_type* word, word_type mask, bool* all_set) noexcept;
+        xbitmask_reference(const xbitmask_reference&) = default;
+
+        operator bool() const noexcept;
+
+        xbitmask_reference& operator=(bool value) noexcept;
+        xbitmask_reference& operator=(const xbitmask_reference& rhs) noexcept;
+
+        xbitmask_reference& operator&=(bool value) noexcept;
+        xbitmask_reference& operator|=(bool value) noexcept;
+
+        void flip() noexcept;
+
+    private:
+
+        word_type* p_word;
+        word_type m_mask;
+        bool* p_all_set;
+    };
+
+    /*********************
+     * xbitmask_iterator *
+     *********************/
+
+    namespace detail
+    {
+        template <bool is_const>
+        class xbitmask_iterator
+        {
+        public:
+
+            using self_type = xbitmask_iterator<is_const>;
+            using word_type = std::uint64_t;
+            using word_pointer = std::conditional_t<is_const, const word_type*, word_type*>;
+
+            using value_type = bool;
+            using reference = std::conditional_t<is_const, bool, xbitmask_reference>;
+            using pointer = void;
+            using difference_type = std::ptrdiff_t;
+            using iterator_category = std::random_access_iterator_tag;
+
+            xbitmask_iterator() noexcept = default;
+            xbitmask_iterator(word_pointer words, std::size_t index, bool* all_set) noexcept;
+
+            template <bool C, class = std::enable_if_t<is_const && !C>>
+            xbitmask_iterator(const xbitmask_iterator<C>& rhs) noexcept;
+
+            reference operator*() const noexcept;
+            reference operator[](difference_type n) const noexcept;
+
+            self_type& operator++() noexcept;
+            self_type& operator--() noexcept;
+            self_type operator++(int) noexcept;
+            self_type operator--(int) noexcept;
+            self_type& operator+=(difference_type n) noexcept;
+            self_type& operator-=(difference_type n) noexcept;
+
+            self_type operator+(difference_type n) const noexcept;
+            self_type operator-(difference_type n) const noexcept;
+            difference_type operator-(const self_type& rhs) const noexcept;
+
+            bool operator==(const self_type& rhs) const noexcept;
+            bool operator!=(const self_type& rhs) const noexcept;
+            bool operator<(const self_type& rhs) const noexcept;
+            bool operator<=(const self_type& rhs) const noexcept;
+            bool operator>(const self_type& rhs) const noexcept;
+            bool operator>=(const self_type& rhs) const noexcept;
+
+        private:
+
+            reference get(std::size_t index) const noexcept;
+            bool get_impl(std::size_t index, std::true_type) const noexcept;
+            xbitmask_reference get_impl(std::size_t index, std::false_type) const noexcept;
+
+            word_pointer p_words = nullptr;
+            std::size_t m_index = 0;
+            bool* p_all_set = nullptr;
+
+            template <bool C>
+            friend class xbitmask_iterator;
+        };
+    }
+
+    /************
+     * xbitmask *
+     ************/
+
+    /**
+     * @class xbitmask
+     * @brief Bit-packed storage of missing flags.
+     *
+     * The xbitmask class is a one-dimensional container of booleans storing
+     * each flag in a single bit. It can be used as the storage of the flag
+     * container of an optional assembly (see xbitmask_array), which divides
+     * by eight the memory footprint of the missing mask. Flags can be combined
+     * a word at a time, and the bitmask caches whether all its flags are set,
+     * so that the mask can be skipped entirely when no value is missing.
+     */
+    class xbitmask
+    {
+    public:
+
+        using word_type = std::uint64_t;
+        using value_type = bool;
+        using reference = xbitmask_reference;
+        using const_reference = bool;
+        using iterator = detail::xbitmask_iterator<false>;
+        using const_iterator = detail::xbitmask_iterator<true>;
+        using reverse_iterator = std::reverse_iterator<iterator>;
+        using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+        using pointer = iterator;
+        using const_pointer = const_iterator;
+        using size_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
+        using allocator_type = std::allocator<bool>;
+
+        static constexpr size_type word_size = 8 * sizeof(word_type);
+
+        xbitmask() noexcept;
+        explicit xbitmask(size_type size, const allocator_type& alloc = allocator_type());
+        xbitmask(size_type size, bool value, const allocator_type& alloc = allocator_type());
+        xbitmask(std::initializer_list<bool> init, const allocator_type& alloc = allocator_type());
+
+        template <class It, class = std::enable_if_t<!std::is_integral<It>::value>>
+        xbitmask(It first, It last, const allocator_type& alloc = allocator_type());
+
+        xbitmask(const xbitmask&) = default;
+        xbitmask& operator=(const xbitmask&) = default;
+
+        xbitmask(xbitmask&&) = default;
+        xbitmask& operator=(xbitmask&&) = default;
+
+        allocator_type get_allocator() const noexcept;
+
+        bool empty() const noexcept;
+        size_type size() const noexcept;
+        size_type max_size() const noexcept;
+        void resize(size_type size);
+        void resize(size_type size, bool value);
+        void swap(xbitmask& rhs) noexcept;
+
+        reference operator[](size_type i) noexcept;
+        const_reference operator[](size_type i) const noexcept;
+
+        reference front() noexcept;
+        const_reference front() const noexcept;
+        reference back() noexcept;
+        const_reference back() const noexcept;
+
+        iterator begin() noexcept;
+        iterator end() noexcept;
+        const_iterator begin() const noexcept;
+        const_iterator end() const noexcept;
+        const_iterator cbegin() const noexcept;
+        const_iterator cend() const noexcept;
+
+        reverse_iterator rbegin() noexcept;
+        reverse_iterator rend() noexcept;
+        const_reverse_iterator rbegin() const noexcept;
+        const_reverse_iterator rend() const noexcept;
+        const_reverse_iterator crbegin() const noexcept;
+        const_reverse_iterator crend() const noexcept;
+
+        size_type nb_words() const noexcept;
+        word_type* words() noexcept;
+        const word_type* words() const noexcept;
+
+        bool all() const noexcept;
+        bool none() const noexcept;
+        size_type count() const noexcept;
+        void set(bool value = true) noexcept;
+
+        xbitmask& operator&=(const xbitmask& rhs);
+        xbitmask& operator|=(const xbitmask& rhs);
+
+        template <class It>
+        void assign_conjunction(It first, It last);
+
+    private:
+
+        static size_type word_count(size_type size) noexcept;
+        word_type tail_mask() const noexcept;
+        void clear_tail() noexcept;
+        void check_size(const xbitmask& rhs) const;
+
+        std::vector<word_type> m_words;
+        size_type m_size;
+        mutable bool m_all_set;
+    };
+
+    bool operator==(const xbitmask& lhs, const xbitmask& rhs) noexcept;
+    bool operator!=(const xbitmask& lhs, const xbitmask& rhs) noexcept;
+
+    xbitmask operator&(const xbitmask& lhs, const xbitmask& rhs);
+    xbitmask operator|(const xbitmask& lhs, const xbitmask& rhs);
+
+    /**
+     * Flag container storing one bit per flag, usable in place of
+     * xt::xarray<bool> in an optional assembly.
+     */
+    using xbitmask_array = xt::xarray_container<xbitmask, XTENSOR_DEFAULT_LAYOUT, xt::dynamic_shape<std::size_t>>;
+
+    /*************************************
+     * xbitmask_reference implementation *
+     *************************************/
+
+    inline xbitmask_reference::xbitmask_reference(word_type* word, word_type mask, bool* all_set) noexcept
+        : p_word(word), m_mask(mask), p_all_set(all_set)
+    {
+    }
+
+    inline xbitmask_reference::operator bool() const noexcept
+    {
+        return (*p_word & m_mask) != 0;
+    }
+
+    inline xbitmask_reference& xbitmask_reference::operator=(bool value) noexcept
+    {
+        if (value)
+        {
+            *p_word |= m_mask;
+        }
+        else
+        {
+            *p_word &= ~m_mask;
+            *p_all_set = false;
+        }
+        return *this;
+    }
+
+    inline xbitmask_reference& xbitmask_reference::operator=(const xbitmask_reference& rhs) noexcept
+    {
+        return *this = bool(rhs);
+    }
+
+    inline xbitmask_reference& xbitmask_reference::operator&=(bool value) noexcept
+    {
+        return *this = bool(*this) && value;
+    }
+
+    inline xbitmask_reference& xbitmask_reference::operator|=(bool value) noexcept
+    {
+        return *this = bool(*this) || value;
+    }
+
+    inline void xbitmask_reference::flip() noexcept
+    {
+        *this = !bool(*this);
+    }
+
+    /************************************
+     * xbitmask_iterator implementation *
+     ************************************/
+
+    namespace detail
+    {
+        template <bool is_const>
+        inline xbitmask_iterator<is_const>::xbitmask_iterator(word_pointer words, std::size_t index, bool* all_set) noexcept
+            : p_words(words), m_index(index), p_all_set(all_set)
+        {
+        }
+
+        template <bool is_const>
+        template <bool C, class>
+        inline xbitmask_iterator<is_const>::xbitmask_iterator(const xbitmask_iterator<C>& rhs) noexcept
+            : p_words(rhs.p_words), m_index(rhs.m_index), p_all_set(rhs.p_all_set)
+        {
+        }
+
+        template <bool is_const>
+        inline auto xbitmask_iterator<is_const>::get(std::size_t index) const noexcept -> reference
+        {
+            return get_impl(index, std::integral_constant<bool, is_const>());
+        }
+
+        template <bool is_const>
+        inline bool xbitmask_iterator<is_const>::get_impl(std::size_t index, std::true_type) const noexcept
+        {
+            return ((p_words[index / xbitmask::word_size] >> (index % xbitmask::word_size)) & word_type(1)) != 0;
+        }
+
+        template <bool is_const>
+        inline xbitmask_reference xbitmask_iterator<is_const>::get_impl(std::size_t index, std::false_type) const noexcept
+        {
+            return xbitmask_reference(p_words + index / xbitmask::word_size,
+                                      word_type(1) << (index % xbitmask::word_size), p_all_set);
+        }
+
+        template <bool is_const>
+        inline auto xbitmask_iterator<is_const>::operator*() const noexcept -> reference
+        {
+            return get(m_index);
+        }
+
+        template <bool is_const>
+        inline auto xbitmask_iterator<is_const>::operator[](difference_type n) const noexcept -> reference
+        {
+            return get(static_cast<std::size_t>(static_cast<difference_type>(m_index) + n));
+        }
+
+        template <bool is_const>
+        inline auto xbitmask_iterator<is_const>::operator++() noexcept -> self_type&
+        {
+            ++m_index;
+            return *this;
+        }
+
+        template <bool is_const>
+        inline auto xbitmask_iterator<is_const>::operator--() noexcept -> self_type&
+        {
+            --m_index;
+            return *this;
+        }
+
+        template <bool is_const>
+        inline auto xbitmask_iterator<is_const>::operator++(int) noexcept -> self_type
+        {
+            self_type tmp(*this);
+            ++m_index;
+            return tmp;
+        }
+
+        template <bool is_const>
+        inline auto xbitmask_iterator<is_const>::operator--(int) noexcept -> self_type
+        {
+            self_type tmp(*this);
+            --m_index;
+            return tmp;
+        }
+
+        template <bool is_const>
+        inline auto xbitmask_iterator<is_const>::operator+=(difference_type n) noexcept -> self_type&
+        {
+            m_index = static_cast<std::size_t>(static_cast<difference_type>(m_index) + n);
+            return *this;
+        }
+
+        template <bool is_const>
+        inline auto xbitmask_iterator<is_const>::operator-=(difference_type n) noexcept -> self_type&
+        {
+            m_index = static_cast<std::size_t>(static_cast<difference_type>(m_index) - n);
+            return *this;
+        }
+
+        template <bool is_const>
+        inline auto xbitmask_iterator<is_const>::operator+(difference_type n) const noexcept -> self_type
+        {
+            self_type tmp(*this);
+            return tmp += n;
+        }
+
+        template <bool is_const>
+        inline auto xbitmask_iterator<is_const>::operator-(difference_type n) const noexcept -> self_type
+        {
+            self_type tmp(*this);
+            return tmp -= n;
+        }
+
+        template <bool is_const>
+        inline auto xbitmask_iterator<is_const>::operator-(const self_type& rhs) const noexcept -> difference_type
+        {
+            return static_cast<difference_type>(m_index) - static_cast<difference_type>(rhs.m_index);
+        }
+
+        template <bool is_const>
+        inline bool xbitmask_iterator<is_const>::operator==(const self_type& rhs) const noexcept
+        {
+            return p_words == rhs.p_words && m_index == rhs.m_index;
+        }
+
+        template <bool is_const>
+        inline bool xbitmask_iterator<is_const>::operator!=(const self_type& rhs) const noexcept
+        {
+            return !(*this == rhs);
+        }
+
+        template <bool is_const>
+        inline bool xbitmask_iterator<is_const>::operator<(const self_type& rhs) const noexcept
+        {
+            return m_index < rhs.m_index;
+        }
+
+        template <bool is_const>
+        inline bool xbitmask_iterator<is_const>::operator<=(const self_type& rhs) const noexcept
+        {
+            return m_index <= rhs.m_index;
+        }
+
+        template <bool is_const>
+        inline bool xbitmask_iterator<is_const>::operator>(const self_type& rhs) const noexcept
+        {
+            return m_index > rhs.m_index;
+        }
+
+        template <bool is_const>
+        inline bool xbitmask_iterator<is_const>::operator>=(const self_type& rhs) const noexcept
+        {
+            return m_index >= rhs.m_index;
+        }
+
+        template <bool is_const>
+        inline xbitmask_iterator<is_const> operator+(typename xbitmask_iterator<is_const>::difference_type n,
+                                                     const xbitmask_iterator<is_const>& it) noexcept
+        {
+            return it + n;
+        }
+    }
+
+    /***************************
+     * xbitmask implementation *
+     ***************************/
+
+    inline xbitmask::xbitmask() noexcept
+        : m_words(), m_size(0), m_all_set(true)
+    {
+    }
+
+    inline xbitmask::xbitmask(size_type size, const allocator_type& alloc)
+        : xbitmask(size, false, alloc)
+    {
+    }
+
+    inline xbitmask::xbitmask(size_type size, bool value, const allocator_type&)
+        : m_words(word_count(size), value ? ~word_type(0) : word_type(0)), m_size(size), m_all_set(value || size == 0)
+    {
+        clear_tail();
+    }
+
+    inline xbitmask::xbitmask(std::initializer_list<bool> init, const allocator_type& alloc)
+        : xbitmask(init.begin(), init.end(), alloc)
+    {
+    }
+
+    template <class It, class>
+    inline xbitmask::xbitmask(It first, It last, const allocator_type& alloc)
+        : xbitmask(static_cast<size_type>(std::distance(first, last)), true, alloc)
+    {
+        std::copy(first, last, begin());
+    }
+
+    inline auto xbitmask::get_allocator() const noexcept -> allocator_type
+    {
+        return allocator_type();
+    }
+
+    inline bool xbitmask::empty() const noexcept
+    {
+        return m_size == 0;
+    }
+
+    inline auto xbitmask::size() const noexcept -> size_type
+    {
+        return m_size;
+    }
+
+    inline auto xbitmask::max_size() const noexcept -> size_type
+    {
+        return m_words.max_size() * word_size;
+    }
+
+    /**
+     * Resizes the bitmask. New flags are unset.
+     */
+    inline void xbitmask::resize(size_type size)
+    {
+        resize(size, false);
+    }
+
+    /**
+     * Resizes the bitmask, setting the new flags to \c value.
+     */
+    inline void xbitmask::resize(size_type size, bool value)
+    {
+        if (size > m_size)
+        {
+            if (value && m_size % word_size != 0)
+            {
+                m_words.back() |= ~tail_mask();
+            }
+            m_words.resize(word_count(size), value ? ~word_type(0) : word_type(0));
+            m_all_set = m_all_set && value;
+        }
+        else
+        {
+            m_words.resize(word_count(size));
+        }
+        m_size = size;
+        clear_tail();
+    }
+
+    inline void xbitmask::swap(xbitmask& rhs) noexcept
+    {
+        using std::swap;
+        swap(m_words, rhs.m_words);
+        swap(m_size, rhs.m_size);
+        swap(m_all_set, rhs.m_all_set);
+    }
+
+    inline auto xbitmask::operator[](size_type i) noexcept -> reference
+    {
+        return begin()[static_cast<difference_type>(i)];
+    }
+
+    inline auto xbitmask::operator[](size_type i) const noexcept -> const_reference
+    {
+        return cbegin()[static_cast<difference_type>(i)];
+    }
+
+    inline auto xbitmask::front() noexcept -> reference
+    {
+        return (*this)[0];
+    }
+
+    inline auto xbitmask::front() const noexcept -> const_reference
+    {
+        return (*this)[0];
+    }
+
+    inline auto xbitmask::back() noexcept -> reference
+    {
+        return (*this)[m_size - 1];
+    }
+
+    inline auto xbitmask::back() const noexcept -> const_reference
+    {
+        return (*this)[m_size - 1];
+    }
+
+    inline auto xbitmask::begin() noexcept -> iterator
+    {
+        return iterator(m_words.data(), 0, &m_all_set);
+    }
+
+    inline auto xbitmask::end() noexcept -> iterator
+    {
+        return iterator(m_words.data(), m_size, &m_all_set);
+    }
+
+    inline auto xbitmask::begin() const noexcept -> const_iterator
+    {
+        return cbegin();
+    }
+
+    inline auto xbitmask::end() const noexcept -> const_iterator
+    {
+        return cend();
+    }
+
+    inline auto xbitmask::cbegin() const noexcept -> const_iterator
+    {
+        return const_iterator(m_words.data(), 0, &m_all_set);
+    }
+
+    inline auto xbitmask::cend() const noexcept -> const_iterator
+    {
+        return const_iterator(m_words.data(), m_size, &m_all_set);
+    }
+
+    inline auto xbitmask::rbegin() noexcept -> reverse_iterator
+    {
+        return reverse_iterator(end());
+    }
+
+    inline auto xbitmask::rend() noexcept -> reverse_iterator
+    {
+        return reverse_iterator(begin());
+    }
+
+    inline auto xbitmask::rbegin() const noexcept -> const_reverse_iterator
+    {
+        return crbegin();
+    }
+
+    inline auto xbitmask::rend() const noexcept -> const_reverse_iterator
+    {
+        return crend();
+    }
+
+    inline auto xbitmask::crbegin() const noexcept -> const_reverse_iterator
+    {
+        return const_reverse_iterator(cend());
+    }
+
+    inline auto xbitmask::crend() const noexcept -> const_reverse_iterator
+    {
+        return const_reverse_iterator(cbegin());
+    }
+
+    /**
+     * Returns the number of words holding the flags.
+     */
+    inline auto xbitmask::nb_words() const noexcept -> size_type
+    {
+        return m_words.size();
+    }
+
+    /**
+     * Returns a pointer to the words holding the flags. The flag \c i
+     * is the bit <tt>i % word_size</tt> of the word <tt>i / word_size</tt>,
+     * and the unused bits of the last word are always unset. Writing
+     * through this pointer invalidates the cached result of all().
+     */
+    inline auto xbitmask::words() noexcept -> word_type*
+    {
+        m_all_set = false;
+        return m_words.data();
+    }
+
+    inline auto xbitmask::words() const noexcept -> const word_type*
+    {
+        return m_words.data();
+    }
+
+    /**
+     * Returns true if all the flags are set. This is a constant time
+     * operation when the bitmask has not been modified since the last
+     * call returning true, or since it has been entirely set.
+     */
+    inline bool xbitmask::all() const noexcept
+    {
+        if (!m_all_set)
+        {
+            size_type nb_full = m_size / word_size;
+            bool res = std::all_of(m_words.cbegin(), m_words.cbegin() + static_cast<difference_type>(nb_full),
+                                   [](word_type w) { return w == ~word_type(0); });
+            m_all_set = res && (nb_full == m_words.size() || m_words.back() == tail_mask());
+        }
+        return m_all_set;
+    }
+
+    /**
+     * Returns true if no flag is set.
+     */
+    inline bool xbitmask::none() const noexcept
+    {
+        return std::all_of(m_words.cbegin(), m_words.cend(), [](word_type w) { return w == word_type(0); });
+    }
+
+    /**
+     * Returns the number of set flags.
+     */
+    inline auto xbitmask::count() const noexcept -> size_type
+    {
+        size_type res = 0;
+        for (word_type w : m_words)
+        {
+            for (; w != word_type(0); w &= w - 1)
+            {
+                ++res;
+            }
+        }
+        return res;
+    }
+
+    /**
+     * Sets all the flags to \c value.
+     */
+    inline void xbitmask::set(bool value) noexcept
+    {
+        std::fill(m_words.begin(), m_words.end(), value ? ~word_type(0) : word_type(0));
+        clear_tail();
+        m_all_set = value || m_size == 0;
+    }
+
+    /**
+     * Computes the intersection of this bitmask and \c rhs, a word at a time.
+     */
+    inline xbitmask& xbitmask::operator&=(const xbitmask& rhs)
+    {
+        check_size(rhs);
+        if (!rhs.m_all_set)
+        {
+            for (size_type i = 0; i < m_words.size(); ++i)
+            {
+                m_words[i] &= rhs.m_words[i];
+            }
+            m_all_set = false;
+        }
+        return *this;
+    }
+
+    /**
+     * Computes the union of this bitmask and \c rhs, a word at a time.
+     */
+    inline xbitmask& xbitmask::operator|=(const xbitmask& rhs)
+    {
+        check_size(rhs);
+        if (!m_all_set)
+        {
+            for (size_type i = 0; i < m_words.size(); ++i)
+            {
+                m_words[i] |= rhs.m_words[i];
+            }
+            m_all_set = rhs.m_all_set;
+        }
+        return *this;
+    }
+
+    /**
+     * Assigns the intersection of the bitmasks in [first, last) to this
+     * bitmask. The range holds pointers to bitmasks of the same size as
+     * this one; it may contain this bitmask. Bitmasks known to be entirely
+     * set are skipped, and if all of them are, the words are not read at all.
+     */
+    template <class It>
+    inline void xbitmask::assign_conjunction(It first, It last)
+    {
+        std::vector<const word_type*> operands;
+        for (; first != last; ++first)
+        {
+            check_size(**first);
+            if (!(*first)->all())
+            {
+                operands.push_back((*first)->m_words.data());
+            }
+        }
+
+        if (operands.empty())
+        {
+            if (!m_all_set)
+            {
+                set(true);
+            }
+            return;
+        }
+
+        for (size_type i = 0; i < m_words.size(); ++i)
+        {
+            word_type w = operands[0][i];
+            for (size_type j = 1; j < operands.size(); ++j)
+            {
+                w &= operands[j][i];
+            }
+            m_words[i] = w;
+        }
+        m_all_set = false;
+    }
+
+    inline auto xbitmask::word_count(size_type size) noexcept -> size_type
+    {
+        return (size + word_size - 1) / word_size;
+    }
+
+    inline auto xbitmask::tail_mask() const noexcept -> word_type
+    {
+        size_type r = m_size % word_size;
+        return r == 0 ? ~word_type(0) : (word_type(1) << r) - word_type(1);
+    }
+
+    inline void xbitmask::clear_tail() noexcept
+    {
+        if (!m_words.empty())
+        {
+            m_words.back() &= tail_mask();
+        }
+    }
+
+    inline void xbitmask::check_size(const xbitmask& rhs) const
+    {
+        if (rhs.m_size != m_size)
+        {
+            throw std::runtime_error("xbitmask: size mismatch");
+        }
+    }
+
+    inline bool operator==(const xbitmask& lhs, const xbitmask& rhs) noexcept
+    {
+        return lhs.size() == rhs.size() &&
+            std::equal(lhs.words(), lhs.words() + lhs.nb_words(), rhs.words());
+    }
+
+    inline bool operator!=(const xbitmask& lhs, const xbitmask& rhs) noexcept
+    {
+        return !(lhs == rhs);
+    }
+
+    inline xbitmask operator&(const xbitmask& lhs, const xbitmask& rhs)
+    {
+        xbitmask res(lhs);
+        res &= rhs;
+        return res;
+    }
+
+    inline xbitmask operator|(const xbitmask& lhs, const xbitmask& rhs)
+    {
+        xbitmask res(lhs);
+        res |= rhs;
+        return res;
+    }
+
+    inline void swap(xbitmask& lhs, xbitmask& rhs) noexcept
+    {
+        lhs.swap(rhs);
+    }
+
+    /********************************
+     * missing flags helpers        *
+     ********************************/
+
+    namespace detail
+    {
+        template <>
+        struct flag_storage_traits<xbitmask>
+        {
+            static bool all_set(const xbitmask& storage)
+            {
+                return storage.all();
+            }
+
+            static void set_all(xbitmask& storage)
+            {
+                if (!storage.all())
+                {
+                    storage.set(true);
+                }
+            }
+        };
+
+        template <class E, class = void>
+        struct has_variable_arguments : std::false_type
+        {
+        };
+
+        template <class E>
+        struct has_variable_arguments<E, xt::void_t<decltype(std::declval<const E&>().arguments())>>
+            : std::true_type
+        {
+        };
+
+        template <class E, class = void>
+        struct is_scalar_variable : std::false_type
+        {
+        };
+
+        template <class E>
+        struct is_scalar_variable<E, xt::void_t<typename E::coordinate_type>>
+            : std::is_same<typename E::coordinate_type, xfull_coordinate>
+        {
+        };
+
+        template <class E>
+        using bitmask_node_kind = std::integral_constant<int,
+            has_variable_arguments<E>::value ? 1 :
+            (is_scalar_variable<E>::value ? 2 :
+            (has_bitmask_flags<const E>::value ? 3 : 0))>;
+
+        // Views on bitmasks, such as the data of variable views and of
+        // expand_dims views, do not map flat positions to bits one to one.
+        template <class F>
+        struct is_bitmask_container : std::false_type
+        {
+        };
+
+        template <xt::layout_type L, class SC, class Tag>
+        struct is_bitmask_container<xt::xarray_container<xbitmask, L, SC, Tag>> : std::true_type
+        {
+        };
+
+        template <std::size_t N, xt::layout_type L, class Tag>
+        struct is_bitmask_container<xt::xtensor_container<xbitmask, N, L, Tag>> : std::true_type
+        {
+        };
+
+        using bitmask_list = std::vector<const xbitmask*>;
+
+        template <class F, class E>
+        bool collect_bitmasks(const F& flags, const E& e, bitmask_list& masks);
+
+        template <class F, class E>
+        inline bool collect_bitmasks_impl(const F&, const E&, bitmask_list&, std::integral_constant<int, 0>)
+        {
+            return false;
+        }
+
+        template <class F, class T, std::size_t... I>
+        inline bool collect_bitmask_arguments(const F& flags, const T& t, bitmask_list& masks, std::index_sequence<I...>)
+        {
+            bool res = true;
+            bool dummy[] = { true, (res = res && collect_bitmasks(flags, std::get<I>(t), masks))... };
+            (void)dummy;
+            return res;
+        }
+
+        template <class F, class E>
+        inline bool collect_bitmasks_impl(const F& flags, const E& e, bitmask_list& masks, std::integral_constant<int, 1>)
+        {
+            using tuple_type = std::decay_t<decltype(e.arguments())>;
+            return collect_bitmask_arguments(flags, e.arguments(), masks,
+                                             std::make_index_sequence<std::tuple_size<tuple_type>::value>());
+        }
+
+        template <class F, class E>
+        inline bool collect_bitmasks_impl(const F&, const E&, bitmask_list&, std::integral_constant<int, 2>)
+        {
+            return std::is_arithmetic<typename E::value_type>::value;
+        }
+
+        template <class F, class G>
+        inline bool collect_bitmask_container(const F&, const G&, bitmask_list&, std::false_type)
+        {
+            return false;
+        }
+
+        // The bits of both containers match if they have the same shape,
+        // layout and strides
+        template <class F, class G>
+        inline bool collect_bitmask_container(const F& flags, const G& operand, bitmask_list& masks, std::true_type)
+        {
+            bool same_layout = operand.layout() == flags.layout() &&
+                operand.shape().size() == flags.shape().size() &&
+                std::equal(operand.shape().cbegin(), operand.shape().cend(), flags.shape().cbegin()) &&
+                std::equal(operand.strides().cbegin(), operand.strides().cend(), flags.strides().cbegin());
+            if (same_layout)
+            {
+                masks.push_back(&(operand.data()));
+            }
+            return same_layout;
+        }
+
+        template <class F, class E>
+        inline bool collect_bitmasks_impl(const F& flags, const E& e, bitmask_list& masks, std::integral_constant<int, 3>)
+        {
+            const auto& operand = e.data().has_value();
+            return collect_bitmask_container(flags, operand, masks, is_bitmask_container<std::decay_t<decltype(operand)>>());
+        }
+
+        // Gathers the bitmasks of the variables involved in an element-wise
+        // expression. Returns false if a node of the expression does not
+        // store its missing flags in a bitmask container laid out as flags.
+        template <class F, class E>
+        inline bool collect_bitmasks(const F& flags, const E& e, bitmask_list& masks)
+        {
+            return collect_bitmasks_impl(flags, e, masks, bitmask_node_kind<E>());
+        }
+
+        template <class F, class E>
+        inline bool assign_bitmask_conjunction_impl(F&, const E&, std::false_type)
+        {
+            return false;
+        }
+
+        template <class F, class E>
+        inline bool assign_bitmask_conjunction_impl(F& flags, const E& e, std::true_type)
+        {
+            bitmask_list masks;
+            if (!collect_bitmasks(flags, e, masks))
+            {
+                return false;
+            }
+            flags.data().assign_conjunction(masks.cbegin(), masks.cend());
+            return true;
+        }
+
+        /**
+         * Computes the missing flags of the element-wise expression \c e,
+         * a word at a time, and assigns them to the flag container \c flags.
+         * Returns false if \c flags is not a bitmask container, or if the
+         * expression holds operands whose flags are not stored in bitmask
+         * containers with the shape, the layout and the strides of \c flags,
+         * in which case \c flags is left unchanged.
+         */
+        template <class F, class E>
+        inline bool assign_bitmask_conjunction(F& flags, const E& e)
+        {
+            return assign_bitmask_conjunction_impl(flags, e, is_bitmask_container<F>());
+        }
+    }
+}
+
+#endif
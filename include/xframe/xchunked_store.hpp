@@ -0,0 +1,1089 @@
+/***************************************************************************
+* Copyright (c) 2017, Johan Mabille, Sylvain Corlay and Wolf Vollprecht    *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XFRAME_XCHUNKED_STORE_HPP
+#define XFRAME_XCHUNKED_STORE_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "xtensor/xarray.hpp"
+#include "xtensor/xoptional_assembly.hpp"
+
+#include "xaxis_label_slice.hpp"
+#include "xaxis_view.hpp"
+#include "xcoordinate.hpp"
+#include "xdimension.hpp"
+#include "xparallel.hpp"
+#include "xvariable.hpp"
+
+namespace xf
+{
+
+    /****************
+     * xchunk_codec *
+     ****************/
+
+    /**
+     * @class xchunk_codec
+     * @brief Built-in codec used to compress chunks.
+     *
+     * The xchunk_codec class encodes a buffer of trivially copyable values in
+     * three passes: each value is reinterpreted as an unsigned word and replaced
+     * with its difference to the previous one, the bytes of the words are then
+     * shuffled so that bytes of the same significance are contiguous, and the
+     * result is run-length encoded. Smooth numerical data and missing flags
+     * compress well, and decoding does not require any external library.
+     */
+    class xchunk_codec
+    {
+    public:
+
+        using buffer_type = std::vector<std::uint8_t>;
+
+        template <class T>
+        static buffer_type encode(const T* data, std::size_t size);
+
+        template <class T>
+        static void decode(const buffer_type& buffer, T* data, std::size_t size);
+    };
+
+    template <class T, class C>
+    class xchunked_variable;
+
+    /******************
+     * xchunked_store *
+     ******************/
+
+    /**
+     * @class xchunked_store
+     * @brief Chunked on-disk storage for variables.
+     *
+     * The xchunked_store class persists variables in an existing directory.
+     * Each variable is stored as a metadata file, describing its value type,
+     * its coordinates, its dimension mapping and its chunk grid, and as a set of chunk files,
+     * each of them holding the values and the missing flags of a hyperrectangle
+     * of the data, compressed with the xchunk_codec. Chunks are read and written
+     * in parallel.
+     *
+     * @sa xchunked_variable
+     */
+    class xchunked_store
+    {
+    public:
+
+        using size_type = std::size_t;
+        using chunk_shape_type = std::vector<size_type>;
+
+        explicit xchunked_store(const std::string& directory, size_type nb_threads = 0);
+
+        const std::string& directory() const noexcept;
+        size_type nb_threads() const noexcept;
+
+        template <class V>
+        void dump(const std::string& name, const V& variable, const chunk_shape_type& chunk_shape) const;
+
+        template <class T, class C = xcoordinate<fstring>>
+        xchunked_variable<T, C> open(const std::string& name) const;
+
+        void remove(const std::string& name) const;
+
+    private:
+
+        std::string path(const std::string& name) const;
+
+        std::string m_directory;
+        size_type m_nb_threads;
+    };
+
+    xchunked_store chunked_store(const std::string& directory, std::size_t nb_threads = 0);
+
+    /*********************
+     * xchunked_variable *
+     *********************/
+
+    /**
+     * @class xchunked_variable
+     * @brief Lazy handle on a variable stored in an xchunked_store.
+     *
+     * The xchunked_variable class holds the coordinates and the dimension
+     * mapping of a stored variable, but none of its data. Data is read
+     * upon request, and only the chunks intersecting the requested
+     * selection are fetched from the disk.
+     *
+     * @tparam T the value type of the stored variable.
+     * @tparam C the coordinate type of the stored variable.
+     */
+    template <class T, class C>
+    class xchunked_variable
+    {
+    public:
+
+        using value_type = T;
+        using coordinate_type = C;
+        using key_type = typename coordinate_type::key_type;
+        using label_list = typename coordinate_type::label_list;
+        using size_type = typename coordinate_type::size_type;
+        using dimension_type = xdimension<key_type, size_type>;
+        using data_type = xt::xoptional_assembly<xt::xarray<T>, xt::xarray<bool>>;
+        using variable_type = xvariable_container<coordinate_type, data_type>;
+        using shape_type = std::vector<size_type>;
+        using slice_type = xaxis_slice<label_list>;
+        using slice_map = std::map<key_type, slice_type>;
+
+        const coordinate_type& coordinates() const noexcept;
+        const dimension_type& dimension_mapping() const noexcept;
+        const shape_type& shape() const noexcept;
+        const shape_type& chunk_shape() const noexcept;
+        size_type nb_chunks() const noexcept;
+
+        variable_type load() const;
+        variable_type select(const slice_map& slices) const;
+
+        template <class... S>
+        variable_type locate(S&&... slices) const;
+
+    private:
+
+        xchunked_variable(std::string prefix, coordinate_type&& coords, dimension_type&& dims,
+                          shape_type&& shape, shape_type&& chunk_shape, std::size_t nb_threads);
+
+        std::string m_prefix;
+        coordinate_type m_coordinate;
+        dimension_type m_dimension_mapping;
+        shape_type m_shape;
+        shape_type m_chunk_shape;
+        std::size_t m_nb_threads;
+
+        friend class xchunked_store;
+    };
+
+    /*******************************
+     * xchunk_codec implementation *
+     *******************************/
+
+    namespace detail
+    {
+        template <std::size_t N>
+        struct codec_word;
+
+        template <>
+        struct codec_word<1>
+        {
+            using type = std::uint8_t;
+        };
+
+        template <>
+        struct codec_word<2>
+        {
+            using type = std::uint16_t;
+        };
+
+        template <>
+        struct codec_word<4>
+        {
+            using type = std::uint32_t;
+        };
+
+        template <>
+        struct codec_word<8>
+        {
+            using type = std::uint64_t;
+        };
+
+        // PackBits-like encoding: a header byte h < 128 is followed by h + 1
+        // literal bytes, a header byte h >= 128 is followed by a single byte
+        // repeated h - 126 times.
+        inline xchunk_codec::buffer_type rle_encode(const xchunk_codec::buffer_type& input)
+        {
+            xchunk_codec::buffer_type res;
+            res.reserve(input.size() / 4 + 16);
+            std::size_t size = input.size();
+            std::size_t i = 0;
+            while (i < size)
+            {
+                std::size_t run = 1;
+                while (i + run < size && run < 129 && input[i + run] == input[i])
+                {
+                    ++run;
+                }
+                if (run >= 2)
+                {
+                    res.push_back(static_cast<std::uint8_t>(126 + run));
+                    res.push_back(input[i]);
+                    i += run;
+                }
+                else
+                {
+                    std::size_t start = i;
+                    std::size_t length = 0;
+                    while (i < size && length < 128 && (i + 1 == size || input[i + 1] != input[i]))
+                    {
+                        ++i;
+                        ++length;
+                    }
+                    res.push_back(static_cast<std::uint8_t>(length - 1));
+                    res.insert(res.end(), input.begin() + static_cast<std::ptrdiff_t>(start),
+                               input.begin() + static_cast<std::ptrdiff_t>(i));
+                }
+            }
+            return res;
+        }
+
+        inline xchunk_codec::buffer_type rle_decode(const xchunk_codec::buffer_type& input, std::size_t size)
+        {
+            xchunk_codec::buffer_type res;
+            res.reserve(size);
+            std::size_t i = 0;
+            while (i < input.size())
+            {
+                std::size_t header = input[i++];
+                if (header < 128)
+                {
+                    std::size_t length = header + 1;
+                    if (i + length > input.size() || res.size() + length > size)
+                    {
+                        throw std::runtime_error("xchunk_codec: corrupted chunk");
+                    }
+                    res.insert(res.end(), input.begin() + static_cast<std::ptrdiff_t>(i),
+                               input.begin() + static_cast<std::ptrdiff_t>(i + length));
+                    i += length;
+                }
+                else
+                {
+                    std::size_t length = header - 126;
+                    if (i == input.size() || res.size() + length > size)
+                    {
+                        throw std::runtime_error("xchunk_codec: corrupted chunk");
+                    }
+                    res.insert(res.end(), length, input[i++]);
+                }
+            }
+            if (res.size() != size)
+            {
+                throw std::runtime_error("xchunk_codec: corrupted chunk");
+            }
+            return res;
+        }
+    }
+
+    /**
+     * Encodes the specified buffer.
+     * @param data a pointer to the first value to encode.
+     * @param size the number of values to encode.
+     * @return the encoded bytes.
+     */
+    template <class T>
+    inline auto xchunk_codec::encode(const T* data, std::size_t size) -> buffer_type
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "xchunk_codec requires trivially copyable values");
+        using word_type = typename detail::codec_word<sizeof(T)>::type;
+        constexpr std::size_t width = sizeof(T);
+
+        buffer_type shuffled(size * width);
+        word_type previous = word_type(0);
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            word_type current;
+            std::memcpy(&current, data + i, width);
+            word_type delta = static_cast<word_type>(current - previous);
+            previous = current;
+            for (std::size_t b = 0; b < width; ++b)
+            {
+                shuffled[b * size + i] = static_cast<std::uint8_t>(delta >> (8 * b));
+            }
+        }
+        return detail::rle_encode(shuffled);
+    }
+
+    /**
+     * Decodes the specified buffer.
+     * @param buffer the encoded bytes.
+     * @param data a pointer to the destination of the decoded values.
+     * @param size the number of values to decode.
+     */
+    template <class T>
+    inline void xchunk_codec::decode(const buffer_type& buffer, T* data, std::size_t size)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "xchunk_codec requires trivially copyable values");
+        using word_type = typename detail::codec_word<sizeof(T)>::type;
+        constexpr std::size_t width = sizeof(T);
+
+        buffer_type shuffled = detail::rle_decode(buffer, size * width);
+        word_type previous = word_type(0);
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            word_type delta = word_type(0);
+            for (std::size_t b = 0; b < width; ++b)
+            {
+                delta = static_cast<word_type>(delta | static_cast<word_type>(word_type(shuffled[b * size + i]) << (8 * b)));
+            }
+            word_type current = static_cast<word_type>(previous + delta);
+            std::memcpy(data + i, &current, width);
+            previous = current;
+        }
+    }
+
+    /************************************
+     * serialization and chunk handling *
+     ************************************/
+
+    namespace detail
+    {
+        inline void write_size(std::ostream& out, std::size_t size)
+        {
+            std::uint64_t s = static_cast<std::uint64_t>(size);
+            out.write(reinterpret_cast<const char*>(&s), sizeof(s));
+        }
+
+        inline std::size_t read_size(std::istream& in)
+        {
+            std::uint64_t s = 0;
+            in.read(reinterpret_cast<char*>(&s), sizeof(s));
+            if (!in)
+            {
+                throw std::runtime_error("xchunked_store: unexpected end of file");
+            }
+            return static_cast<std::size_t>(s);
+        }
+
+        template <class T>
+        inline std::enable_if_t<std::is_arithmetic<T>::value> write_value(std::ostream& out, const T& value)
+        {
+            out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+        }
+
+        template <class T>
+        inline std::enable_if_t<!std::is_arithmetic<T>::value> write_value(std::ostream& out, const T& value)
+        {
+            std::string s(value.cbegin(), value.cend());
+            write_size(out, s.size());
+            out.write(s.data(), static_cast<std::streamsize>(s.size()));
+        }
+
+        template <class T>
+        inline std::enable_if_t<std::is_arithmetic<T>::value, T> read_value(std::istream& in)
+        {
+            T value;
+            in.read(reinterpret_cast<char*>(&value), sizeof(T));
+            return value;
+        }
+
+        template <class T>
+        inline std::enable_if_t<!std::is_arithmetic<T>::value, T> read_value(std::istream& in)
+        {
+            std::string s(read_size(in), '\0');
+            in.read(&s[0], static_cast<std::streamsize>(s.size()));
+            return T(s.c_str());
+        }
+
+        inline void write_buffer(std::ostream& out, const xchunk_codec::buffer_type& buffer)
+        {
+            write_size(out, buffer.size());
+            out.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+        }
+
+        inline xchunk_codec::buffer_type read_buffer(std::istream& in)
+        {
+            xchunk_codec::buffer_type buffer(read_size(in));
+            in.read(reinterpret_cast<char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+            if (!in)
+            {
+                throw std::runtime_error("xchunked_store: unexpected end of file");
+            }
+            return buffer;
+        }
+
+        template <class... L>
+        struct chunked_axis_io;
+
+        template <>
+        struct chunked_axis_io<>
+        {
+            template <class A>
+            static void write(std::ostream&, const A&, std::size_t)
+            {
+                throw std::runtime_error("xchunked_store: unsupported label type");
+            }
+
+            template <class A>
+            static A read(std::istream&, std::size_t)
+            {
+                throw std::runtime_error("xchunked_store: unsupported label type");
+            }
+        };
+
+        template <class L0, class... L>
+        struct chunked_axis_io<L0, L...>
+        {
+            template <class A>
+            static void write(std::ostream& out, const A& axis, std::size_t index)
+            {
+                if (index == 0)
+                {
+                    const auto& labels = get_labels<L0>(axis);
+                    write_size(out, labels.size());
+                    for (const auto& l : labels)
+                    {
+                        write_value(out, l);
+                    }
+                }
+                else
+                {
+                    chunked_axis_io<L...>::write(out, axis, index - 1);
+                }
+            }
+
+            template <class A>
+            static A read(std::istream& in, std::size_t index)
+            {
+                if (index == 0)
+                {
+                    using axis_type = xaxis<L0, typename A::mapped_type, typename A::map_container_tag>;
+                    typename axis_type::label_list labels(read_size(in));
+                    for (auto& l : labels)
+                    {
+                        l = read_value<L0>(in);
+                    }
+                    return A(axis_type(std::move(labels)));
+                }
+                else
+                {
+                    return chunked_axis_io<L...>::template read<A>(in, index - 1);
+                }
+            }
+        };
+
+        // Rank of the chunk grid and flat chunk count
+        inline std::size_t chunk_count(const std::vector<std::size_t>& shape,
+                                       const std::vector<std::size_t>& chunk_shape)
+        {
+            std::size_t res = 1;
+            for (std::size_t i = 0; i < shape.size(); ++i)
+            {
+                res *= (shape[i] + chunk_shape[i] - 1) / chunk_shape[i];
+            }
+            return res;
+        }
+
+        inline std::vector<std::size_t> chunk_index(std::size_t flat_index,
+                                                    const std::vector<std::size_t>& shape,
+                                                    const std::vector<std::size_t>& chunk_shape)
+        {
+            std::vector<std::size_t> res(shape.size());
+            for (std::size_t i = shape.size(); i != 0; --i)
+            {
+                std::size_t nb = (shape[i - 1] + chunk_shape[i - 1] - 1) / chunk_shape[i - 1];
+                res[i - 1] = flat_index % nb;
+                flat_index /= nb;
+            }
+            return res;
+        }
+
+        inline std::vector<std::size_t> chunk_extent(const std::vector<std::size_t>& index,
+                                                     const std::vector<std::size_t>& shape,
+                                                     const std::vector<std::size_t>& chunk_shape)
+        {
+            std::vector<std::size_t> res(shape.size());
+            for (std::size_t i = 0; i < shape.size(); ++i)
+            {
+                res[i] = std::min(chunk_shape[i], shape[i] - index[i] * chunk_shape[i]);
+            }
+            return res;
+        }
+
+        inline std::string chunk_path(const std::string& prefix, const std::vector<std::size_t>& index)
+        {
+            std::string res = prefix + ".c";
+            for (auto i : index)
+            {
+                res += '.' + std::to_string(i);
+            }
+            return res;
+        }
+
+        inline bool increment_chunk_index(std::vector<std::size_t>& index, const std::vector<std::size_t>& bounds)
+        {
+            std::size_t i = index.size();
+            while (i != 0)
+            {
+                --i;
+                if (++index[i] != bounds[i])
+                {
+                    return false;
+                }
+                index[i] = 0;
+            }
+            return true;
+        }
+
+        // Identifies the value type in the metadata, so that opening a
+        // variable with a type of the same size is detected
+        template <class T>
+        inline std::string chunked_type_tag()
+        {
+            static_assert(std::is_arithmetic<T>::value, "xchunked_store only stores arithmetic values");
+            char kind = std::is_same<T, bool>::value ? 'b' :
+                        std::is_floating_point<T>::value ? 'f' :
+                        std::is_signed<T>::value ? 'i' : 'u';
+            return kind + std::to_string(sizeof(T));
+        }
+
+        inline std::vector<std::size_t> chunk_grid(const std::vector<std::size_t>& shape,
+                                                   const std::vector<std::size_t>& chunk_shape)
+        {
+            std::vector<std::size_t> res(shape.size());
+            for (std::size_t i = 0; i < shape.size(); ++i)
+            {
+                res[i] = (shape[i] + chunk_shape[i] - 1) / chunk_shape[i];
+            }
+            return res;
+        }
+
+        constexpr const char chunked_store_magic[] = "XFCHUNK2";
+
+        // Reads the header of a metadata file, up to the number of chunks
+        // along each dimension; returns false if the stream does not hold
+        // chunked store metadata.
+        inline bool read_chunked_header(std::istream& in, std::string& type_tag, std::vector<std::size_t>& grid)
+        {
+            std::array<char, sizeof(chunked_store_magic) - 1> magic;
+            in.read(magic.data(), static_cast<std::streamsize>(magic.size()));
+            if (!in || !std::equal(magic.cbegin(), magic.cend(), chunked_store_magic))
+            {
+                return false;
+            }
+            type_tag = read_value<std::string>(in);
+            grid.resize(read_size(in));
+            for (auto& g : grid)
+            {
+                g = read_size(in);
+            }
+            return true;
+        }
+
+        // Removes the chunk files of a grid; missing files are ignored
+        inline void remove_chunks(const std::string& prefix, const std::vector<std::size_t>& grid)
+        {
+            if (std::find(grid.cbegin(), grid.cend(), std::size_t(0)) != grid.cend())
+            {
+                return;
+            }
+            std::vector<std::size_t> index(grid.size(), std::size_t(0));
+            do
+            {
+                std::remove(chunk_path(prefix, index).c_str());
+            }
+            while (!increment_chunk_index(index, grid));
+        }
+    }
+
+    /*********************************
+     * xchunked_store implementation *
+     *********************************/
+
+    /**
+     * Builds a store rooted in the specified directory. The directory
+     * must exist.
+     * @param directory the path of the directory holding the stored variables.
+     * @param nb_threads the number of threads used to read and write chunks. If
+     *                   it is 0, the number of hardware threads is used.
+     */
+    inline xchunked_store::xchunked_store(const std::string& directory, size_type nb_threads)
+        : m_directory(directory),
+          m_nb_threads(nb_threads != 0 ? nb_threads : std::max(size_type(std::thread::hardware_concurrency()), size_type(1)))
+    {
+    }
+
+    /**
+     * Returns the directory holding the stored variables.
+     */
+    inline auto xchunked_store::directory() const noexcept -> const std::string&
+    {
+        return m_directory;
+    }
+
+    /**
+     * Returns the number of threads used to read and write chunks.
+     */
+    inline auto xchunked_store::nb_threads() const noexcept -> size_type
+    {
+        return m_nb_threads;
+    }
+
+    /**
+     * Stores the specified variable. Any variable previously stored under the
+     * same name is overwritten.
+     * @param name the name of the variable in the store.
+     * @param variable the variable to store. Its data must be an optional assembly
+     *                 of containers.
+     * @param chunk_shape the shape of the chunks, following the order of the
+     *                    dimension mapping of the variable.
+     */
+    template <class V>
+    inline void xchunked_store::dump(const std::string& name, const V& variable, const chunk_shape_type& chunk_shape) const
+    {
+        using value_type = typename std::decay_t<decltype(variable.data().value())>::value_type;
+
+        const auto& dims = variable.dimension_mapping();
+        const auto& coords = variable.coordinates();
+        const auto& values = variable.data().value();
+        const auto& flags = variable.data().has_value();
+
+        std::size_t dimension = dims.size();
+        if (chunk_shape.size() != dimension ||
+            std::find(chunk_shape.cbegin(), chunk_shape.cend(), size_type(0)) != chunk_shape.cend())
+        {
+            throw std::runtime_error("xchunked_store: invalid chunk shape");
+        }
+
+        std::string prefix = path(name);
+        std::vector<std::size_t> shape(values.shape().cbegin(), values.shape().cend());
+        std::vector<std::size_t> grid = detail::chunk_grid(shape, chunk_shape);
+
+        // Chunks of a previous grid would not be overwritten
+        {
+            std::ifstream old_meta(prefix + ".meta", std::ios::binary);
+            std::string old_type_tag;
+            std::vector<std::size_t> old_grid;
+            if (old_meta && detail::read_chunked_header(old_meta, old_type_tag, old_grid) && old_grid != grid)
+            {
+                detail::remove_chunks(prefix, old_grid);
+            }
+        }
+
+        std::ofstream meta(prefix + ".meta", std::ios::binary);
+        if (!meta)
+        {
+            throw std::runtime_error("xchunked_store: cannot write " + prefix + ".meta");
+        }
+        meta.write(detail::chunked_store_magic, sizeof(detail::chunked_store_magic) - 1);
+        detail::write_value(meta, detail::chunked_type_tag<value_type>());
+        detail::write_size(meta, dimension);
+        for (auto g : grid)
+        {
+            detail::write_size(meta, g);
+        }
+        using io_type = xtl::mpl::cast_t<typename std::decay_t<decltype(coords)>::label_list, detail::chunked_axis_io>;
+        for (std::size_t d = 0; d < dimension; ++d)
+        {
+            const auto& dim_name = dims.labels()[d];
+            const auto& axis = coords[dim_name];
+            detail::write_value(meta, dim_name);
+            detail::write_size(meta, chunk_shape[d]);
+            std::size_t type_index = axis.labels().storage().index();
+            detail::write_size(meta, type_index);
+            io_type::write(meta, axis, type_index);
+        }
+        if (!meta)
+        {
+            throw std::runtime_error("xchunked_store: cannot write " + prefix + ".meta");
+        }
+
+        std::vector<std::size_t> strides(values.strides().cbegin(), values.strides().cend());
+        std::vector<std::size_t> flag_strides(flags.strides().cbegin(), flags.strides().cend());
+        const value_type* value_data = values.raw_data();
+        const auto& flag_data = flags.data();
+
+        detail::parallel_for(detail::chunk_count(shape, chunk_shape), m_nb_threads, [&](std::size_t i)
+        {
+            auto index = detail::chunk_index(i, shape, chunk_shape);
+            auto extent = detail::chunk_extent(index, shape, chunk_shape);
+            std::size_t size = std::accumulate(extent.cbegin(), extent.cend(), std::size_t(1), std::multiplies<std::size_t>());
+
+            std::vector<value_type> chunk_values(size);
+            std::vector<std::uint8_t> chunk_flags(size);
+            std::vector<std::size_t> pos(dimension, std::size_t(0));
+            for (std::size_t j = 0; j < size; ++j)
+            {
+                std::size_t offset = 0;
+                std::size_t flag_offset = 0;
+                for (std::size_t d = 0; d < dimension; ++d)
+                {
+                    std::size_t k = index[d] * chunk_shape[d] + pos[d];
+                    offset += k * strides[d];
+                    flag_offset += k * flag_strides[d];
+                }
+                chunk_values[j] = value_data[offset];
+                chunk_flags[j] = flag_data[flag_offset] ? std::uint8_t(1) : std::uint8_t(0);
+                detail::increment_chunk_index(pos, extent);
+            }
+
+            std::string chunk_file = detail::chunk_path(prefix, index);
+            std::ofstream out(chunk_file, std::ios::binary);
+            detail::write_buffer(out, xchunk_codec::encode(chunk_values.data(), size));
+            detail::write_buffer(out, xchunk_codec::encode(chunk_flags.data(), size));
+            if (!out)
+            {
+                throw std::runtime_error("xchunked_store: cannot write " + chunk_file);
+            }
+        });
+    }
+
+    /**
+     * Opens the variable stored under the specified name. Only the metadata
+     * is read, chunks are fetched upon request.
+     * @param name the name of the variable in the store.
+     * @tparam T the value type of the stored variable.
+     * @tparam C the coordinate type of the stored variable.
+     */
+    template <class T, class C>
+    inline xchunked_variable<T, C> xchunked_store::open(const std::string& name) const
+    {
+        using variable_type = xchunked_variable<T, C>;
+        using coordinate_type = typename variable_type::coordinate_type;
+        using dimension_type = typename variable_type::dimension_type;
+        using key_type = typename variable_type::key_type;
+        using shape_type = typename variable_type::shape_type;
+        using map_type = typename coordinate_type::map_type;
+        using axis_type = typename coordinate_type::axis_type;
+        using io_type = xtl::mpl::cast_t<typename coordinate_type::label_list, detail::chunked_axis_io>;
+
+        std::string prefix = path(name);
+        std::ifstream meta(prefix + ".meta", std::ios::binary);
+        if (!meta)
+        {
+            throw std::runtime_error("xchunked_store: cannot read " + prefix + ".meta");
+        }
+        std::string type_tag;
+        std::vector<std::size_t> grid;
+        if (!detail::read_chunked_header(meta, type_tag, grid))
+        {
+            throw std::runtime_error("xchunked_store: " + prefix + ".meta is not a chunked store metadata file");
+        }
+        if (type_tag != detail::chunked_type_tag<T>())
+        {
+            throw std::runtime_error("xchunked_store: value type mismatch for " + name + ", stored as " + type_tag);
+        }
+
+        std::size_t dimension = grid.size();
+        map_type coord_map;
+        typename dimension_type::label_list dim_labels;
+        shape_type shape;
+        shape_type chunk_shape;
+        for (std::size_t d = 0; d < dimension; ++d)
+        {
+            key_type dim_name = detail::read_value<key_type>(meta);
+            chunk_shape.push_back(detail::read_size(meta));
+            std::size_t type_index = detail::read_size(meta);
+            axis_type axis = io_type::template read<axis_type>(meta, type_index);
+            shape.push_back(axis.size());
+            coord_map.emplace(dim_name, std::move(axis));
+            dim_labels.push_back(std::move(dim_name));
+        }
+
+        return variable_type(prefix, coordinate_type(std::move(coord_map)), dimension_type(std::move(dim_labels)),
+                             std::move(shape), std::move(chunk_shape), m_nb_threads);
+    }
+
+    /**
+     * Removes the variable stored under the specified name, if any.
+     * @param name the name of the variable in the store.
+     */
+    inline void xchunked_store::remove(const std::string& name) const
+    {
+        std::string prefix = path(name);
+        std::vector<std::size_t> grid;
+        {
+            std::ifstream meta(prefix + ".meta", std::ios::binary);
+            std::string type_tag;
+            if (!meta || !detail::read_chunked_header(meta, type_tag, grid))
+            {
+                return;
+            }
+        }
+        detail::remove_chunks(prefix, grid);
+        std::remove((prefix + ".meta").c_str());
+    }
+
+    inline std::string xchunked_store::path(const std::string& name) const
+    {
+        return m_directory.empty() ? name : m_directory + '/' + name;
+    }
+
+    /**
+     * Builds and returns a store rooted in the specified directory.
+     * @param directory the path of the directory holding the stored variables.
+     * @param nb_threads the number of threads used to read and write chunks.
+     */
+    inline xchunked_store chunked_store(const std::string& directory, std::size_t nb_threads)
+    {
+        return xchunked_store(directory, nb_threads);
+    }
+
+    /************************************
+     * xchunked_variable implementation *
+     ************************************/
+
+    template <class T, class C>
+    inline xchunked_variable<T, C>::xchunked_variable(std::string prefix, coordinate_type&& coords, dimension_type&& dims,
+                                                      shape_type&& shape, shape_type&& chunk_shape, std::size_t nb_threads)
+        : m_prefix(std::move(prefix)),
+          m_coordinate(std::move(coords)),
+          m_dimension_mapping(std::move(dims)),
+          m_shape(std::move(shape)),
+          m_chunk_shape(std::move(chunk_shape)),
+          m_nb_threads(nb_threads)
+    {
+    }
+
+    /**
+     * Returns the coordinates of the stored variable.
+     */
+    template <class T, class C>
+    inline auto xchunked_variable<T, C>::coordinates() const noexcept -> const coordinate_type&
+    {
+        return m_coordinate;
+    }
+
+    /**
+     * Returns the dimension mapping of the stored variable.
+     */
+    template <class T, class C>
+    inline auto xchunked_variable<T, C>::dimension_mapping() const noexcept -> const dimension_type&
+    {
+        return m_dimension_mapping;
+    }
+
+    /**
+     * Returns the shape of the stored variable.
+     */
+    template <class T, class C>
+    inline auto xchunked_variable<T, C>::shape() const noexcept -> const shape_type&
+    {
+        return m_shape;
+    }
+
+    /**
+     * Returns the shape of the chunks of the stored variable.
+     */
+    template <class T, class C>
+    inline auto xchunked_variable<T, C>::chunk_shape() const noexcept -> const shape_type&
+    {
+        return m_chunk_shape;
+    }
+
+    /**
+     * Returns the number of chunks of the stored variable.
+     */
+    template <class T, class C>
+    inline auto xchunked_variable<T, C>::nb_chunks() const noexcept -> size_type
+    {
+        return detail::chunk_count(m_shape, m_chunk_shape);
+    }
+
+    /**
+     * Reads all the chunks and returns the stored variable.
+     */
+    template <class T, class C>
+    inline auto xchunked_variable<T, C>::load() const -> variable_type
+    {
+        return select(slice_map());
+    }
+
+    /**
+     * Reads the part of the stored variable selected by the specified slices.
+     * Only the chunks intersecting the selection are read. Squeezed dimensions
+     * are dropped from the result, and the labels of sliced dimensions are kept
+     * in the order of the stored axis; a label selected several times appears
+     * once in the result.
+     * @param slices the mapping of dimension names to label slices. Dimensions
+     *               missing from this mapping are entirely selected.
+     */
+    template <class T, class C>
+    inline auto xchunked_variable<T, C>::select(const slice_map& slices) const -> variable_type
+    {
+        using map_type = typename coordinate_type::map_type;
+        using axis_type = typename coordinate_type::axis_type;
+        using index_list = std::vector<std::size_t>;
+
+        // entry of a chunk group: position in the output, position in the chunk
+        using group_entry = std::pair<std::size_t, std::size_t>;
+        struct chunk_group
+        {
+            std::size_t m_chunk;
+            std::vector<group_entry> m_entries;
+        };
+
+        std::size_t dimension = m_dimension_mapping.size();
+        map_type coord_map;
+        typename dimension_type::label_list dim_labels;
+        std::vector<bool> squeezed(dimension, false);
+        std::vector<std::vector<chunk_group>> groups(dimension);
+
+        for (std::size_t d = 0; d < dimension; ++d)
+        {
+            const auto& dim_name = m_dimension_mapping.labels()[d];
+            const auto& axis = m_coordinate[dim_name];
+            index_list indices;
+            auto iter = slices.find(dim_name);
+            if (iter == slices.end())
+            {
+                indices.resize(axis.size());
+                std::iota(indices.begin(), indices.end(), std::size_t(0));
+                coord_map.emplace(dim_name, axis);
+                dim_labels.push_back(dim_name);
+            }
+            else if (auto* sq = (iter->second).get_squeeze())
+            {
+                indices.push_back(static_cast<std::size_t>(axis[*sq]));
+                squeezed[d] = true;
+            }
+            else
+            {
+                auto idx_slice = (iter->second).build_index_slice(axis);
+                indices.resize(idx_slice.size());
+                for (std::size_t i = 0; i < indices.size(); ++i)
+                {
+                    indices[i] = static_cast<std::size_t>(idx_slice(static_cast<typename axis_type::mapped_type>(i)));
+                }
+                std::sort(indices.begin(), indices.end());
+                indices.erase(std::unique(indices.begin(), indices.end()), indices.end());
+                // The axis is built from the sorted positions so that its labels
+                // match the order in which the chunks are gathered.
+                using keep_type = xt::xkeep_slice<typename axis_type::mapped_type>;
+                typename keep_type::container_type positions(indices.size());
+                std::transform(indices.cbegin(), indices.cend(), positions.begin(),
+                               [](std::size_t i) { return static_cast<typename axis_type::mapped_type>(i); });
+                keep_type kept(std::move(positions));
+                kept.normalize(axis.size());
+                coord_map.emplace(dim_name, axis_type(xaxis_view<label_list, typename axis_type::mapped_type,
+                                                                 typename axis_type::map_container_tag>(axis, std::move(kept))));
+                dim_labels.push_back(dim_name);
+            }
+
+            std::size_t out_pos = 0;
+            for (auto idx : indices)
+            {
+                std::size_t chunk = idx / m_chunk_shape[d];
+                if (groups[d].empty() || groups[d].back().m_chunk != chunk)
+                {
+                    groups[d].push_back(chunk_group{chunk, {}});
+                }
+                groups[d].back().m_entries.emplace_back(out_pos++, idx - chunk * m_chunk_shape[d]);
+            }
+        }
+
+        variable_type res(coordinate_type(std::move(coord_map)), dimension_type(std::move(dim_labels)));
+        if (res.data().value().size() == 0)
+        {
+            return res;
+        }
+
+        auto& values = res.data().value();
+        auto& flags = res.data().has_value();
+        std::vector<std::size_t> out_strides(dimension, std::size_t(0));
+        std::vector<std::size_t> out_flag_strides(dimension, std::size_t(0));
+        for (std::size_t d = 0, j = 0; d < dimension; ++d)
+        {
+            if (!squeezed[d])
+            {
+                out_strides[d] = static_cast<std::size_t>(values.strides()[j]);
+                out_flag_strides[d] = static_cast<std::size_t>(flags.strides()[j]);
+                ++j;
+            }
+        }
+        T* value_data = values.raw_data();
+        bool* flag_data = flags.raw_data();
+
+        std::vector<std::size_t> group_bounds(dimension);
+        std::transform(groups.cbegin(), groups.cend(), group_bounds.begin(), [](const auto& g) { return g.size(); });
+        std::size_t nb_tasks = std::accumulate(group_bounds.cbegin(), group_bounds.cend(), std::size_t(1), std::multiplies<std::size_t>());
+
+        detail::parallel_for(nb_tasks, m_nb_threads, [&](std::size_t task)
+        {
+            auto group_index = detail::chunk_index(task, group_bounds, index_list(dimension, std::size_t(1)));
+            index_list chunk(dimension);
+            index_list entry_bounds(dimension);
+            for (std::size_t d = 0; d < dimension; ++d)
+            {
+                const auto& group = groups[d][group_index[d]];
+                chunk[d] = group.m_chunk;
+                entry_bounds[d] = group.m_entries.size();
+            }
+
+            auto extent = detail::chunk_extent(chunk, m_shape, m_chunk_shape);
+            std::size_t size = std::accumulate(extent.cbegin(), extent.cend(), std::size_t(1), std::multiplies<std::size_t>());
+            index_list chunk_strides(dimension);
+            std::size_t stride = 1;
+            for (std::size_t d = dimension; d != 0; --d)
+            {
+                chunk_strides[d - 1] = stride;
+                stride *= extent[d - 1];
+            }
+
+            std::string chunk_file = detail::chunk_path(m_prefix, chunk);
+            std::ifstream in(chunk_file, std::ios::binary);
+            if (!in)
+            {
+                throw std::runtime_error("xchunked_store: cannot read " + chunk_file);
+            }
+            std::vector<T> chunk_values(size);
+            std::vector<std::uint8_t> chunk_flags(size);
+            xchunk_codec::decode(detail::read_buffer(in), chunk_values.data(), size);
+            xchunk_codec::decode(detail::read_buffer(in), chunk_flags.data(), size);
+
+            index_list pos(dimension, std::size_t(0));
+            do
+            {
+                std::size_t src = 0;
+                std::size_t dst = 0;
+                std::size_t flag_dst = 0;
+                for (std::size_t d = 0; d < dimension; ++d)
+                {
+                    const group_entry& e = groups[d][group_index[d]].m_entries[pos[d]];
+                    src += e.second * chunk_strides[d];
+                    dst += e.first * out_strides[d];
+                    flag_dst += e.first * out_flag_strides[d];
+                }
+                value_data[dst] = chunk_values[src];
+                flag_data[flag_dst] = chunk_flags[src] != std::uint8_t(0);
+            }
+            while (!detail::increment_chunk_index(pos, entry_bounds));
+        });
+
+        return res;
+    }
+
+    /**
+     * Reads the part of the stored variable selected by the specified slices.
+     * The slices are given in the order of the dimension mapping.
+     * @param slices the label slices.
+     * @sa select
+     */
+    template <class T, class C>
+    template <class... S>
+    inline auto xchunked_variable<T, C>::locate(S&&... slices) const -> variable_type
+    {
+        if (sizeof...(S) > m_dimension_mapping.size())
+        {
+            throw std::runtime_error("xchunked_variable: too many slices");
+        }
+        std::array<slice_type, sizeof...(S)> sl = { slice_type(std::forward<S>(slices))... };
+        slice_map m;
+        for (std::size_t i = 0; i < sl.size(); ++i)
+        {
+            m.emplace(m_dimension_mapping.labels()[i], std::move(sl[i]));
+        }
+        return select(m);
+    }
+}
+
+#endif
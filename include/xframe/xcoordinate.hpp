@@ -37,6 +37,9 @@ namespace xf
 
     class xfull_coordinate {};
 
+    template <class C>
+    class xcoordinate_expanded;
+
     struct xtrivial_broadcast
     {
         xtrivial_broadcast() = default;
@@ -105,9 +108,14 @@ namespace xf
     private:
 
         using coordinate_view_type = xcoordinate_view<K, L, S, MT>;
+        using coordinate_expanded_type = xcoordinate_expanded<self_type>;
 
-        template <class Join, class... Args>
-        xtrivial_broadcast broadcast_impl(const self_type& c, const Args&... coordinates);
+        template <class C>
+        using owns_axes = std::integral_constant<bool, std::is_same<C, self_type>::value ||
+                                                       std::is_same<C, coordinate_expanded_type>::value>;
+
+        template <class Join, class C, class... Args>
+        xtrivial_broadcast broadcast_impl(const C& c, const Args&... coordinates);
         template <class Join, class... Args>
         xtrivial_broadcast broadcast_impl(const coordinate_view_type& c, const Args&... coordinates);
         template <class Join, class... Args>
@@ -115,8 +123,8 @@ namespace xf
         template <class Join>
         xtrivial_broadcast broadcast_impl();
 
-        template <class Join, class... Args>
-        xtrivial_broadcast broadcast_empty(const self_type& c, const Args&... coordinates);
+        template <class Join, class C, class... Args>
+        xtrivial_broadcast broadcast_empty(const C& c, const Args&... coordinates);
         template <class Join, class... Args>
         xtrivial_broadcast broadcast_empty(const coordinate_view_type& c, const Args&... coordinates);
         template <class Join, class... Args>
@@ -148,9 +156,6 @@ namespace xf
     template <class C>
     class xcoordinate_chain;
 
-    template <class C>
-    class xcoordinate_expanded;
-
     namespace detail
     {
         template <class T>
@@ -336,12 +341,16 @@ namespace xf
         };
     }
 
+    // Coordinates holding their axes, that is xcoordinate objects and the
+    // expanded coordinates of expand_dims views, are broadcast by inserting
+    // their axes; views and full coordinates have dedicated overloads.
     template <class K, class L, class S, class MT>
-    template <class Join, class... Args>
-    inline xtrivial_broadcast xcoordinate<K, L, S, MT>::broadcast_impl(const self_type& c, const Args&... coordinates)
+    template <class Join, class C, class... Args>
+    inline xtrivial_broadcast xcoordinate<K, L, S, MT>::broadcast_impl(const C& c, const Args&... coordinates)
     {
+        static_assert(owns_axes<C>::value, "unsupported coordinate type");
         auto res = broadcast_impl<Join>(coordinates...);
-        XFRAME_TRACE_BROADCAST_COORDINATES(*this, c);
+        XFRAME_TRACE_SPAN(span, "broadcast_coordinates")
         for(auto iter = c.begin(); iter != c.end(); ++iter)
         {
             auto inserted = this->coordinate().insert(*iter);
@@ -356,7 +365,8 @@ namespace xf
             }
         }
         res.m_same_dimensions &= (this->size() == c.size());
-        XFRAME_TRACE_COORDINATES_RESULT(*this, res);
+        XFRAME_TRACE_SPAN_SIZE(span, this->size())
+        XFRAME_TRACE_SPAN_SLOW_PATH(span, !res.m_same_labels)
         return res;
     }
 
@@ -365,7 +375,7 @@ namespace xf
     inline xtrivial_broadcast xcoordinate<K, L, S, MT>::broadcast_impl(const coordinate_view_type& c, const Args&... coordinates)
     {
         auto res = broadcast_impl<Join>(coordinates...);
-        XFRAME_TRACE_BROADCAST_COORDINATES(*this, c);
+        XFRAME_TRACE_SPAN(span, "broadcast_coordinates")
         for (auto iter = c.begin(); iter != c.end(); ++iter)
         {
             mapped_type axis = mapped_type(iter->second);
@@ -381,7 +391,8 @@ namespace xf
             }
         }
         res.m_same_dimensions &= (this->size() == c.size());
-        XFRAME_TRACE_COORDINATES_RESULT(*this, res);
+        XFRAME_TRACE_SPAN_SIZE(span, this->size())
+        XFRAME_TRACE_SPAN_SLOW_PATH(span, !res.m_same_labels)
         return res;
     }
 
@@ -400,11 +411,12 @@ namespace xf
     }
 
     template <class K, class L, class S, class MT>
-    template <class Join, class... Args>
-    inline xtrivial_broadcast xcoordinate<K, L, S, MT>::broadcast_empty(const self_type& c, const Args&... coordinates)
+    template <class Join, class C, class... Args>
+    inline xtrivial_broadcast xcoordinate<K, L, S, MT>::broadcast_empty(const C& c, const Args&... coordinates)
     {
+        static_assert(owns_axes<C>::value, "unsupported coordinate type");
         map_type& m = this->coordinate();
-        for (auto iter = c.data().cbegin(); iter != c.data().cend(); ++iter)
+        for (auto iter = c.cbegin(); iter != c.cend(); ++iter)
         {
             m.insert(std::make_pair(iter->first, mapped_type(iter->second.as_xaxis())));
         }
@@ -9,7 +9,10 @@
 #ifndef XFRAME_XCOORDINATE_BASE_HPP
 #define XFRAME_XCOORDINATE_BASE_HPP
 
+#include <atomic>
+#include <cstddef>
 #include <map>
+#include <type_traits>
 
 #include "xtl/xiterator_base.hpp"
 #include "xaxis_variant.hpp"
@@ -66,6 +69,7 @@ namespace xf
         index_type operator[](const std::pair<KB, LB>& key) const;
 
         const map_type& data() const noexcept;
+        std::size_t stamp() const noexcept;
 
         const_iterator find(const key_type& key) const;
 
@@ -91,14 +95,15 @@ namespace xf
         xcoordinate_base(const xcoordinate_base&) = default;
         xcoordinate_base& operator=(const xcoordinate_base&) = default;
 
-        xcoordinate_base(xcoordinate_base&&) = default;
-        xcoordinate_base& operator=(xcoordinate_base&&) = default;
+        xcoordinate_base(xcoordinate_base&& rhs) noexcept(std::is_nothrow_move_constructible<map_type>::value);
+        xcoordinate_base& operator=(xcoordinate_base&& rhs);
 
         map_type& coordinate() noexcept;
 
     private:
 
         map_type m_coordinate;
+        std::size_t m_stamp;
     };
 
     template <class K, class A1, class A2>
@@ -114,29 +119,54 @@ namespace xf
      * xcoordinate_base implementation *
      ***********************************/
 
+    namespace detail
+    {
+        inline std::size_t next_coordinate_stamp() noexcept
+        {
+            static std::atomic<std::size_t> stamp(0);
+            return stamp.fetch_add(1, std::memory_order_relaxed) + 1;
+        }
+    }
+
     template <class K, class A>
     inline xcoordinate_base<K, A>::xcoordinate_base(const map_type& axes)
-        : m_coordinate(axes)
+        : m_coordinate(axes), m_stamp(detail::next_coordinate_stamp())
     {
     }
 
     template <class K, class A>
     inline xcoordinate_base<K, A>::xcoordinate_base(map_type&& axes)
-        : m_coordinate(std::move(axes))
+        : m_coordinate(std::move(axes)), m_stamp(detail::next_coordinate_stamp())
     {
     }
 
     template <class K, class A>
     inline xcoordinate_base<K, A>::xcoordinate_base(std::initializer_list<value_type> init)
-        : m_coordinate(init)
+        : m_coordinate(init), m_stamp(detail::next_coordinate_stamp())
     {
     }
 
     template <class K, class A>
     template <class... AX>
     inline xcoordinate_base<K, A>::xcoordinate_base(std::pair<K, AX>... axes)
-        : m_coordinate({std::move(axes)...})
+        : m_coordinate({std::move(axes)...}), m_stamp(detail::next_coordinate_stamp())
+    {
+    }
+
+    template <class K, class A>
+    inline xcoordinate_base<K, A>::xcoordinate_base(xcoordinate_base&& rhs) noexcept(std::is_nothrow_move_constructible<map_type>::value)
+        : m_coordinate(std::move(rhs.m_coordinate)), m_stamp(rhs.m_stamp)
+    {
+        rhs.m_stamp = detail::next_coordinate_stamp();
+    }
+
+    template <class K, class A>
+    inline auto xcoordinate_base<K, A>::operator=(xcoordinate_base&& rhs) -> xcoordinate_base&
     {
+        m_coordinate = std::move(rhs.m_coordinate);
+        m_stamp = rhs.m_stamp;
+        rhs.m_stamp = detail::next_coordinate_stamp();
+        return *this;
     }
 
     /**
@@ -286,21 +316,39 @@ namespace xf
         return key_iterator(end());
     }
 
+    /**
+     * Returns the stamp of the coordinates. Copies of a coordinate object
+     * share its stamp, while constructing or modifying coordinates gives them
+     * a new one; two coordinate objects with the same stamp hold the same axes.
+     */
+    template <class K, class A>
+    inline std::size_t xcoordinate_base<K, A>::stamp() const noexcept
+    {
+        return m_stamp;
+    }
+
     template <class K, class A>
     inline auto xcoordinate_base<K, A>::coordinate() noexcept -> map_type&
     {
+        m_stamp = detail::next_coordinate_stamp();
         return m_coordinate;
     }
 
     /**
      * Returns true if \c lhs and \c rhs are equivalent coordinates, i.e. they hold the same
-     * axes mapped to the same dimension names.
+     * axes mapped to the same dimension names. Coordinates sharing their
+     * stamp are equivalent without comparing their axes.
      * @param lhs a coordinate object.
      * @param rhs a coordinate object.
      */
     template <class K, class A1, class A2>
     inline bool operator==(const xcoordinate_base<K, A1>& lhs, const xcoordinate_base<K, A2>& rhs)
     {
+        if (lhs.stamp() == rhs.stamp())
+        {
+            return true;
+        }
+
         bool res = lhs.size() == rhs.size();
 
         auto liter = lhs.cbegin();
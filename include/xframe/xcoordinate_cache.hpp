@@ -0,0 +1,209 @@
+/***************************************************************************
+* Copyright (c) 2017, Johan Mabille, Sylvain Corlay and Wolf Vollprecht    *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XFRAME_XCOORDINATE_CACHE_HPP
+#define XFRAME_XCOORDINATE_CACHE_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "xcoordinate.hpp"
+#include "xframe_config.hpp"
+#include "xframe_counters.hpp"
+
+namespace xf
+{
+
+    /*********************
+     * xcoordinate_cache *
+     *********************/
+
+    /**
+     * @class xcoordinate_cache
+     * @brief Process-wide cache of broadcast coordinates.
+     *
+     * The xcoordinate_cache class maps the stamps of the coordinates of the
+     * operands of an expression and the join type to the result of their
+     * broadcast, so that expressions repeatedly built on the same operands
+     * do not merge nor intersect their axes again. Since any modification
+     * of coordinates renews their stamp, entries never become stale; the
+     * oldest ones are evicted once \c N entries are stored.
+     *
+     * Lookups take a lock and scan the entries linearly, which every new
+     * expression pays even on a miss; the cache used by the functions is
+     * therefore disabled unless XFRAME_COORDINATE_CACHE_SIZE is set.
+     *
+     * @tparam C the coordinate type.
+     * @tparam N the maximal number of entries, 0 disabling the cache.
+     */
+    template <class C, std::size_t N = XFRAME_COORDINATE_CACHE_SIZE>
+    class xcoordinate_cache
+    {
+    public:
+
+        using coordinate_type = C;
+        using key_type = std::vector<std::size_t>;
+        using size_type = std::size_t;
+
+        static xcoordinate_cache& instance();
+
+        bool find(const key_type& key, coordinate_type& coords, xtrivial_broadcast& trivial) const;
+        void insert(key_type key, const coordinate_type& coords, const xtrivial_broadcast& trivial);
+
+        size_type size() const;
+        void clear();
+
+    private:
+
+        xcoordinate_cache() = default;
+
+        struct entry
+        {
+            key_type m_key;
+            coordinate_type m_coordinate;
+            xtrivial_broadcast m_trivial;
+        };
+
+        mutable std::mutex m_mutex;
+        std::vector<entry> m_entries;
+        size_type m_next = 0;
+    };
+
+    namespace detail
+    {
+        template <class Join>
+        std::vector<std::size_t> make_coordinate_cache_key();
+
+        template <class K, class L, class S, class MT>
+        bool add_coordinate_stamp(std::vector<std::size_t>& key, const xcoordinate<K, L, S, MT>& c);
+
+        bool add_coordinate_stamp(std::vector<std::size_t>& key, const xfull_coordinate& c);
+
+        template <class C>
+        bool add_coordinate_stamp(std::vector<std::size_t>& key, const C& c);
+    }
+
+    /************************************
+     * xcoordinate_cache implementation *
+     ************************************/
+
+    /**
+     * Returns the cache of broadcast coordinates of type \c C.
+     */
+    template <class C, std::size_t N>
+    inline auto xcoordinate_cache<C, N>::instance() -> xcoordinate_cache&
+    {
+        static xcoordinate_cache cache;
+        return cache;
+    }
+
+    /**
+     * Looks for the broadcast coordinates matching \c key.
+     * @param key the join identifier followed by the stamps of the operands.
+     * @param coords the coordinates receiving the cached result.
+     * @param trivial the flags receiving the cached trivial broadcast.
+     * @return true if \c key was found.
+     */
+    template <class C, std::size_t N>
+    inline bool xcoordinate_cache<C, N>::find(const key_type& key, coordinate_type& coords, xtrivial_broadcast& trivial) const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto iter = std::find_if(m_entries.cbegin(), m_entries.cend(), [&key](const entry& e) { return e.m_key == key; });
+        if (iter == m_entries.cend())
+        {
+            return false;
+        }
+        coords = iter->m_coordinate;
+        trivial = iter->m_trivial;
+        XFRAME_COUNT(m_coordinate_cache_hits)
+        return true;
+    }
+
+    /**
+     * Stores the result of a broadcast, evicting the oldest entry if
+     * the cache is full.
+     */
+    template <class C, std::size_t N>
+    inline void xcoordinate_cache<C, N>::insert(key_type key, const coordinate_type& coords, const xtrivial_broadcast& trivial)
+    {
+        constexpr size_type capacity = N;
+        if (capacity == 0)
+        {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(m_mutex);
+        entry e = {std::move(key), coords, trivial};
+        if (m_entries.size() < capacity)
+        {
+            m_entries.push_back(std::move(e));
+        }
+        else
+        {
+            m_entries[m_next] = std::move(e);
+            m_next = (m_next + 1) % m_entries.size();
+        }
+    }
+
+    /**
+     * Returns the number of entries in the cache.
+     */
+    template <class C, std::size_t N>
+    inline auto xcoordinate_cache<C, N>::size() const -> size_type
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_entries.size();
+    }
+
+    /**
+     * Removes all the entries of the cache.
+     */
+    template <class C, std::size_t N>
+    inline void xcoordinate_cache<C, N>::clear()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_entries.clear();
+        m_next = 0;
+    }
+
+    namespace detail
+    {
+        template <class Join>
+        inline std::vector<std::size_t> make_coordinate_cache_key()
+        {
+            std::vector<std::size_t> key;
+            key.reserve(4);
+            key.push_back(static_cast<std::size_t>(Join::id()));
+            return key;
+        }
+
+        template <class K, class L, class S, class MT>
+        inline bool add_coordinate_stamp(std::vector<std::size_t>& key, const xcoordinate<K, L, S, MT>& c)
+        {
+            key.push_back(c.stamp());
+            return true;
+        }
+
+        inline bool add_coordinate_stamp(std::vector<std::size_t>& /*key*/, const xfull_coordinate& /*c*/)
+        {
+            return true;
+        }
+
+        // Coordinate views and chains refer to axes they do not own:
+        // their result cannot be cached.
+        template <class C>
+        inline bool add_coordinate_stamp(std::vector<std::size_t>& /*key*/, const C& /*c*/)
+        {
+            return false;
+        }
+    }
+}
+
+#endif
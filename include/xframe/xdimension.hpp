@@ -238,9 +238,10 @@ namespace xf
     template <class... Args>
     inline bool xdimension<L, T>::broadcast_impl(const self_type& a, const Args&... dims)
     {
-        XFRAME_TRACE_BROADCAST_DIMENSIONS(*this, a);
+        XFRAME_TRACE_SPAN(span, "broadcast_dimensions")
         bool res = base_type::merge_unsorted(true, a.labels());
-        XFRAME_TRACE_DIMENSIONS_RESULT(*this, res);
+        XFRAME_TRACE_SPAN_SIZE(span, this->size())
+        XFRAME_TRACE_SPAN_SLOW_PATH(span, !res)
         res &= broadcast_impl(dims...);
         return res;
     }
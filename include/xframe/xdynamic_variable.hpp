@@ -9,6 +9,8 @@
 #ifndef XFRAME_XDYNAMIC_VARIABLE_HPP
 #define XFRAME_XDYNAMIC_VARIABLE_HPP
 
+#include <stdexcept>
+
 #include "xdynamic_variable_impl.hpp"
 
 namespace xf
@@ -135,6 +137,18 @@ namespace xf
         template <std::size_t N = dynamic()>
         const_reference iselect(iselector_sequence_type<N>&& sel) const;
 
+        template <class V>
+        V* get_if() noexcept;
+
+        template <class V>
+        const V* get_if() const noexcept;
+
+        template <class V0, class... V, class F>
+        auto visit(F&& f) -> decltype(f(std::declval<V0&>()));
+
+        template <class V0, class... V, class F>
+        auto visit(F&& f) const -> decltype(f(std::declval<const V0&>()));
+
         std::ostream& print(std::ostream& out) const;
 
     private:
@@ -391,6 +405,106 @@ namespace xf
         return p_wrapper->template iselect<N>(std::move(sel));
     }
 
+    /**
+     * Returns a pointer to the wrapped variable if its type is \c V,
+     * nullptr otherwise. Once the type is known, the variable can be
+     * accessed as a whole, e.g. through its data or its steppers, without
+     * any virtual call per element.
+     * @tparam V the expected type of the wrapped variable.
+     */
+    template <class C, class DM, class T>
+    template <class V>
+    inline V* xdynamic_variable<C, DM, T>::get_if() noexcept
+    {
+        auto* impl = dynamic_cast<xvariable_wrapper_impl<V, T>*>(p_wrapper);
+        return impl != nullptr ? &(impl->get_variable()) : nullptr;
+    }
+
+    /**
+     * Returns a constant pointer to the wrapped variable if its type
+     * is \c V, nullptr otherwise.
+     * @tparam V the expected type of the wrapped variable.
+     */
+    template <class C, class DM, class T>
+    template <class V>
+    inline const V* xdynamic_variable<C, DM, T>::get_if() const noexcept
+    {
+        const auto* impl = dynamic_cast<const xvariable_wrapper_impl<V, T>*>(p_wrapper);
+        return impl != nullptr ? &(impl->get_variable()) : nullptr;
+    }
+
+    namespace detail
+    {
+        template <class R, class... V>
+        struct xdynamic_visitor;
+
+        template <class R, class V0, class... V>
+        struct xdynamic_visitor<R, V0, V...>
+        {
+            template <class D, class F>
+            static R apply(D& variable, F&& f)
+            {
+                auto* v = variable.template get_if<V0>();
+                if (v != nullptr)
+                {
+                    return f(*v);
+                }
+                return xdynamic_visitor<R, V...>::apply(variable, std::forward<F>(f));
+            }
+        };
+
+        template <class R>
+        struct xdynamic_visitor<R>
+        {
+            template <class D, class F>
+            static R apply(D& /*variable*/, F&& /*f*/)
+            {
+                throw std::runtime_error("xdynamic_variable: the wrapped variable has none of the visited types");
+            }
+        };
+    }
+
+    /**
+     * Calls \c f with the wrapped variable, cast to the first type among
+     * \c V0, \c V... matching its dynamic type. The type is resolved once,
+     * then \c f runs on the concrete variable. Throws if none of the types
+     * match.
+     * Example:
+     * \code{.cpp}
+     * auto dv = make_dynamic(v);
+     * double sum = dv.visit<double_variable, int_variable>([](const auto& var)
+     * {
+     *     return double(xt::sum(var.data().value())());
+     * });
+     * \endcode
+     * @param f the function to call.
+     * @tparam V0, V the candidate types of the wrapped variable.
+     * @return the result of \c f.
+     */
+    template <class C, class DM, class T>
+    template <class V0, class... V, class F>
+    inline auto xdynamic_variable<C, DM, T>::visit(F&& f) -> decltype(f(std::declval<V0&>()))
+    {
+        using result_type = decltype(f(std::declval<V0&>()));
+        return detail::xdynamic_visitor<result_type, V0, V...>::apply(*this, std::forward<F>(f));
+    }
+
+    /**
+     * Calls \c f with the wrapped variable, cast to the first type among
+     * \c V0, \c V... matching its dynamic type. Throws if none of the
+     * types match.
+     * @param f the function to call.
+     * @tparam V0, V the candidate types of the wrapped variable.
+     * @return the result of \c f.
+     */
+    template <class C, class DM, class T>
+    template <class V0, class... V, class F>
+    inline auto xdynamic_variable<C, DM, T>::visit(F&& f) const -> decltype(f(std::declval<const V0&>()))
+    {
+        using result_type = decltype(f(std::declval<const V0&>()));
+        return detail::xdynamic_visitor<result_type, V0, V...>::apply(*this, std::forward<F>(f));
+    }
+
     template <class C, class DM, class T>
     inline std::ostream& xdynamic_variable<C, DM, T>::print(std::ostream& out) const
     {
@@ -280,15 +280,15 @@ namespace xf
 
         std::ostream& print(std::ostream& out) const override;
 
+        variable_type& get_variable();
+        const variable_type& get_variable() const;
+
     protected:
 
         xvariable_wrapper_impl(const variable_type& variable);
         xvariable_wrapper_impl(variable_type&& variable);
         xvariable_wrapper_impl(const self_type& rhs) = default;
 
-        variable_type& get_variable();
-        const variable_type& get_variable() const;
-
     private:
 
         variable_type m_variable;
@@ -33,7 +33,8 @@ namespace xf
     struct xvariable_inner_types<xexpand_dims_view<CT>>
     {
         using xexpression_type = std::decay_t<CT>;
-        using data_type = xt::xstrided_view<typename xexpression_type::data_type&, xt::svector<std::size_t>>;
+        using underlying_data_type = decltype(std::declval<std::add_lvalue_reference_t<CT>>().data());
+        using data_type = xt::xstrided_view<xt::xclosure_t<underlying_data_type>, xt::svector<std::size_t>>;
         using data_closure_type = data_type;
 
         using subcoordinate_type = typename xexpression_type::coordinate_type;
@@ -76,8 +77,12 @@ namespace xf
      * @class xexpand_dims_view
      * @brief View on a variable with additional axes
      *
-     * The xvariable_masked_view class is used for creating a view on a variable
-     * with additional axes.
+     * The xexpand_dims_view class is used for creating a view on a variable
+     * with additional axes. The underlying data is not copied: the new
+     * dimensions have a null stride, so that every label of an additional
+     * axis refers to the same values. Expressions whose data has no strides,
+     * such as functions, are sliced with new axes instead; their additional
+     * axes must then hold a single label.
      *
      * @tparam CT the closure type on the underlying variable.
      */
@@ -112,10 +117,10 @@ namespace xf
 
         using expression_tag = xvariable_expression_tag;
 
-        using extra_dimensions_type = std::vector<std::pair<typename xexpression_type::key_type, std::size_t>>;
+        using extra_dimensions_type = std::vector<std::pair<key_type, std::size_t>>;
 
         template <class E>
-        xexpand_dims_view(E&& e, const extra_dimensions_type& dims);
+        xexpand_dims_view(E&& e, const extra_dimensions_type& dims, const coordinate_map& axes = coordinate_map());
 
         using base_type::missing;
         using base_type::shape;
@@ -134,13 +139,19 @@ namespace xf
         using base_type::select;
         using base_type::iselect;
 
+        const xexpression_type& expression() const noexcept;
+
     private:
 
         template <class E>
         dimension_list init_dimension_mapping(E&& e, const extra_dimensions_type& dims) const noexcept;
         template <class E>
-        coordinate_type init_coordinate(E&& e, const extra_dimensions_type& dims) const noexcept;
-        data_type init_data(const extra_dimensions_type& dims) const noexcept;
+        coordinate_type init_coordinate(E&& e, const extra_dimensions_type& dims, const coordinate_map& axes) const;
+        data_type init_data(const extra_dimensions_type& dims);
+        template <class D>
+        data_type init_data_impl(D&& data, const extra_dimensions_type& dims, std::true_type) const;
+        template <class D>
+        data_type init_data_impl(D&& data, const extra_dimensions_type& dims, std::false_type) const;
 
         const data_type& data_impl() const noexcept;
         data_type& data_impl() noexcept;
@@ -162,11 +173,15 @@ namespace xf
     auto expand_dims(E&& e, std::initializer_list<K> dim_names);
 
     template <class E>
-    auto expand_dims(E&& e, std::initializer_list<std::pair<typename std::decay_t<E>::key_type, std::size_t>> dims);
+    auto expand_dims(E&& e, std::initializer_list<std::pair<typename std::decay_t<E>::coordinate_type::key_type, std::size_t>> dims);
 
     template <class E>
     auto expand_dims(E&& e, std::initializer_list<const char*> dim_names);
 
+    template <class E>
+    auto expand_dims(E&& e, std::initializer_list<std::pair<typename std::decay_t<E>::coordinate_type::key_type,
+                                                            typename std::decay_t<E>::coordinate_type::axis_type>> axes);
+
     /************************************
      * xexpand_dims_view implementation *
      ************************************/
@@ -176,16 +191,27 @@ namespace xf
      * @param e the variable expression on which to create the view.
      * @param dims the map of extra dimensions, the key being the dimension name,
      * the value the position where to put the new dimension.
+     * @param axes the axes of the extra dimensions; extra dimensions missing
+     * from this map hold a single label.
      */
     template <class CT>
     template <class E>
-    inline xexpand_dims_view<CT>::xexpand_dims_view(E&& e, const extra_dimensions_type& dims)
-        : base_type(init_coordinate(std::forward<E>(e), dims), init_dimension_mapping(std::forward<E>(e), dims)),
+    inline xexpand_dims_view<CT>::xexpand_dims_view(E&& e, const extra_dimensions_type& dims, const coordinate_map& axes)
+        : base_type(init_coordinate(std::forward<E>(e), dims, axes), init_dimension_mapping(std::forward<E>(e), dims)),
           m_e(std::forward<E>(e)),
           m_data(init_data(dims))
     {
     }
 
+    /**
+     * Returns the underlying variable expression.
+     */
+    template <class CT>
+    inline auto xexpand_dims_view<CT>::expression() const noexcept -> const xexpression_type&
+    {
+        return m_e;
+    }
+
     template <class CT>
     template <class E>
     inline auto xexpand_dims_view<CT>::init_dimension_mapping(E&& e, const extra_dimensions_type& dims) const noexcept -> dimension_list
@@ -200,25 +226,84 @@ namespace xf
 
     template <class CT>
     template <class E>
-    inline auto xexpand_dims_view<CT>::init_coordinate(E&& e, const extra_dimensions_type& dims) const noexcept -> coordinate_type
+    inline auto xexpand_dims_view<CT>::init_coordinate(E&& e, const extra_dimensions_type& dims, const coordinate_map& axes) const -> coordinate_type
     {
         coordinate_map extra_dims;
         for (const auto& dim : dims)
         {
-            extra_dims.insert(std::make_pair(dim.first, ::xf::axis(1)));
+            auto iter = axes.find(dim.first);
+            if (iter != axes.cend())
+            {
+                extra_dims.insert(*iter);
+            }
+            else
+            {
+                extra_dims.insert(std::make_pair(dim.first, ::xf::axis(1)));
+            }
         }
         return expand_dims(e.coordinates(), std::move(extra_dims));
     }
 
     template <class CT>
-    inline auto xexpand_dims_view<CT>::init_data(const extra_dimensions_type& dims) const noexcept -> data_type
+    inline auto xexpand_dims_view<CT>::init_data(const extra_dimensions_type& dims) -> data_type
     {
-        xt::xstrided_slice_vector sv(m_e.data().dimension() + dims.size(), xt::all());
-        for (const auto& iter : dims)
+        using underlying_data_type = typename inner_types::underlying_data_type;
+        return init_data_impl(m_e.data(), dims, detail::has_data_strides<std::decay_t<underlying_data_type>>());
+    }
+
+    // The view is built from its shape and strides rather than from slices:
+    // extra dimensions get a null stride, so that they can hold any number
+    // of labels without copying the underlying data.
+    template <class CT>
+    template <class D>
+    inline auto xexpand_dims_view<CT>::init_data_impl(D&& data, const extra_dimensions_type& dims, std::true_type) const -> data_type
+    {
+        using shape_type = xt::svector<std::size_t>;
+        using strides_type = typename data_type::strides_type;
+        using stride_type = typename strides_type::value_type;
+        const std::size_t dimension = data.dimension() + dims.size();
+        shape_type shape(dimension, std::size_t(0));
+        strides_type strides(dimension, stride_type(0));
+        std::vector<bool> extra(dimension, false);
+        const auto& coords = this->coordinates();
+        for (const auto& dim : dims)
+        {
+            extra[dim.second] = true;
+            shape[dim.second] = coords[dim.first].size();
+        }
+
+        std::size_t sub_index = 0;
+        for (std::size_t i = 0; i < dimension; ++i)
         {
-            sv[iter.second] = xt::newaxis();
+            if (!extra[i])
+            {
+                shape[i] = data.shape()[sub_index];
+                strides[i] = static_cast<stride_type>(data.strides()[sub_index]);
+                ++sub_index;
+            }
         }
-        return xt::strided_view(m_e.data(), std::move(sv));
+        std::size_t offset = static_cast<std::size_t>(data.data_offset());
+        return xt::strided_view(std::forward<D>(data), std::move(shape), std::move(strides), offset, xt::layout_type::dynamic);
+    }
+
+    // Expressions without strides, such as functions, cannot be given null
+    // strides: new axes are inserted by slicing, which limits the extra
+    // dimensions to a single label.
+    template <class CT>
+    template <class D>
+    inline auto xexpand_dims_view<CT>::init_data_impl(D&& data, const extra_dimensions_type& dims, std::false_type) const -> data_type
+    {
+        const auto& coords = this->coordinates();
+        xt::xstrided_slice_vector sv(data.dimension() + dims.size(), xt::all());
+        for (const auto& dim : dims)
+        {
+            if (coords[dim.first].size() != 1)
+            {
+                throw std::runtime_error("expand_dims: extra axes of an expression without strides must hold a single label");
+            }
+            sv[dim.second] = xt::newaxis();
+        }
+        return xt::strided_view(std::forward<D>(data), std::move(sv));
     }
 
     template <class CT>
@@ -240,7 +325,7 @@ namespace xf
     template <class E, class K>
     inline auto expand_dims_impl(E&& e, std::initializer_list<K> dim_names)
     {
-        using extra_dimensions_type = std::vector<std::pair<typename std::decay_t<E>::key_type, std::size_t>>;
+        using extra_dimensions_type = std::vector<std::pair<typename std::decay_t<E>::coordinate_type::key_type, std::size_t>>;
         extra_dimensions_type extra_dimensions;
         for (const auto& dim_name : dim_names)
         {
@@ -269,7 +354,7 @@ namespace xf
      * @param dims the extra dimensions as a mapping "dimension name" -> "position".
      */
     template <class E>
-    inline auto expand_dims(E&& e, std::initializer_list<std::pair<typename std::decay_t<E>::key_type, std::size_t>> dims)
+    inline auto expand_dims(E&& e, std::initializer_list<std::pair<typename std::decay_t<E>::coordinate_type::key_type, std::size_t>> dims)
     {
         return xexpand_dims_view<xtl::closure_type_t<E>>(std::forward<E>(e), dims);
     }
@@ -280,6 +365,34 @@ namespace xf
         return expand_dims_impl(std::forward<E>(e), dim_names);
     }
 
+    /**
+     * Creates a view on a variable expression with additional axes, given the
+     * names and the axes of the extra dimensions, which are prepended to the
+     * dimensions of the expression. The values of the expression are not copied
+     * but repeated along the extra dimensions.
+     * Example:
+     * \code{.cpp}
+     * // res has shape {1000, 3, 3}, res.locate(i, "d", 1) == var.locate("d", 1)
+     * auto res = expand_dims(var, {{"scenario", axis(1000)}});
+     * \endcode
+     * @param e the variable expression on which to create the view.
+     * @param axes the extra dimensions as a mapping "dimension name" -> "axis".
+     */
+    template <class E>
+    inline auto expand_dims(E&& e, std::initializer_list<std::pair<typename std::decay_t<E>::coordinate_type::key_type,
+                                                                   typename std::decay_t<E>::coordinate_type::axis_type>> axes)
+    {
+        using view_type = xexpand_dims_view<xtl::closure_type_t<E>>;
+        typename view_type::extra_dimensions_type extra_dimensions;
+        typename view_type::coordinate_map extra_axes;
+        for (const auto& a : axes)
+        {
+            extra_dimensions.push_back(std::make_pair(a.first, extra_dimensions.size()));
+            extra_axes.insert(a);
+        }
+        return view_type(std::forward<E>(e), std::move(extra_dimensions), std::move(extra_axes));
+    }
+
     template <class CT>
     inline std::ostream& operator<<(std::ostream& out, const xexpand_dims_view<CT>& view)
     {
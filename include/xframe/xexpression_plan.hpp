@@ -0,0 +1,527 @@
+/***************************************************************************
+* Copyright (c) 2017, Johan Mabille, Sylvain Corlay and Wolf Vollprecht    *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XFRAME_XEXPRESSION_PLAN_HPP
+#define XFRAME_XEXPRESSION_PLAN_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "xtensor/xutils.hpp"
+
+#include "xbitmask.hpp"
+#include "xcoordinate.hpp"
+#include "xcoordinate_cache.hpp"
+#include "xframe_trace.hpp"
+#include "xframe_utils.hpp"
+#include "xparallel.hpp"
+#include "xselecting.hpp"
+#include "xvariable_assign.hpp"
+#include "xvariable_function.hpp"
+#include "xvariable_scalar.hpp"
+
+namespace xf
+{
+
+    /********************
+     * xexpression_plan *
+     ********************/
+
+    namespace detail
+    {
+        constexpr std::size_t missing_position = std::numeric_limits<std::size_t>::max();
+
+        // Number of elements evaluated by a task; a multiple of the size of
+        // the words of bitmask flags, so that tasks never share a word.
+        constexpr std::size_t plan_task_size = 4096;
+        static_assert(plan_task_size % xbitmask::word_size == 0, "tasks must not share bitmask words");
+
+        struct plan_operand_index
+        {
+            std::vector<std::size_t> m_index;
+            bool m_valid;
+        };
+    }
+
+    /**
+     * @class xexpression_plan
+     * @brief Evaluation plan of a variable expression.
+     *
+     * The xexpression_plan class captures everything that only depends on
+     * the coordinates of the operands of an expression: the broadcast
+     * coordinates and dimension mapping, the trivial broadcast flags and,
+     * when the labels of the operands differ, the position in each operand
+     * of every label of the result. Executing the plan then only computes
+     * the values, so that an expression evaluated repeatedly on operands
+     * whose values change but whose coordinates do not is broadcast once.
+     *
+     * The coordinates of the operands must not be modified while the plan
+     * is used: the plan records their stamps, and execute throws if they
+     * have changed.
+     *
+     * The plan keeps the scratch buffers used to evaluate the remapped
+     * operands across calls to execute; a plan must therefore not be
+     * executed concurrently from several threads. Executing with more than
+     * one thread spawns the additional threads on each call.
+     *
+     * @tparam CT the closure type of the expression.
+     * @tparam Join the join used to broadcast the coordinates.
+     * @sa prepare
+     */
+    template <class CT, class Join>
+    class xexpression_plan
+    {
+    public:
+
+        using expression_type = std::decay_t<CT>;
+        using coordinate_type = typename expression_type::coordinate_type;
+        using dimension_type = typename expression_type::dimension_type;
+        using temporary_type = typename expression_type::temporary_type;
+        using size_type = std::size_t;
+        using join_type = Join;
+
+        explicit xexpression_plan(CT e);
+
+        const coordinate_type& coordinates() const noexcept;
+        const dimension_type& dimension_mapping() const noexcept;
+        xtrivial_broadcast trivial_broadcast() const noexcept;
+
+        template <class V>
+        void execute(V& out, size_type nb_threads = 1) const;
+
+        temporary_type evaluate(size_type nb_threads = 1) const;
+
+    private:
+
+        using index_list = std::vector<size_type>;
+        using operand_index_list = std::vector<detail::plan_operand_index>;
+        using stamp_list = std::vector<std::size_t>;
+
+        struct operand_remap
+        {
+            // Position in the result of each dimension of the operand
+            index_list m_dimensions;
+            // For each dimension of the operand, position in the operand
+            // of each label of the result
+            std::vector<index_list> m_positions;
+        };
+
+        // Buffers used by a worker to evaluate its tasks
+        struct worker_scratch
+        {
+            index_list m_index;
+            operand_index_list m_operands;
+        };
+
+        template <class E>
+        operand_remap make_remap(const E& e) const;
+
+        stamp_list operand_stamps() const;
+        bool check_stamps() const;
+
+        template <class V>
+        void execute_remapped(V& out, size_type nb_threads) const;
+
+        template <class V>
+        void execute_remapped_impl(V& out, size_type nb_threads, std::false_type) const;
+
+        template <class V>
+        void execute_remapped_impl(V& out, size_type nb_threads, std::true_type) const;
+
+        template <class D, class F>
+        void run_tasks(const D& data, size_type nb_threads, F&& store) const;
+
+        void update_operands(const index_list& index, operand_index_list& operands) const;
+
+        CT m_e;
+        coordinate_type m_coordinate;
+        dimension_type m_dimension_mapping;
+        xtrivial_broadcast m_trivial;
+        std::vector<operand_remap> m_operands;
+        stamp_list m_stamps;
+        mutable std::vector<worker_scratch> m_scratch;
+    };
+
+    template <class Join = XFRAME_DEFAULT_JOIN, class E>
+    xexpression_plan<xt::const_closure_type_t<E>, Join> prepare(E&& e);
+
+    /***********************************
+     * xexpression_plan implementation *
+     ***********************************/
+
+    namespace detail
+    {
+        template <class E, class F>
+        void for_each_operand(const E& e, F&& f);
+
+        template <class CT, class F>
+        void for_each_operand(const xvariable_scalar<CT>& e, F&& f);
+
+        template <class FN, class R, class... CT, class F>
+        void for_each_operand(const xvariable_function<FN, R, CT...>& e, F&& f);
+
+        template <class E, class O>
+        typename E::const_reference plan_value(const E& e, const O& operands, std::size_t& operand);
+
+        template <class CT, class O>
+        typename xvariable_scalar<CT>::const_reference plan_value(const xvariable_scalar<CT>& e, const O& operands, std::size_t& operand);
+
+        template <class F, class R, class... CT, class O>
+        R plan_value(const xvariable_function<F, R, CT...>& e, const O& operands, std::size_t& operand);
+
+        template <class K, class L, class S, class MT>
+        bool check_coordinate_stamp(const xcoordinate<K, L, S, MT>& c, const std::vector<std::size_t>& stamps, std::size_t& pos);
+
+        template <class C>
+        bool check_coordinate_stamp(const C& c, const std::vector<std::size_t>& stamps, std::size_t& pos);
+
+        // Calls f on each operand holding data, in the order of a depth-first
+        // traversal of the expression.
+        template <class E, class F>
+        inline void for_each_operand(const E& e, F&& f)
+        {
+            f(e);
+        }
+
+        template <class CT, class F>
+        inline void for_each_operand(const xvariable_scalar<CT>& /*e*/, F&& /*f*/)
+        {
+        }
+
+        template <class FN, class R, class... CT, class F>
+        inline void for_each_operand(const xvariable_function<FN, R, CT...>& e, F&& f)
+        {
+            xt::for_each([&f](const auto& arg) { for_each_operand(arg, f); }, e.arguments());
+        }
+
+        template <class E, class O>
+        inline typename E::const_reference plan_value(const E& e, const O& operands, std::size_t& operand)
+        {
+            const auto& index = operands[operand++];
+            if (index.m_valid)
+            {
+                return e.data().element(index.m_index.cbegin(), index.m_index.cend());
+            }
+            return static_missing<typename E::const_reference>();
+        }
+
+        template <class CT, class O>
+        inline typename xvariable_scalar<CT>::const_reference plan_value(const xvariable_scalar<CT>& e, const O& /*operands*/, std::size_t& /*operand*/)
+        {
+            return e();
+        }
+
+        template <class F, class R, class... CT, class O, std::size_t... I>
+        inline R plan_apply(const xvariable_function<F, R, CT...>& e, const O& operands, std::size_t& operand, std::index_sequence<I...>)
+        {
+            // The braced initialization evaluates the arguments from left to
+            // right, that is in the order of the operands of the plan.
+            std::tuple<decltype(plan_value(std::get<I>(e.arguments()), operands, operand))...> args{
+                plan_value(std::get<I>(e.arguments()), operands, operand)...
+            };
+            return e.functor()(std::get<I>(args)...);
+        }
+
+        template <class F, class R, class... CT, class O>
+        inline R plan_value(const xvariable_function<F, R, CT...>& e, const O& operands, std::size_t& operand)
+        {
+            return plan_apply(e, operands, operand, std::make_index_sequence<sizeof...(CT)>());
+        }
+
+        // Compares the stamp of the coordinates of an operand with the one
+        // recorded at position pos, mirroring add_coordinate_stamp.
+        template <class K, class L, class S, class MT>
+        inline bool check_coordinate_stamp(const xcoordinate<K, L, S, MT>& c, const std::vector<std::size_t>& stamps, std::size_t& pos)
+        {
+            return pos < stamps.size() && stamps[pos++] == c.stamp();
+        }
+
+        template <class C>
+        inline bool check_coordinate_stamp(const C& /*c*/, const std::vector<std::size_t>& /*stamps*/, std::size_t& /*pos*/)
+        {
+            return true;
+        }
+    }
+
+    /**
+     * Builds the plan of an expression, broadcasting its coordinates and,
+     * if the labels of the operands differ, computing the positions of the
+     * labels of the result in each operand.
+     * @param e the expression.
+     */
+    template <class CT, class Join>
+    inline xexpression_plan<CT, Join>::xexpression_plan(CT e)
+        : m_e(std::forward<CT>(e)), m_coordinate(), m_dimension_mapping(), m_trivial(), m_operands(), m_stamps(), m_scratch()
+    {
+        XFRAME_TRACE_SPAN(span, "prepare")
+        m_trivial = m_e.template broadcast_coordinates<Join>(m_coordinate);
+        bool dim_trivial = m_e.broadcast_dimensions(m_dimension_mapping, m_trivial.m_same_dimensions);
+        m_trivial.m_same_labels &= dim_trivial;
+        if (!m_trivial.m_same_labels)
+        {
+            detail::for_each_operand(m_e, [this](const auto& operand) { m_operands.push_back(this->make_remap(operand)); });
+        }
+        m_stamps = operand_stamps();
+        XFRAME_TRACE_SPAN_SLOW_PATH(span, !m_trivial.m_same_labels)
+    }
+
+    /**
+     * Returns the broadcast coordinates of the expression.
+     */
+    template <class CT, class Join>
+    inline auto xexpression_plan<CT, Join>::coordinates() const noexcept -> const coordinate_type&
+    {
+        return m_coordinate;
+    }
+
+    /**
+     * Returns the broadcast dimension mapping of the expression.
+     */
+    template <class CT, class Join>
+    inline auto xexpression_plan<CT, Join>::dimension_mapping() const noexcept -> const dimension_type&
+    {
+        return m_dimension_mapping;
+    }
+
+    /**
+     * Returns the trivial broadcast flags of the expression.
+     */
+    template <class CT, class Join>
+    inline xtrivial_broadcast xexpression_plan<CT, Join>::trivial_broadcast() const noexcept
+    {
+        return m_trivial;
+    }
+
+    /**
+     * Evaluates the expression into \c out. \c out is resized only if its
+     * coordinates are not the ones of the plan, which is the case the first
+     * time it is passed to execute; afterwards, only the values are computed.
+     * Throws if the coordinates of an operand have been modified since the
+     * plan was built.
+     * @param out the variable receiving the result.
+     * @param nb_threads the number of threads used to evaluate operands whose
+     *                   labels differ; the additional threads are spawned on
+     *                   each call.
+     */
+    template <class CT, class Join>
+    template <class V>
+    inline void xexpression_plan<CT, Join>::execute(V& out, size_type nb_threads) const
+    {
+        XFRAME_TRACE_SPAN(span, "execute")
+        if (!check_stamps())
+        {
+            throw std::runtime_error("Coordinates of the operands modified since the plan was prepared");
+        }
+        if (out.coordinates().stamp() != m_coordinate.stamp() || out.dimension_mapping() != m_dimension_mapping)
+        {
+            out.resize(m_coordinate, m_dimension_mapping);
+        }
+        if (m_trivial.m_same_labels)
+        {
+            xt::xexpression_assigner<xvariable_expression_tag>::assign_resized_xexpression(out, m_e, m_trivial);
+        }
+        else
+        {
+            execute_remapped(out, nb_threads);
+        }
+        XFRAME_TRACE_SPAN_SIZE(span, out.size())
+        XFRAME_TRACE_SPAN_SLOW_PATH(span, !m_trivial.m_same_labels)
+    }
+
+    /**
+     * Evaluates the expression into a new variable.
+     * @param nb_threads the number of threads used to evaluate operands whose
+     *                   labels differ.
+     */
+    template <class CT, class Join>
+    inline auto xexpression_plan<CT, Join>::evaluate(size_type nb_threads) const -> temporary_type
+    {
+        temporary_type res(m_coordinate, m_dimension_mapping);
+        execute(res, nb_threads);
+        return res;
+    }
+
+    template <class CT, class Join>
+    template <class E>
+    inline auto xexpression_plan<CT, Join>::make_remap(const E& e) const -> operand_remap
+    {
+        const auto& dim_labels = e.dimension_labels();
+        const auto& coords = e.coordinates();
+        operand_remap res;
+        res.m_dimensions.resize(dim_labels.size());
+        res.m_positions.resize(dim_labels.size());
+        for (size_type d = 0; d < dim_labels.size(); ++d)
+        {
+            const auto& dim = dim_labels[d];
+            const auto& axis = m_coordinate[dim];
+            const auto& operand_axis = coords[dim];
+            res.m_dimensions[d] = static_cast<size_type>(m_dimension_mapping[dim]);
+            index_list& pos = res.m_positions[d];
+            pos.resize(axis.size());
+            for (size_type i = 0; i < pos.size(); ++i)
+            {
+                auto label = axis.label(i);
+                pos[i] = operand_axis.contains(label) ? static_cast<size_type>(operand_axis[label]) : detail::missing_position;
+            }
+        }
+        return res;
+    }
+
+    // Stamps of the coordinates of the operands; views, whose coordinates
+    // refer to axes they do not own, have no stamp and are not checked.
+    template <class CT, class Join>
+    inline auto xexpression_plan<CT, Join>::operand_stamps() const -> stamp_list
+    {
+        stamp_list res;
+        detail::for_each_operand(m_e, [&res](const auto& operand) { detail::add_coordinate_stamp(res, operand.coordinates()); });
+        return res;
+    }
+
+    template <class CT, class Join>
+    inline bool xexpression_plan<CT, Join>::check_stamps() const
+    {
+        bool res = true;
+        size_type pos = 0;
+        detail::for_each_operand(m_e, [this, &res, &pos](const auto& operand) {
+            res = detail::check_coordinate_stamp(operand.coordinates(), m_stamps, pos) && res;
+        });
+        return res && pos == m_stamps.size();
+    }
+
+    template <class CT, class Join>
+    template <class V>
+    inline void xexpression_plan<CT, Join>::execute_remapped(V& out, size_type nb_threads) const
+    {
+        execute_remapped_impl(out, nb_threads, detail::has_bitmask_flags<V>());
+    }
+
+    template <class CT, class Join>
+    template <class V>
+    inline void xexpression_plan<CT, Join>::execute_remapped_impl(V& out, size_type nb_threads, std::false_type) const
+    {
+        auto& data = out.data();
+        run_tasks(data, nb_threads, [&data](const index_list& index, size_type /*n*/, auto&& value) {
+            data.element(index.cbegin(), index.cend()) = value;
+        });
+    }
+
+    // Assigning a missing flag through the bitmask reference also clears
+    // the all-set flag shared by the whole bitmask; the flag is cleared
+    // once here, and the tasks only write the words they own.
+    template <class CT, class Join>
+    template <class V>
+    inline void xexpression_plan<CT, Join>::execute_remapped_impl(V& out, size_type nb_threads, std::true_type) const
+    {
+        auto& data = out.data();
+        auto& flags = data.has_value();
+        if (flags.layout() != xt::layout_type::row_major)
+        {
+            execute_remapped_impl(out, size_type(1), std::false_type());
+            return;
+        }
+        auto& values = data.value();
+        xbitmask::word_type* words = flags.data().words();
+        run_tasks(data, nb_threads, [&values, words](const index_list& index, size_type n, auto&& value) {
+            values.element(index.cbegin(), index.cend()) = value.value();
+            xbitmask::word_type& word = words[n / xbitmask::word_size];
+            xbitmask::word_type mask = xbitmask::word_type(1) << (n % xbitmask::word_size);
+            word = value.has_value() ? (word | mask) : (word & ~mask);
+        });
+    }
+
+    // The result is split into ranges of consecutive elements evaluated by
+    // independent tasks; each element is computed from the values of the
+    // operands at the positions given by the remap tables, and passed to
+    // store with its index and its position in the row-major order.
+    template <class CT, class Join>
+    template <class D, class F>
+    inline void xexpression_plan<CT, Join>::run_tasks(const D& data, size_type nb_threads, F&& store) const
+    {
+        const auto& shape = data.shape();
+        const size_type rank = shape.size();
+        const size_type size = static_cast<size_type>(data.size());
+        const size_type nb_tasks = (size + detail::plan_task_size - 1) / detail::plan_task_size;
+        m_scratch.resize(detail::parallel_worker_count(nb_tasks, nb_threads));
+        for (worker_scratch& scratch : m_scratch)
+        {
+            scratch.m_index.resize(rank);
+            scratch.m_operands.resize(m_operands.size());
+            for (size_type k = 0; k < m_operands.size(); ++k)
+            {
+                scratch.m_operands[k].m_index.resize(m_operands[k].m_dimensions.size());
+            }
+        }
+        detail::parallel_for_workers(nb_tasks, nb_threads, [&](size_type task, size_type worker)
+        {
+            worker_scratch& scratch = m_scratch[worker];
+            index_list& index = scratch.m_index;
+            size_type first = task * detail::plan_task_size;
+            size_type last = std::min(first + detail::plan_task_size, size);
+            size_type rem = first;
+            for (size_type d = rank; d != 0; --d)
+            {
+                index[d - 1] = rem % shape[d - 1];
+                rem /= shape[d - 1];
+            }
+            for (size_type n = first; n < last; ++n)
+            {
+                update_operands(index, scratch.m_operands);
+                size_type operand = 0;
+                store(index, n, detail::plan_value(m_e, scratch.m_operands, operand));
+                xt::detail::increment_index(shape, index);
+            }
+        });
+    }
+
+    template <class CT, class Join>
+    inline void xexpression_plan<CT, Join>::update_operands(const index_list& index, operand_index_list& operands) const
+    {
+        for (size_type k = 0; k < operands.size(); ++k)
+        {
+            const operand_remap& remap = m_operands[k];
+            detail::plan_operand_index& operand = operands[k];
+            operand.m_valid = true;
+            for (size_type d = 0; d < remap.m_dimensions.size(); ++d)
+            {
+                size_type pos = remap.m_positions[d][index[remap.m_dimensions[d]]];
+                operand.m_valid = operand.m_valid && pos != detail::missing_position;
+                operand.m_index[d] = pos;
+            }
+        }
+    }
+
+    /**
+     * Returns the evaluation plan of an expression.
+     * Example:
+     * \code{.cpp}
+     * auto plan = xf::prepare(a * b + c);
+     * variable_type res;
+     * for (std::size_t i = 0; i < nb_steps; ++i)
+     * {
+     *     update(a, b, c);
+     *     plan.execute(res);
+     * }
+     * \endcode
+     *
+     * @tparam Join the join used to broadcast the coordinates.
+     * @param e the expression, which is held by reference if it is an lvalue.
+     * @sa xexpression_plan
+     */
+    template <class Join, class E>
+    inline xexpression_plan<xt::const_closure_type_t<E>, Join> prepare(E&& e)
+    {
+        return xexpression_plan<xt::const_closure_type_t<E>, Join>(std::forward<E>(e));
+    }
+}
+
+#endif
@@ -33,23 +33,66 @@ namespace xf
 #define XFRAME_DEFAULT_JOIN join::inner
 #endif
 
+// Stores missing flags in bitmasks instead of arrays of bool
+#ifndef XFRAME_ENABLE_BITMASK_MISSING
+#define XFRAME_ENABLE_BITMASK_MISSING 0
+#endif
+
+#define XFRAME_BITMASK_DATA_CONTAINER(T) xt::xoptional_assembly<xt::xarray<T>, xf::xbitmask_array>
+
+// Stores missing values in-band (NaN for floating point values, other types
+// keep the optional assembly unless given a sentinel by xsentinel_data_traits)
+#ifndef XFRAME_ENABLE_SENTINEL_MISSING
+#define XFRAME_ENABLE_SENTINEL_MISSING 0
+#endif
+
+#define XFRAME_SENTINEL_DATA_CONTAINER(T) xf::xsentinel_data_container<T>
+
+// Data container whose buffers are allocated with A (e.g. xf::xcounting_allocator<T>)
+#define XFRAME_ALLOCATOR_DATA_CONTAINER(T, A)                                                   \
+    xt::xoptional_assembly<xt::xarray<T, XTENSOR_DEFAULT_LAYOUT, A>,                             \
+                           xt::xarray<bool, XTENSOR_DEFAULT_LAYOUT,                              \
+                                      typename std::allocator_traits<A>::template rebind_alloc<bool>>>
+
 #ifndef XFRAME_DEFAULT_DATA_CONTAINER
 #include "xtensor/xarray.hpp"
 #include "xtensor/xoptional_assembly.hpp"
+#if XFRAME_ENABLE_SENTINEL_MISSING
+#include "xsentinel.hpp"
+#define XFRAME_DEFAULT_DATA_CONTAINER(T) XFRAME_SENTINEL_DATA_CONTAINER(T)
+#elif XFRAME_ENABLE_BITMASK_MISSING
+#include "xbitmask.hpp"
+#define XFRAME_DEFAULT_DATA_CONTAINER(T) XFRAME_BITMASK_DATA_CONTAINER(T)
+#else
 #define XFRAME_DEFAULT_DATA_CONTAINER(T) xt::xoptional_assembly<xt::xarray<T>, xt::xarray<bool>>
 #endif
+#endif
 
 // A higher number leads to an ICE on VS 2015
 #ifndef XFRAME_STATIC_DIMENSION_LIMIT
 #define XFRAME_STATIC_DIMENSION_LIMIT 4
 #endif
 
-#ifndef XFRAME_ENABLE_TRACE
-#define XFRAME_ENABLE_TRACE 0
+// Number of entries stored inline by selector and index sequences of
+// dynamic size; selecting in variables with more dimensions allocates
+#ifndef XFRAME_SELECTOR_BUFFER_SIZE
+#define XFRAME_SELECTOR_BUFFER_SIZE 4
+#endif
+
+// Counts slow-path operations, see xframe_counters.hpp
+#ifndef XFRAME_ENABLE_COUNTERS
+#define XFRAME_ENABLE_COUNTERS 0
 #endif
 
-#ifndef XFRAME_OUT
-#define XFRAME_OUT std::cout
+// Number of broadcast coordinates kept by xcoordinate_cache; 0 disables
+// the cache, which is opt-in since every lookup is serialized
+#ifndef XFRAME_COORDINATE_CACHE_SIZE
+#define XFRAME_COORDINATE_CACHE_SIZE 0
+#endif
+
+// Records spans around broadcasting and assignment, see xframe_trace.hpp
+#ifndef XFRAME_ENABLE_TRACE
+#define XFRAME_ENABLE_TRACE 0
 #endif
 
 #endif
@@ -0,0 +1,136 @@
+/***************************************************************************
+* Copyright (c) 2017, Johan Mabille, Sylvain Corlay and Wolf Vollprecht    *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XFRAME_XFRAME_COUNTERS_HPP
+#define XFRAME_XFRAME_COUNTERS_HPP
+
+#include <atomic>
+#include <cstddef>
+
+#include "xframe_config.hpp"
+
+namespace xf
+{
+
+    /*******************
+     * xframe_counters *
+     *******************/
+
+    /**
+     * @class xframe_counters
+     * @brief Snapshot of the runtime counters.
+     *
+     * The counters are updated only when XFRAME_ENABLE_COUNTERS is set to 1;
+     * otherwise snapshots hold zeros.
+     */
+    struct xframe_counters
+    {
+        /// Assignments of operands sharing their labels
+        std::size_t m_trivial_assignments = 0;
+        /// Assignments realigning the operands element by element
+        std::size_t m_realigned_assignments = 0;
+        /// Elements assigned through the per-element realignment
+        std::size_t m_realigned_elements = 0;
+        /// Temporaries created by computed assignments
+        std::size_t m_temporaries = 0;
+        /// Computed assignments evaluated into the resized destination
+        std::size_t m_in_place_assignments = 0;
+        /// Merges of axes
+        std::size_t m_axis_merges = 0;
+        /// Intersections of axes
+        std::size_t m_axis_intersections = 0;
+        /// Builds of the hash index of an axis
+        std::size_t m_index_builds = 0;
+        /// Broadcast coordinates found in the coordinate cache
+        std::size_t m_coordinate_cache_hits = 0;
+    };
+
+    xframe_counters get_counters() noexcept;
+    void reset_counters() noexcept;
+
+    /**********
+     * macros *
+     **********/
+
+#if XFRAME_ENABLE_COUNTERS
+
+#define XFRAME_COUNT_N(counter, n) \
+    xf::detail::counter_storage().counter.fetch_add(static_cast<std::size_t>(n), std::memory_order_relaxed);
+#define XFRAME_COUNT(counter) XFRAME_COUNT_N(counter, 1)
+
+#else
+
+#define XFRAME_COUNT_N(counter, n)
+#define XFRAME_COUNT(counter)
+
+#endif
+
+    /**********************************
+     * xframe_counters implementation *
+     **********************************/
+
+    namespace detail
+    {
+        struct xcounter_storage
+        {
+            std::atomic<std::size_t> m_trivial_assignments{0};
+            std::atomic<std::size_t> m_realigned_assignments{0};
+            std::atomic<std::size_t> m_realigned_elements{0};
+            std::atomic<std::size_t> m_temporaries{0};
+            std::atomic<std::size_t> m_in_place_assignments{0};
+            std::atomic<std::size_t> m_axis_merges{0};
+            std::atomic<std::size_t> m_axis_intersections{0};
+            std::atomic<std::size_t> m_index_builds{0};
+            std::atomic<std::size_t> m_coordinate_cache_hits{0};
+        };
+
+        inline xcounter_storage& counter_storage() noexcept
+        {
+            static xcounter_storage storage;
+            return storage;
+        }
+    }
+
+    /**
+     * Returns the current value of the runtime counters.
+     */
+    inline xframe_counters get_counters() noexcept
+    {
+        const auto& storage = detail::counter_storage();
+        xframe_counters res;
+        res.m_trivial_assignments = storage.m_trivial_assignments.load(std::memory_order_relaxed);
+        res.m_realigned_assignments = storage.m_realigned_assignments.load(std::memory_order_relaxed);
+        res.m_realigned_elements = storage.m_realigned_elements.load(std::memory_order_relaxed);
+        res.m_temporaries = storage.m_temporaries.load(std::memory_order_relaxed);
+        res.m_in_place_assignments = storage.m_in_place_assignments.load(std::memory_order_relaxed);
+        res.m_axis_merges = storage.m_axis_merges.load(std::memory_order_relaxed);
+        res.m_axis_intersections = storage.m_axis_intersections.load(std::memory_order_relaxed);
+        res.m_index_builds = storage.m_index_builds.load(std::memory_order_relaxed);
+        res.m_coordinate_cache_hits = storage.m_coordinate_cache_hits.load(std::memory_order_relaxed);
+        return res;
+    }
+
+    /**
+     * Sets all the runtime counters to zero.
+     */
+    inline void reset_counters() noexcept
+    {
+        auto& storage = detail::counter_storage();
+        storage.m_trivial_assignments.store(0, std::memory_order_relaxed);
+        storage.m_realigned_assignments.store(0, std::memory_order_relaxed);
+        storage.m_realigned_elements.store(0, std::memory_order_relaxed);
+        storage.m_temporaries.store(0, std::memory_order_relaxed);
+        storage.m_in_place_assignments.store(0, std::memory_order_relaxed);
+        storage.m_axis_merges.store(0, std::memory_order_relaxed);
+        storage.m_axis_intersections.store(0, std::memory_order_relaxed);
+        storage.m_index_builds.store(0, std::memory_order_relaxed);
+        storage.m_coordinate_cache_hits.store(0, std::memory_order_relaxed);
+    }
+}
+
+#endif
@@ -38,6 +38,40 @@ namespace xf
     struct xaxis_comparable : xtl::conjunction<is_xaxis_expression<E>...>
     {
     };
+
+    namespace detail
+    {
+        template <class E, class = void>
+        struct has_all_valid : std::false_type
+        {
+        };
+
+        template <class E>
+        struct has_all_valid<E, xt::void_t<decltype(std::declval<const E&>().all_valid())>>
+            : std::true_type
+        {
+        };
+
+        template <class E>
+        inline bool expression_all_valid_impl(const E& e, std::true_type)
+        {
+            return e.all_valid();
+        }
+
+        template <class E>
+        inline bool expression_all_valid_impl(const E&, std::false_type)
+        {
+            return false;
+        }
+
+        // Returns true if the expression is known to hold no missing value;
+        // expressions that do not track missing values are assumed to hold some.
+        template <class E>
+        inline bool expression_all_valid(const E& e)
+        {
+            return expression_all_valid_impl(e, has_all_valid<E>());
+        }
+    }
 }
 
 #endif
@@ -9,45 +9,405 @@
 #ifndef XFRAME_XFRAME_TRACE_HPP
 #define XFRAME_XFRAME_TRACE_HPP
 
-#include <string>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <ostream>
+#include <thread>
+#include <vector>
 
 #include "xframe_config.hpp"
 
 namespace xf
 {
 
-#if XFRAME_ENABLE_TRACE
+    /****************
+     * xtrace_event *
+     ****************/
+
+    /**
+     * @class xtrace_event
+     * @brief Timed span recorded by the tracing hooks.
+     *
+     * Timestamps and durations are expressed in nanoseconds of the steady clock.
+     */
+    struct xtrace_event
+    {
+        const char* m_name = "";
+        std::uint64_t m_begin = 0;
+        std::uint64_t m_duration = 0;
+        std::size_t m_thread_id = 0;
+        std::size_t m_size = 0;
+        bool m_slow_path = false;
+    };
+
+    /***************
+     * xtrace_sink *
+     ***************/
+
+    /**
+     * @class xtrace_sink
+     * @brief Base class of the receivers of trace events.
+     *
+     * record may be called concurrently from any thread.
+     */
+    class xtrace_sink
+    {
+    public:
+
+        virtual ~xtrace_sink() = default;
+
+        virtual void record(const xtrace_event& event) = 0;
+
+    protected:
+
+        xtrace_sink() = default;
+        xtrace_sink(const xtrace_sink&) = default;
+        xtrace_sink& operator=(const xtrace_sink&) = default;
+    };
+
+    xtrace_sink* set_trace_sink(xtrace_sink* sink) noexcept;
+    xtrace_sink* get_trace_sink() noexcept;
+
+    /***************
+     * xtrace_span *
+     ***************/
+
+    /**
+     * @class xtrace_span
+     * @brief Scoped span reporting its duration to the installed sink.
+     *
+     * When no sink is installed, the span neither reads the clock
+     * nor records anything.
+     */
+    class xtrace_span
+    {
+    public:
+
+        explicit xtrace_span(const char* name) noexcept;
+        ~xtrace_span();
+
+        xtrace_span(const xtrace_span&) = delete;
+        xtrace_span& operator=(const xtrace_span&) = delete;
+
+        void set_size(std::size_t size) noexcept;
+        void set_slow_path(bool slow_path) noexcept;
+
+    private:
+
+        xtrace_sink* p_sink;
+        xtrace_event m_event;
+    };
+
+    /**********************
+     * xtrace_ring_buffer *
+     **********************/
+
+    /**
+     * @class xtrace_ring_buffer
+     * @brief Lock-free in-memory sink keeping the most recent events.
+     *
+     * Writers reserve a slot with an atomic increment and publish it with a
+     * sequence number, so that snapshot can skip the slots being written.
+     */
+    class xtrace_ring_buffer : public xtrace_sink
+    {
+    public:
+
+        explicit xtrace_ring_buffer(std::size_t capacity = 4096);
+
+        void record(const xtrace_event& event) override;
+
+        std::size_t capacity() const noexcept;
+        std::size_t nb_recorded() const noexcept;
+        std::size_t nb_dropped() const noexcept;
+
+        std::vector<xtrace_event> snapshot() const;
+
+    private:
+
+        struct slot
+        {
+            std::atomic<std::size_t> m_sequence;
+            xtrace_event m_event;
+        };
+
+        static std::size_t round_capacity(std::size_t capacity) noexcept;
+
+        std::vector<slot> m_slots;
+        std::size_t m_mask;
+        std::atomic<std::size_t> m_head;
+    };
+
+    /************************
+     * xtrace_chrome_writer *
+     ************************/
+
+    /**
+     * @class xtrace_chrome_writer
+     * @brief Sink writing events in the Chrome trace event format.
+     *
+     * The output can be loaded in chrome://tracing or Perfetto. The JSON
+     * document is completed when close is called or the writer is destroyed.
+     */
+    class xtrace_chrome_writer : public xtrace_sink
+    {
+    public:
+
+        explicit xtrace_chrome_writer(std::ostream& out);
+        ~xtrace_chrome_writer() override;
 
-#define XFRAME_TRACE(expr) XFRAME_OUT << expr << std::endl;
+        xtrace_chrome_writer(const xtrace_chrome_writer&) = delete;
+        xtrace_chrome_writer& operator=(const xtrace_chrome_writer&) = delete;
 
-#define XFRAME_TRACE_BROADCAST_DIMENSIONS(lhs, rhs)             \
-    XFRAME_TRACE("BROADCASTING DIMENSIONS");                    \
-    XFRAME_TRACE("lhs = " << lhs);                              \
-    XFRAME_TRACE("rhs = " << rhs);
+        void record(const xtrace_event& event) override;
+        void close();
 
-#define XFRAME_TRACE_DIMENSIONS_RESULT(res, trivial)            \
-    XFRAME_TRACE("res = " << res);                              \
-    XFRAME_TRACE("trivial broadcasting = " << trivial);
+    private:
 
-#define XFRAME_TRACE_BROADCAST_COORDINATES(lhs, rhs)            \
-    XFRAME_TRACE("BROADCASTING COORDINATES");                   \
-    XFRAME_TRACE("lhs:")                                        \
-    XFRAME_OUT << lhs;                                          \
-    XFRAME_TRACE("rhs:")                                        \
-    XFRAME_OUT << rhs;
+        std::ostream& m_out;
+        std::mutex m_mutex;
+        bool m_first;
+        bool m_closed;
+    };
+
+    /**********
+     * macros *
+     **********/
+
+#if XFRAME_ENABLE_TRACE
+
+#define XFRAME_TRACE_SPAN(span, name) xf::xtrace_span span(name);
+#define XFRAME_TRACE_SPAN_SIZE(span, size) span.set_size(size);
+#define XFRAME_TRACE_SPAN_SLOW_PATH(span, slow_path) span.set_slow_path(slow_path);
 
-#define XFRAME_TRACE_COORDINATES_RESULT(res, trivial)           \
-    XFRAME_TRACE("res:")                                        \
-    XFRAME_OUT << res;                                          \
-    XFRAME_TRACE("trivial broadcasting = (" << trivial.m_same_dimensions << ", " << trivial.m_same_labels << ")");
 #else
-#define XFRAME_TRACE(expr)
-#define XFRAME_TRACE_BROADCAST_DIMENSIONS(lhs, rhs)
-#define XFRAME_TRACE_DIMENSIONS_RESULT(res, trivial)
-#define XFRAME_TRACE_BROADCAST_COORDINATES(lhs, rhs)
-#define XFRAME_TRACE_COORDINATES_RESULT(res, trivial)
+
+#define XFRAME_TRACE_SPAN(span, name)
+#define XFRAME_TRACE_SPAN_SIZE(span, size)
+#define XFRAME_TRACE_SPAN_SLOW_PATH(span, slow_path)
+
 #endif
 
+    /*************************
+     * tracing configuration *
+     *************************/
+
+    namespace detail
+    {
+        inline std::atomic<xtrace_sink*>& trace_sink_instance() noexcept
+        {
+            static std::atomic<xtrace_sink*> sink(nullptr);
+            return sink;
+        }
+
+        inline std::uint64_t trace_clock() noexcept
+        {
+            using namespace std::chrono;
+            return static_cast<std::uint64_t>(duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count());
+        }
+    }
+
+    /**
+     * Installs the sink receiving the trace events and returns the previous one.
+     * Passing nullptr disables the recording.
+     */
+    inline xtrace_sink* set_trace_sink(xtrace_sink* sink) noexcept
+    {
+        return detail::trace_sink_instance().exchange(sink);
+    }
+
+    /**
+     * Returns the sink receiving the trace events, nullptr if none is installed.
+     */
+    inline xtrace_sink* get_trace_sink() noexcept
+    {
+        return detail::trace_sink_instance().load(std::memory_order_acquire);
+    }
+
+    /******************************
+     * xtrace_span implementation *
+     ******************************/
+
+    inline xtrace_span::xtrace_span(const char* name) noexcept
+        : p_sink(get_trace_sink())
+    {
+        if (p_sink != nullptr)
+        {
+            m_event.m_name = name;
+            m_event.m_begin = detail::trace_clock();
+        }
+    }
+
+    inline xtrace_span::~xtrace_span()
+    {
+        if (p_sink != nullptr)
+        {
+            m_event.m_duration = detail::trace_clock() - m_event.m_begin;
+            m_event.m_thread_id = std::hash<std::thread::id>()(std::this_thread::get_id());
+            p_sink->record(m_event);
+        }
+    }
+
+    inline void xtrace_span::set_size(std::size_t size) noexcept
+    {
+        m_event.m_size = size;
+    }
+
+    inline void xtrace_span::set_slow_path(bool slow_path) noexcept
+    {
+        m_event.m_slow_path = slow_path;
+    }
+
+    /*************************************
+     * xtrace_ring_buffer implementation *
+     *************************************/
+
+    // A slot holding the event of index i has the sequence number 2 * i + 2
+    // once published, and an odd sequence number while it is being written.
+    inline xtrace_ring_buffer::xtrace_ring_buffer(std::size_t capacity)
+        : m_slots(round_capacity(capacity)), m_mask(m_slots.size() - 1), m_head(0)
+    {
+        for (auto& s : m_slots)
+        {
+            s.m_sequence.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    inline void xtrace_ring_buffer::record(const xtrace_event& event)
+    {
+        std::size_t index = m_head.fetch_add(1, std::memory_order_relaxed);
+        slot& s = m_slots[index & m_mask];
+        s.m_sequence.store(2 * index + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        s.m_event = event;
+        s.m_sequence.store(2 * index + 2, std::memory_order_release);
+    }
+
+    inline std::size_t xtrace_ring_buffer::capacity() const noexcept
+    {
+        return m_slots.size();
+    }
+
+    /**
+     * Returns the number of events recorded since the construction.
+     */
+    inline std::size_t xtrace_ring_buffer::nb_recorded() const noexcept
+    {
+        return m_head.load(std::memory_order_acquire);
+    }
+
+    /**
+     * Returns the number of events overwritten by more recent ones.
+     */
+    inline std::size_t xtrace_ring_buffer::nb_dropped() const noexcept
+    {
+        std::size_t recorded = nb_recorded();
+        return recorded > capacity() ? recorded - capacity() : 0;
+    }
+
+    /**
+     * Returns the retained events, from the oldest to the most recent.
+     */
+    inline std::vector<xtrace_event> xtrace_ring_buffer::snapshot() const
+    {
+        std::size_t head = nb_recorded();
+        std::size_t first = head > capacity() ? head - capacity() : 0;
+        std::vector<xtrace_event> res;
+        res.reserve(head - first);
+        for (std::size_t index = first; index != head; ++index)
+        {
+            const slot& s = m_slots[index & m_mask];
+            std::size_t expected = 2 * index + 2;
+            if (s.m_sequence.load(std::memory_order_acquire) == expected)
+            {
+                xtrace_event event = s.m_event;
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (s.m_sequence.load(std::memory_order_relaxed) == expected)
+                {
+                    res.push_back(event);
+                }
+            }
+        }
+        return res;
+    }
+
+    inline std::size_t xtrace_ring_buffer::round_capacity(std::size_t capacity) noexcept
+    {
+        std::size_t res = 1;
+        while (res < capacity)
+        {
+            res <<= 1;
+        }
+        return res;
+    }
+
+    /***************************************
+     * xtrace_chrome_writer implementation *
+     ***************************************/
+
+    namespace detail
+    {
+        // Chrome expects timestamps in microseconds; the nanoseconds are
+        // kept as decimals without altering the format flags of the stream.
+        inline void write_microseconds(std::ostream& out, std::uint64_t ns)
+        {
+            std::uint64_t decimals = ns % 1000;
+            out << ns / 1000 << '.'
+                << static_cast<char>('0' + decimals / 100)
+                << static_cast<char>('0' + (decimals / 10) % 10)
+                << static_cast<char>('0' + decimals % 10);
+        }
+    }
+
+    inline xtrace_chrome_writer::xtrace_chrome_writer(std::ostream& out)
+        : m_out(out), m_first(true), m_closed(false)
+    {
+        m_out << "{\"traceEvents\":[";
+    }
+
+    inline xtrace_chrome_writer::~xtrace_chrome_writer()
+    {
+        close();
+    }
+
+    inline void xtrace_chrome_writer::record(const xtrace_event& event)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_closed)
+        {
+            return;
+        }
+        if (!m_first)
+        {
+            m_out << ',';
+        }
+        m_first = false;
+        m_out << "\n{\"name\":\"" << event.m_name << "\",\"cat\":\"xframe\",\"ph\":\"X\",\"ts\":";
+        detail::write_microseconds(m_out, event.m_begin);
+        m_out << ",\"dur\":";
+        detail::write_microseconds(m_out, event.m_duration);
+        m_out << ",\"pid\":0,\"tid\":" << event.m_thread_id
+              << ",\"args\":{\"size\":" << event.m_size
+              << ",\"slow_path\":" << (event.m_slow_path ? "true" : "false") << "}}";
+    }
+
+    /**
+     * Completes the JSON document; subsequent events are ignored.
+     */
+    inline void xtrace_chrome_writer::close()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_closed)
+        {
+            m_out << "\n]}\n";
+            m_out.flush();
+            m_closed = true;
+        }
+    }
 }
 
 #endif
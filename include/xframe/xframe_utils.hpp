@@ -9,11 +9,17 @@
 #ifndef XFRAME_XFRAME_UTILS_HPP
 #define XFRAME_XFRAME_UTILS_HPP
 
+#include <algorithm>
 #include <iterator>
 #include <ostream>
 #include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 #include "xtensor/xio.hpp"
+#include "xtensor/xstorage.hpp"
+#include "xtensor/xutils.hpp"
 
 #include "xframe_config.hpp"
 #include "xframe_trace.hpp"
@@ -81,11 +87,27 @@ namespace xf
         template <class S, std::size_t N>
         struct xselector_sequence
         {
-            using type = std::conditional_t<N == std::numeric_limits<std::size_t>::max(), std::vector<S>, std::array<S, N>>;
+            using type = std::conditional_t<N == std::numeric_limits<std::size_t>::max(),
+                                            xt::svector<S, XFRAME_SELECTOR_BUFFER_SIZE>,
+                                            std::array<S, N>>;
         };
 
         template <class S, std::size_t N>
         using xselector_sequence_t = typename xselector_sequence<S, N>::type;
+
+        // Data containers exposing their strides, which can be viewed
+        // through an xstrided_view without going through their slices.
+        template <class D, class = void>
+        struct has_data_strides : std::false_type
+        {
+        };
+
+        template <class D>
+        struct has_data_strides<D, xt::void_t<decltype(std::declval<const D&>().strides()),
+                                              decltype(std::declval<const D&>().data_offset())>>
+            : std::true_type
+        {
+        };
     }
 
     template <class CO, class... CI>
@@ -0,0 +1,154 @@
+/***************************************************************************
+* Copyright (c) 2017, Johan Mabille, Sylvain Corlay and Wolf Vollprecht    *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XFRAME_XMISSING_FLAGS_HPP
+#define XFRAME_XMISSING_FLAGS_HPP
+
+#include <algorithm>
+#include <type_traits>
+#include <utility>
+
+#include "xtensor/xtensor_forward.hpp"
+#include "xtensor/xutils.hpp"
+
+namespace xf
+{
+    class xbitmask;
+
+    template <class T, class S, class A>
+    class xsentinel_vector;
+
+    /*************************
+     * missing flags helpers *
+     *************************/
+
+    // The helpers below only need the declarations of the specialised
+    // storages; their specialisations live in xbitmask.hpp and xsentinel.hpp,
+    // which are included by xframe_config.hpp when the corresponding storage
+    // is the default one, or by the user when using them explicitly.
+
+    namespace detail
+    {
+        // Operations on the storage of the missing flags of a data container
+        template <class S>
+        struct flag_storage_traits
+        {
+            static bool all_set(const S& storage)
+            {
+                return std::all_of(storage.cbegin(), storage.cend(), [](bool b) { return b; });
+            }
+
+            static void set_all(S& storage)
+            {
+                std::fill(storage.begin(), storage.end(), true);
+            }
+        };
+
+        template <class D, class = void>
+        struct has_missing_flags : std::false_type
+        {
+        };
+
+        template <class D>
+        struct has_missing_flags<D, xt::void_t<decltype(std::declval<const D&>().has_value().data())>>
+            : std::true_type
+        {
+        };
+
+        // Operations on the missing flags of a data container; containers
+        // without missing flags cannot hold missing values.
+        template <class D>
+        struct missing_flags_traits
+        {
+            static bool all_set(const D& data)
+            {
+                return all_set_impl(data, has_missing_flags<D>());
+            }
+
+            static void set_all(D& data)
+            {
+                using storage_type = std::decay_t<decltype(data.has_value().data())>;
+                flag_storage_traits<storage_type>::set_all(data.has_value().data());
+            }
+
+        private:
+
+            static bool all_set_impl(const D& data, std::true_type)
+            {
+                using storage_type = std::decay_t<decltype(data.has_value().data())>;
+                return flag_storage_traits<storage_type>::all_set(data.has_value().data());
+            }
+
+            static bool all_set_impl(const D&, std::false_type)
+            {
+                return true;
+            }
+        };
+
+        // Returns true if the data container holds no missing value
+        template <class D>
+        inline bool all_flags_set(const D& data)
+        {
+            return missing_flags_traits<D>::all_set(data);
+        }
+
+        // Marks every value of the data container as valid
+        template <class D>
+        inline void set_all_flags(D& data)
+        {
+            missing_flags_traits<D>::set_all(data);
+        }
+
+        template <class E, class = void>
+        struct has_bitmask_flags : std::false_type
+        {
+        };
+
+        template <class E>
+        struct has_bitmask_flags<E, xt::void_t<decltype(std::declval<E&>().data().has_value().data())>>
+            : std::is_same<std::decay_t<decltype(std::declval<E&>().data().has_value().data())>, xbitmask>
+        {
+        };
+
+        template <class D>
+        struct is_sentinel_data : std::false_type
+        {
+        };
+
+        template <class T, class S, class A, xt::layout_type L, class SC, class Tag>
+        struct is_sentinel_data<xt::xarray_container<xsentinel_vector<T, S, A>, L, SC, Tag>> : std::true_type
+        {
+        };
+
+        template <class E, class = void>
+        struct has_sentinel_data : std::false_type
+        {
+        };
+
+        template <class E>
+        struct has_sentinel_data<E, xt::void_t<decltype(std::declval<E&>().data())>>
+            : is_sentinel_data<std::decay_t<decltype(std::declval<E&>().data())>>
+        {
+        };
+
+        // Setting all the flags of bitmasks and sentinel-encoded containers
+        // is cheap, which makes checking that an expression holds no missing
+        // value worth it before assigning it.
+        template <class E>
+        struct has_compact_flags
+            : std::integral_constant<bool, has_bitmask_flags<E>::value || has_sentinel_data<E>::value>
+        {
+        };
+
+        // Defined in xbitmask.hpp
+        template <class F, class E>
+        bool assign_bitmask_conjunction(F& flags, const E& e);
+    }
+}
+
+#endif
@@ -0,0 +1,112 @@
+/***************************************************************************
+* Copyright (c) 2017, Johan Mabille, Sylvain Corlay and Wolf Vollprecht    *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XFRAME_XPARALLEL_HPP
+#define XFRAME_XPARALLEL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace xf
+{
+    /****************
+     * parallel_for *
+     ****************/
+
+    namespace detail
+    {
+        /**
+         * Returns the number of workers used by parallel_for for \c nb_tasks
+         * tasks and at most \c nb_threads threads.
+         */
+        inline std::size_t parallel_worker_count(std::size_t nb_tasks, std::size_t nb_threads) noexcept
+        {
+            return std::max(std::min(nb_threads, nb_tasks), std::size_t(1));
+        }
+
+        /**
+         * Calls \c f(i, w) for i in [0, nb_tasks), distributing the tasks over
+         * parallel_worker_count(nb_tasks, nb_threads) workers, the calling
+         * thread included; \c w is the index of the worker running the task,
+         * so that \c f can use per-worker scratch storage. When more than one
+         * worker is needed, the additional threads are spawned on each call.
+         * The first exception thrown by a task stops the distribution and is
+         * rethrown once all the threads have completed.
+         */
+        template <class F>
+        inline void parallel_for_workers(std::size_t nb_tasks, std::size_t nb_threads, F&& f)
+        {
+            std::size_t nb_workers = parallel_worker_count(nb_tasks, nb_threads);
+            if (nb_workers <= 1)
+            {
+                for (std::size_t i = 0; i < nb_tasks; ++i)
+                {
+                    f(i, std::size_t(0));
+                }
+                return;
+            }
+
+            std::atomic<std::size_t> next(0);
+            std::exception_ptr error = nullptr;
+            std::mutex error_mutex;
+            auto worker = [&](std::size_t w) {
+                std::size_t i;
+                while ((i = next++) < nb_tasks)
+                {
+                    try
+                    {
+                        f(i, w);
+                    }
+                    catch (...)
+                    {
+                        std::lock_guard<std::mutex> lock(error_mutex);
+                        if (!error)
+                        {
+                            error = std::current_exception();
+                        }
+                        next = nb_tasks;
+                    }
+                }
+            };
+
+            std::vector<std::thread> threads;
+            threads.reserve(nb_workers - 1);
+            for (std::size_t t = 1; t < nb_workers; ++t)
+            {
+                threads.emplace_back(worker, t);
+            }
+            worker(std::size_t(0));
+            for (auto& th : threads)
+            {
+                th.join();
+            }
+            if (error)
+            {
+                std::rethrow_exception(error);
+            }
+        }
+
+        /**
+         * Calls \c f(i) for i in [0, nb_tasks), distributing the tasks over
+         * at most \c nb_threads threads, the calling thread included.
+         * @sa parallel_for_workers
+         */
+        template <class F>
+        inline void parallel_for(std::size_t nb_tasks, std::size_t nb_threads, F&& f)
+        {
+            parallel_for_workers(nb_tasks, nb_threads, [&f](std::size_t i, std::size_t) { f(i); });
+        }
+    }
+}
+
+#endif
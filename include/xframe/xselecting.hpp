@@ -9,7 +9,12 @@
 #ifndef XFRAME_XSELECTING_HPP
 #define XFRAME_XSELECTING_HPP
 
+#include <initializer_list>
+#include <iterator>
 #include <limits>
+#include <stdexcept>
+#include <tuple>
+#include <vector>
 
 #include "xtl/xsequence.hpp"
 #include "xtl/xoptional.hpp"
@@ -41,6 +46,17 @@ namespace xf
             }
         };
 
+        template <class T>
+        struct static_missing_impl<xtl::xoptional<const T&, bool>>
+        {
+            using return_type = xtl::xoptional<const T&, bool>;
+            static inline return_type get()
+            {
+                static T val = T(0);
+                return return_type(val, false);
+            }
+        };
+
         template <class T, class B>
         struct static_missing_impl<xt::xmasked_value<T, B>>
         {
@@ -156,6 +172,62 @@ namespace xf
         sequence_type m_coord;
     };
 
+    /*******************
+     * xbatch_selector *
+     *******************/
+
+    /**
+     * @class xbatch_selector
+     * @brief Selector holding many rows of labels for the same dimensions.
+     *
+     * The dimension names are given once, and each row holds a label for
+     * each of them. The positions of the dimensions and the axes are resolved
+     * once for the whole batch, so that selecting a row only involves the
+     * lookups of its labels.
+     *
+     * @tparam C the type of the coordinates.
+     * @tparam D the type of the dimension mapping.
+     */
+    template <class C, class D>
+    class xbatch_selector
+    {
+    public:
+
+        static_assert(is_coordinate<C>::value, "first parameter of xbatch_selector must be xcoordinate");
+        static_assert(is_dimension<D>::value, "second parameter of xbatch_selector must be xdimension");
+
+        using coordinate_type = C;
+        using key_type = typename coordinate_type::key_type;
+        using label_list = typename coordinate_type::label_list;
+        using mapped_type = mpl::cast_t<label_list, xtl::variant>;
+        using size_type = typename coordinate_type::index_type;
+        using index_type = detail::xselector_sequence_t<size_type, dynamic()>;
+        using dimension_type = D;
+        using name_list = std::vector<key_type>;
+        using label_sequence = std::vector<mapped_type>;
+
+        explicit xbatch_selector(const name_list& names);
+        explicit xbatch_selector(name_list&& names);
+
+        void reserve(size_type nb_rows);
+        void push_back(std::initializer_list<mapped_type> row);
+
+        template <class It>
+        void push_back(It first, It last);
+
+        const name_list& names() const noexcept;
+        size_type size() const noexcept;
+        bool empty() const noexcept;
+
+        template <class F>
+        void for_each_index(const coordinate_type& coord, const dimension_type& dim, F&& f) const;
+
+    private:
+
+        name_list m_names;
+        label_sequence m_labels;
+    };
+
     /********************
      * xselector_traits *
      ********************/
@@ -174,6 +246,7 @@ namespace xf
         using iselector_sequence_type = typename iselector_type::sequence_type;
         using locator_type = xlocator<coordinate_type, dimension_type, N>;
         using locator_sequence_type = typename locator_type::sequence_type;
+        using batch_selector_type = xbatch_selector<coordinate_type, dimension_type>;
 
         static constexpr std::size_t static_dimension = N;
     };
@@ -295,6 +368,103 @@ namespace xf
         return res;
     }
 
+    /**********************************
+     * xbatch_selector implementation *
+     **********************************/
+
+    /**
+     * Builds an empty batch selecting along the dimensions \c names.
+     */
+    template <class C, class D>
+    inline xbatch_selector<C, D>::xbatch_selector(const name_list& names)
+        : m_names(names), m_labels()
+    {
+    }
+
+    template <class C, class D>
+    inline xbatch_selector<C, D>::xbatch_selector(name_list&& names)
+        : m_names(std::move(names)), m_labels()
+    {
+    }
+
+    template <class C, class D>
+    inline void xbatch_selector<C, D>::reserve(size_type nb_rows)
+    {
+        m_labels.reserve(nb_rows * m_names.size());
+    }
+
+    /**
+     * Appends a row of labels, given in the order of the dimension names.
+     */
+    template <class C, class D>
+    inline void xbatch_selector<C, D>::push_back(std::initializer_list<mapped_type> row)
+    {
+        push_back(row.begin(), row.end());
+    }
+
+    template <class C, class D>
+    template <class It>
+    inline void xbatch_selector<C, D>::push_back(It first, It last)
+    {
+        if (static_cast<std::size_t>(std::distance(first, last)) != m_names.size())
+        {
+            throw std::runtime_error("row size does not match the number of dimensions of xbatch_selector");
+        }
+        m_labels.insert(m_labels.end(), first, last);
+    }
+
+    template <class C, class D>
+    inline auto xbatch_selector<C, D>::names() const noexcept -> const name_list&
+    {
+        return m_names;
+    }
+
+    /**
+     * Returns the number of rows.
+     */
+    template <class C, class D>
+    inline auto xbatch_selector<C, D>::size() const noexcept -> size_type
+    {
+        return m_names.empty() ? size_type(0) : m_labels.size() / m_names.size();
+    }
+
+    template <class C, class D>
+    inline bool xbatch_selector<C, D>::empty() const noexcept
+    {
+        return m_labels.empty();
+    }
+
+    /**
+     * Calls \c f with the index of each row, in the order of the rows. Names
+     * that are not dimensions of \c dim are ignored, as in xselector.
+     */
+    template <class C, class D>
+    template <class F>
+    inline void xbatch_selector<C, D>::for_each_index(const coordinate_type& coord, const dimension_type& dim, F&& f) const
+    {
+        using axis_type = typename coordinate_type::axis_type;
+        using target_type = std::tuple<std::size_t, size_type, const axis_type*>;
+        detail::xselector_sequence_t<target_type, dynamic()> targets;
+        for (std::size_t i = 0; i < m_names.size(); ++i)
+        {
+            auto iter = dim.find(m_names[i]);
+            if (iter != dim.end())
+            {
+                targets.push_back(target_type(i, iter->second, &coord[m_names[i]]));
+            }
+        }
+
+        index_type index = xtl::make_sequence<index_type>(dim.size(), size_type(0));
+        const std::size_t row_size = m_names.size();
+        for (std::size_t offset = 0; offset < m_labels.size(); offset += row_size)
+        {
+            for (const auto& t : targets)
+            {
+                index[std::get<1>(t)] = (*std::get<2>(t))[m_labels[offset + std::get<0>(t)]];
+            }
+            f(static_cast<const index_type&>(index));
+        }
+    }
 }
 
 #endif
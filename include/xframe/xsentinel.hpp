@@ -0,0 +1,1048 @@
+/***************************************************************************
+* Copyright (c) 2017, Johan Mabille, Sylvain Corlay and Wolf Vollprecht    *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XFRAME_XSENTINEL_HPP
+#define XFRAME_XSENTINEL_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#include "xtl/xoptional.hpp"
+#include "xtensor/xarray.hpp"
+#include "xtensor/xoptional.hpp"
+#include "xtensor/xoptional_assembly.hpp"
+
+#include "xmissing_flags.hpp"
+
+namespace xf
+{
+
+    /********************
+     * xsentinel_traits *
+     ********************/
+
+    /**
+     * @class xsentinel_traits
+     * @brief Default encoding of missing values in an xsentinel_vector.
+     *
+     * Missing floating point values are stored as quiet NaN. Integral types
+     * have no spare value to encode missingness, their sentinel must be
+     * chosen explicitly with xsentinel_value (see also xsentinel_data_traits).
+     */
+    template <class T>
+    struct xsentinel_traits
+    {
+        static_assert(std::is_floating_point<T>::value,
+                      "xsentinel_traits only encodes floating point values, use xsentinel_value for integral types");
+
+        static T value() noexcept
+        {
+            return std::numeric_limits<T>::quiet_NaN();
+        }
+
+        static bool is_sentinel(const T& v) noexcept
+        {
+            return std::isnan(v);
+        }
+    };
+
+    /**
+     * @class xsentinel_value
+     * @brief Encoding of missing integral values with a user defined sentinel.
+     *
+     * The sentinel V remains a valid value of T: storing V marks the element
+     * as missing, and a computation resulting in V produces a missing value.
+     * V should therefore be chosen out of the range of the data.
+     */
+    template <class T, T V>
+    struct xsentinel_value
+    {
+        static constexpr T value() noexcept
+        {
+            return V;
+        }
+
+        static constexpr bool is_sentinel(const T& v) noexcept
+        {
+            return v == V;
+        }
+    };
+
+    /******************
+     * xsentinel_flag *
+     ******************/
+
+    /**
+     * @class xsentinel_flag
+     * @brief Proxy on the missing flag of a sentinel-encoded value.
+     *
+     * Reading the flag compares the value with the sentinel; unsetting
+     * it overwrites the value with the sentinel.
+     */
+    template <class T, class S>
+    class xsentinel_flag
+    {
+    public:
+
+        explicit xsentinel_flag(T& value) noexcept;
+        xsentinel_flag(const xsentinel_flag&) = default;
+
+        operator bool() const noexcept;
+
+        xsentinel_flag& operator=(bool flag) noexcept;
+        xsentinel_flag& operator=(const xsentinel_flag& rhs) noexcept;
+
+    private:
+
+        T* p_value;
+    };
+
+    /**********************
+     * xsentinel_iterator *
+     **********************/
+
+    namespace detail
+    {
+        // Iterates over the optional values of a sentinel-encoded buffer,
+        // or over their missing flags only if is_flag is true.
+        template <class T, class S, bool is_const, bool is_flag = false>
+        class xsentinel_iterator
+        {
+        public:
+
+            using self_type = xsentinel_iterator<T, S, is_const, is_flag>;
+            using raw_pointer = std::conditional_t<is_const, const T*, T*>;
+
+            using optional_reference = std::conditional_t<is_const,
+                                                          xtl::xoptional<const T&, bool>,
+                                                          xtl::xoptional<T&, xsentinel_flag<T, S>>>;
+            using flag_reference = std::conditional_t<is_const, bool, xsentinel_flag<T, S>>;
+
+            using value_type = std::conditional_t<is_flag, bool, xtl::xoptional<T, bool>>;
+            using reference = std::conditional_t<is_flag, flag_reference, optional_reference>;
+            using pointer = void;
+            using difference_type = std::ptrdiff_t;
+            using iterator_category = std::random_access_iterator_tag;
+
+            xsentinel_iterator() noexcept = default;
+            explicit xsentinel_iterator(raw_pointer p) noexcept;
+
+            template <bool C, class = std::enable_if_t<is_const && !C>>
+            xsentinel_iterator(const xsentinel_iterator<T, S, C, is_flag>& rhs) noexcept;
+
+            reference operator*() const noexcept;
+            reference operator[](difference_type n) const noexcept;
+
+            self_type& operator++() noexcept;
+            self_type& operator--() noexcept;
+            self_type operator++(int) noexcept;
+            self_type operator--(int) noexcept;
+            self_type& operator+=(difference_type n) noexcept;
+            self_type& operator-=(difference_type n) noexcept;
+
+            self_type operator+(difference_type n) const noexcept;
+            self_type operator-(difference_type n) const noexcept;
+            difference_type operator-(const self_type& rhs) const noexcept;
+
+            bool operator==(const self_type& rhs) const noexcept;
+            bool operator!=(const self_type& rhs) const noexcept;
+            bool operator<(const self_type& rhs) const noexcept;
+            bool operator<=(const self_type& rhs) const noexcept;
+            bool operator>(const self_type& rhs) const noexcept;
+            bool operator>=(const self_type& rhs) const noexcept;
+
+            raw_pointer base() const noexcept;
+
+        private:
+
+            static reference make_reference(const T& v, std::true_type, std::false_type) noexcept;
+            static reference make_reference(T& v, std::false_type, std::false_type) noexcept;
+            static reference make_reference(const T& v, std::true_type, std::true_type) noexcept;
+            static reference make_reference(T& v, std::false_type, std::true_type) noexcept;
+
+            raw_pointer p_value = nullptr;
+        };
+    }
+
+    /****************************
+     * xsentinel_flag_container *
+     ****************************/
+
+    /**
+     * @class xsentinel_flag_container
+     * @brief Sequence of the missing flags of an xsentinel_vector.
+     *
+     * The flags are not stored: they are read from the values of the
+     * underlying buffer, and unsetting one of them writes the sentinel.
+     */
+    template <class T, class S, class A>
+    class xsentinel_flag_container
+    {
+    public:
+
+        using raw_container = std::vector<T, A>;
+
+        using value_type = bool;
+        using reference = xsentinel_flag<T, S>;
+        using const_reference = bool;
+        using iterator = detail::xsentinel_iterator<T, S, false, true>;
+        using const_iterator = detail::xsentinel_iterator<T, S, true, true>;
+        using reverse_iterator = std::reverse_iterator<iterator>;
+        using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+        using pointer = iterator;
+        using const_pointer = const_iterator;
+        using size_type = typename raw_container::size_type;
+        using difference_type = typename raw_container::difference_type;
+
+        explicit xsentinel_flag_container(raw_container& values) noexcept;
+
+        xsentinel_flag_container(const xsentinel_flag_container&) = delete;
+        xsentinel_flag_container& operator=(const xsentinel_flag_container&) = delete;
+
+        bool empty() const noexcept;
+        size_type size() const noexcept;
+        void resize(size_type size);
+
+        reference operator[](size_type i) noexcept;
+        const_reference operator[](size_type i) const noexcept;
+
+        iterator begin() noexcept;
+        iterator end() noexcept;
+        const_iterator begin() const noexcept;
+        const_iterator end() const noexcept;
+        const_iterator cbegin() const noexcept;
+        const_iterator cend() const noexcept;
+
+        reverse_iterator rbegin() noexcept;
+        reverse_iterator rend() noexcept;
+        const_reverse_iterator rbegin() const noexcept;
+        const_reverse_iterator rend() const noexcept;
+        const_reverse_iterator crbegin() const noexcept;
+        const_reverse_iterator crend() const noexcept;
+
+    private:
+
+        raw_container* p_values;
+    };
+
+    /********************
+     * xsentinel_vector *
+     ********************/
+
+    /**
+     * @class xsentinel_vector
+     * @brief Storage of optional values encoding missing values in-band.
+     *
+     * The xsentinel_vector class stores optional values in a single buffer,
+     * a missing value being represented by a sentinel. Its references are
+     * xoptional objects, so that it can be used as the storage of an optional
+     * container (see xsentinel_array) in place of an optional assembly. This
+     * halves the memory traffic of element-wise operations, and the values
+     * can be handed as is to consumers expecting NaN-encoded missing values.
+     * Like the storage of an optional assembly, it exposes its values and
+     * its missing flags as separate containers through value() and has_value();
+     * the flags are computed from the values.
+     *
+     * @tparam T the value type.
+     * @tparam S the sentinel traits, see xsentinel_traits.
+     * @tparam A the allocator of the values.
+     */
+    template <class T, class S = xsentinel_traits<T>, class A = std::allocator<T>>
+    class xsentinel_vector
+    {
+    public:
+
+        using raw_container = std::vector<T, A>;
+        using sentinel_traits = S;
+        using value_container = raw_container;
+        using flag_container = xsentinel_flag_container<T, S, A>;
+        using base_container_type = value_container;
+        using flag_container_type = flag_container;
+
+        using value_type = xtl::xoptional<T, bool>;
+        using reference = xtl::xoptional<T&, xsentinel_flag<T, S>>;
+        using const_reference = xtl::xoptional<const T&, bool>;
+        using iterator = detail::xsentinel_iterator<T, S, false>;
+        using const_iterator = detail::xsentinel_iterator<T, S, true>;
+        using reverse_iterator = std::reverse_iterator<iterator>;
+        using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+        using pointer = iterator;
+        using const_pointer = const_iterator;
+        using size_type = typename raw_container::size_type;
+        using difference_type = typename raw_container::difference_type;
+        using allocator_type = A;
+
+        xsentinel_vector();
+        explicit xsentinel_vector(size_type size, const allocator_type& alloc = allocator_type());
+        xsentinel_vector(size_type size, const value_type& value, const allocator_type& alloc = allocator_type());
+        xsentinel_vector(std::initializer_list<value_type> init, const allocator_type& alloc = allocator_type());
+
+        template <class It, class = std::enable_if_t<!std::is_integral<It>::value>>
+        xsentinel_vector(It first, It last, const allocator_type& alloc = allocator_type());
+
+        xsentinel_vector(const xsentinel_vector& rhs);
+        xsentinel_vector(xsentinel_vector&& rhs) noexcept;
+        xsentinel_vector& operator=(const xsentinel_vector& rhs);
+        xsentinel_vector& operator=(xsentinel_vector&& rhs) noexcept;
+
+        allocator_type get_allocator() const noexcept;
+
+        bool empty() const noexcept;
+        size_type size() const noexcept;
+        size_type max_size() const noexcept;
+        void resize(size_type size);
+        void resize(size_type size, const value_type& value);
+        void swap(xsentinel_vector& rhs) noexcept;
+
+        reference operator[](size_type i) noexcept;
+        const_reference operator[](size_type i) const noexcept;
+
+        reference front() noexcept;
+        const_reference front() const noexcept;
+        reference back() noexcept;
+        const_reference back() const noexcept;
+
+        iterator begin() noexcept;
+        iterator end() noexcept;
+        const_iterator begin() const noexcept;
+        const_iterator end() const noexcept;
+        const_iterator cbegin() const noexcept;
+        const_iterator cend() const noexcept;
+
+        reverse_iterator rbegin() noexcept;
+        reverse_iterator rend() noexcept;
+        const_reverse_iterator rbegin() const noexcept;
+        const_reverse_iterator rend() const noexcept;
+        const_reverse_iterator crbegin() const noexcept;
+        const_reverse_iterator crend() const noexcept;
+
+        raw_container& values() noexcept;
+        const raw_container& values() const noexcept;
+
+        value_container& value() noexcept;
+        const value_container& value() const noexcept;
+        flag_container& has_value() noexcept;
+        const flag_container& has_value() const noexcept;
+
+        bool all_valid() const noexcept;
+
+    private:
+
+        static T encode(const value_type& value) noexcept;
+
+        raw_container m_values;
+        flag_container m_flags;
+    };
+
+    template <class T, class S, class A>
+    bool operator==(const xsentinel_vector<T, S, A>& lhs, const xsentinel_vector<T, S, A>& rhs) noexcept;
+
+    template <class T, class S, class A>
+    bool operator!=(const xsentinel_vector<T, S, A>& lhs, const xsentinel_vector<T, S, A>& rhs) noexcept;
+
+    /**
+     * Optional container storing missing values as sentinels, usable
+     * in place of an optional assembly as the data of a variable.
+     */
+    template <class T, class S = xsentinel_traits<T>>
+    using xsentinel_array = xt::xarray_container<xsentinel_vector<T, S>,
+                                                 XTENSOR_DEFAULT_LAYOUT,
+                                                 xt::dynamic_shape<std::size_t>,
+                                                 xt::xoptional_expression_tag>;
+
+    /**
+     * @class xsentinel_data_traits
+     * @brief Sentinel encoding used by the data containers of the sentinel
+     * configuration.
+     *
+     * The nested type is the sentinel traits of T, or void if T has no
+     * sentinel. Floating point values are encoded with NaN; integral types
+     * have none by default, and can be given one by specializing this class:
+     * @code
+     * template <>
+     * struct xsentinel_data_traits<int>
+     * {
+     *     using type = xsentinel_value<int, std::numeric_limits<int>::lowest()>;
+     * };
+     * @endcode
+     */
+    template <class T>
+    struct xsentinel_data_traits
+    {
+        using type = std::conditional_t<std::is_floating_point<T>::value, xsentinel_traits<T>, void>;
+    };
+
+    namespace detail
+    {
+        template <class T, class S>
+        struct sentinel_data_container
+        {
+            using type = xsentinel_array<T, S>;
+        };
+
+        template <class T>
+        struct sentinel_data_container<T, void>
+        {
+            using type = xt::xoptional_assembly<xt::xarray<T>, xt::xarray<bool>>;
+        };
+    }
+
+    /**
+     * Data container of the sentinel configuration: values are stored in an
+     * xsentinel_array if xsentinel_data_traits gives T a sentinel, otherwise
+     * they keep the optional assembly.
+     */
+    template <class T>
+    using xsentinel_data_container = typename detail::sentinel_data_container<T, typename xsentinel_data_traits<T>::type>::type;
+
+    /*********************************
+     * xsentinel_flag implementation *
+     *********************************/
+
+    template <class T, class S>
+    inline xsentinel_flag<T, S>::xsentinel_flag(T& value) noexcept
+        : p_value(&value)
+    {
+    }
+
+    template <class T, class S>
+    inline xsentinel_flag<T, S>::operator bool() const noexcept
+    {
+        return !S::is_sentinel(*p_value);
+    }
+
+    // Setting the flag of a missing value cannot restore the value; it is
+    // left to the assignment of the value itself.
+    template <class T, class S>
+    inline auto xsentinel_flag<T, S>::operator=(bool flag) noexcept -> xsentinel_flag&
+    {
+        if (!flag)
+        {
+            *p_value = S::value();
+        }
+        return *this;
+    }
+
+    template <class T, class S>
+    inline auto xsentinel_flag<T, S>::operator=(const xsentinel_flag& rhs) noexcept -> xsentinel_flag&
+    {
+        return *this = bool(rhs);
+    }
+
+    /*************************************
+     * xsentinel_iterator implementation *
+     *************************************/
+
+    namespace detail
+    {
+        template <class T, class S, bool is_const, bool is_flag>
+        inline xsentinel_iterator<T, S, is_const, is_flag>::xsentinel_iterator(raw_pointer p) noexcept
+            : p_value(p)
+        {
+        }
+
+        template <class T, class S, bool is_const, bool is_flag>
+        template <bool C, class>
+        inline xsentinel_iterator<T, S, is_const, is_flag>::xsentinel_iterator(const xsentinel_iterator<T, S, C, is_flag>& rhs) noexcept
+            : p_value(rhs.base())
+        {
+        }
+
+        template <class T, class S, bool is_const, bool is_flag>
+        inline auto xsentinel_iterator<T, S, is_const, is_flag>::make_reference(const T& v, std::true_type, std::false_type) noexcept -> reference
+        {
+            return reference(v, !S::is_sentinel(v));
+        }
+
+        template <class T, class S, bool is_const, bool is_flag>
+        inline auto xsentinel_iterator<T, S, is_const, is_flag>::make_reference(T& v, std::false_type, std::false_type) noexcept -> reference
+        {
+            return reference(v, xsentinel_flag<T, S>(v));
+        }
+
+        template <class T, class S, bool is_const, bool is_flag>
+        inline auto xsentinel_iterator<T, S, is_const, is_flag>::make_reference(const T& v, std::true_type, std::true_type) noexcept -> reference
+        {
+            return !S::is_sentinel(v);
+        }
+
+        template <class T, class S, bool is_const, bool is_flag>
+        inline auto xsentinel_iterator<T, S, is_const, is_flag>::make_reference(T& v, std::false_type, std::true_type) noexcept -> reference
+        {
+            return xsentinel_flag<T, S>(v);
+        }
+
+        template <class T, class S, bool is_const, bool is_flag>
+        inline auto xsentinel_iterator<T, S, is_const, is_flag>::operator*() const noexcept -> reference
+        {
+            return make_reference(*p_value, std::integral_constant<bool, is_const>(), std::integral_constant<bool, is_flag>());
+        }
+
+        template <class T, class S, bool is_const, bool is_flag>
+        inline auto xsentinel_iterator<T, S, is_const, is_flag>::operator[](difference_type n) const noexcept -> reference
+        {
+            return make_reference(p_value[n], std::integral_constant<bool, is_const>(), std::integral_constant<bool, is_flag>());
+        }
+
+        template <class T, class S, bool is_const, bool is_flag>
+        inline auto xsentinel_iterator<T, S, is_const, is_flag>::operator++() noexcept -> self_type&
+        {
+            ++p_value;
+            return *this;
+        }
+
+        template <class T, class S, bool is_const, bool is_flag>
+        inline auto xsentinel_iterator<T, S, is_const, is_flag>::operator--() noexcept -> self_type&
+        {
+            --p_value;
+            return *this;
+        }
+
+        template <class T, class S, bool is_const, bool is_flag>
+        inline auto xsentinel_iterator<T, S, is_const, is_flag>::operator++(int) noexcept -> self_type
+        {
+            self_type tmp(*this);
+            ++p_value;
+            return tmp;
+        }
+
+        template <class T, class S, bool is_const, bool is_flag>
+        inline auto xsentinel_iterator<T, S, is_const, is_flag>::operator--(int) noexcept -> self_type
+        {
+            self_type tmp(*this);
+            --p_value;
+            return tmp;
+        }
+
+        template <class T, class S, bool is_const, bool is_flag>
+        inline auto xsentinel_iterator<T, S, is_const, is_flag>::operator+=(difference_type n) noexcept -> self_type&
+        {
+            p_value += n;
+            return *this;
+        }
+
+        template <class T, class S, bool is_const, bool is_flag>
+        inline auto xsentinel_iterator<T, S, is_const, is_flag>::operator-=(difference_type n) noexcept -> self_type&
+        {
+            p_value -= n;
+            return *this;
+        }
+
+        template <class T, class S, bool is_const, bool is_flag>
+        inline auto xsentinel_iterator<T, S, is_const, is_flag>::operator+(difference_type n) const noexcept -> self_type
+        {
+            return self_type(p_value + n);
+        }
+
+        template <class T, class S, bool is_const, bool is_flag>
+        inline auto xsentinel_iterator<T, S, is_const, is_flag>::operator-(difference_type n) const noexcept -> self_type
+        {
+            return self_type(p_value - n);
+        }
+
+        template <class T, class S, bool is_const, bool is_flag>
+        inline auto xsentinel_iterator<T, S, is_const, is_flag>::operator-(const self_type& rhs) const noexcept -> difference_type
+        {
+            return p_value - rhs.p_value;
+        }
+
+        template <class T, class S, bool is_const, bool is_flag>
+        inline bool xsentinel_iterator<T, S, is_const, is_flag>::operator==(const self_type& rhs) const noexcept
+        {
+            return p_value == rhs.p_value;
+        }
+
+        template <class T, class S, bool is_const, bool is_flag>
+        inline bool xsentinel_iterator<T, S, is_const, is_flag>::operator!=(const self_type& rhs) const noexcept
+        {
+            return p_value != rhs.p_value;
+        }
+
+        template <class T, class S, bool is_const, bool is_flag>
+        inline bool xsentinel_iterator<T, S, is_const, is_flag>::operator<(const self_type& rhs) const noexcept
+        {
+            return p_value < rhs.p_value;
+        }
+
+        template <class T, class S, bool is_const, bool is_flag>
+        inline bool xsentinel_iterator<T, S, is_const, is_flag>::operator<=(const self_type& rhs) const noexcept
+        {
+            return p_value <= rhs.p_value;
+        }
+
+        template <class T, class S, bool is_const, bool is_flag>
+        inline bool xsentinel_iterator<T, S, is_const, is_flag>::operator>(const self_type& rhs) const noexcept
+        {
+            return p_value > rhs.p_value;
+        }
+
+        template <class T, class S, bool is_const, bool is_flag>
+        inline bool xsentinel_iterator<T, S, is_const, is_flag>::operator>=(const self_type& rhs) const noexcept
+        {
+            return p_value >= rhs.p_value;
+        }
+
+        template <class T, class S, bool is_const, bool is_flag>
+        inline auto xsentinel_iterator<T, S, is_const, is_flag>::base() const noexcept -> raw_pointer
+        {
+            return p_value;
+        }
+
+        template <class T, class S, bool is_const, bool is_flag>
+        inline xsentinel_iterator<T, S, is_const, is_flag>
+        operator+(typename xsentinel_iterator<T, S, is_const, is_flag>::difference_type n,
+                  const xsentinel_iterator<T, S, is_const, is_flag>& it) noexcept
+        {
+            return it + n;
+        }
+    }
+
+    /*******************************************
+     * xsentinel_flag_container implementation *
+     *******************************************/
+
+    template <class T, class S, class A>
+    inline xsentinel_flag_container<T, S, A>::xsentinel_flag_container(raw_container& values) noexcept
+        : p_values(&values)
+    {
+    }
+
+    template <class T, class S, class A>
+    inline bool xsentinel_flag_container<T, S, A>::empty() const noexcept
+    {
+        return p_values->empty();
+    }
+
+    template <class T, class S, class A>
+    inline auto xsentinel_flag_container<T, S, A>::size() const noexcept -> size_type
+    {
+        return p_values->size();
+    }
+
+    // The flags cannot be resized apart from the values; new elements are
+    // missing, as when resizing the xsentinel_vector.
+    template <class T, class S, class A>
+    inline void xsentinel_flag_container<T, S, A>::resize(size_type size)
+    {
+        p_values->resize(size, S::value());
+    }
+
+    template <class T, class S, class A>
+    inline auto xsentinel_flag_container<T, S, A>::operator[](size_type i) noexcept -> reference
+    {
+        return reference((*p_values)[i]);
+    }
+
+    template <class T, class S, class A>
+    inline auto xsentinel_flag_container<T, S, A>::operator[](size_type i) const noexcept -> const_reference
+    {
+        return !S::is_sentinel((*p_values)[i]);
+    }
+
+    template <class T, class S, class A>
+    inline auto xsentinel_flag_container<T, S, A>::begin() noexcept -> iterator
+    {
+        return iterator(p_values->data());
+    }
+
+    template <class T, class S, class A>
+    inline auto xsentinel_flag_container<T, S, A>::end() noexcept -> iterator
+    {
+        return iterator(p_values->data() + p_values->size());
+    }
+
+    template <class T, class S, class A>
+    inline auto xsentinel_flag_container<T, S, A>::begin() const noexcept -> const_iterator
+    {
+        return cbegin();
+    }
+
+    template <class T, class S, class A>
+    inline auto xsentinel_flag_container<T, S, A>::end() const noexcept -> const_iterator
+    {
+        return cend();
+    }
+
+    template <class T, class S, class A>
+    inline auto xsentinel_flag_container<T, S, A>::cbegin() const noexcept -> const_iterator
+    {
+        return const_iterator(p_values->data());
+    }
+
+    template <class T, class S, class A>
+    inline auto xsentinel_flag_container<T, S, A>::cend() const noexcept -> const_iterator
+    {
+        return const_iterator(p_values->data() + p_values->size());
+    }
+
+    template <class T, class S, class A>
+    inline auto xsentinel_flag_container<T, S, A>::rbegin() noexcept -> reverse_iterator
+    {
+        return reverse_iterator(end());
+    }
+
+    template <class T, class S, class A>
+    inline auto xsentinel_flag_container<T, S, A>::rend() noexcept -> reverse_iterator
+    {
+        return reverse_iterator(begin());
+    }
+
+    template <class T, class S, class A>
+    inline auto xsentinel_flag_container<T, S, A>::rbegin() const noexcept -> const_reverse_iterator
+    {
+        return crbegin();
+    }
+
+    template <class T, class S, class A>
+    inline auto xsentinel_flag_container<T, S, A>::rend() const noexcept -> const_reverse_iterator
+    {
+        return crend();
+    }
+
+    template <class T, class S, class A>
+    inline auto xsentinel_flag_container<T, S, A>::crbegin() const noexcept -> const_reverse_iterator
+    {
+        return const_reverse_iterator(cend());
+    }
+
+    template <class T, class S, class A>
+    inline auto xsentinel_flag_container<T, S, A>::crend() const noexcept -> const_reverse_iterator
+    {
+        return const_reverse_iterator(cbegin());
+    }
+
+    /***********************************
+     * xsentinel_vector implementation *
+     ***********************************/
+
+    template <class T, class S, class A>
+    inline xsentinel_vector<T, S, A>::xsentinel_vector()
+        : m_values(), m_flags(m_values)
+    {
+    }
+
+    template <class T, class S, class A>
+    inline xsentinel_vector<T, S, A>::xsentinel_vector(size_type size, const allocator_type& alloc)
+        : m_values(size, S::value(), alloc), m_flags(m_values)
+    {
+    }
+
+    template <class T, class S, class A>
+    inline xsentinel_vector<T, S, A>::xsentinel_vector(size_type size, const value_type& value, const allocator_type& alloc)
+        : m_values(size, encode(value), alloc), m_flags(m_values)
+    {
+    }
+
+    template <class T, class S, class A>
+    inline xsentinel_vector<T, S, A>::xsentinel_vector(std::initializer_list<value_type> init, const allocator_type& alloc)
+        : xsentinel_vector(init.begin(), init.end(), alloc)
+    {
+    }
+
+    template <class T, class S, class A>
+    template <class It, class>
+    inline xsentinel_vector<T, S, A>::xsentinel_vector(It first, It last, const allocator_type& alloc)
+        : m_values(alloc), m_flags(m_values)
+    {
+        m_values.reserve(static_cast<size_type>(std::distance(first, last)));
+        std::transform(first, last, std::back_inserter(m_values), [](const auto& v) { return encode(value_type(v)); });
+    }
+
+    // The flag container refers to the values of its own vector; it is
+    // never copied nor moved.
+    template <class T, class S, class A>
+    inline xsentinel_vector<T, S, A>::xsentinel_vector(const xsentinel_vector& rhs)
+        : m_values(rhs.m_values), m_flags(m_values)
+    {
+    }
+
+    template <class T, class S, class A>
+    inline xsentinel_vector<T, S, A>::xsentinel_vector(xsentinel_vector&& rhs) noexcept
+        : m_values(std::move(rhs.m_values)), m_flags(m_values)
+    {
+    }
+
+    template <class T, class S, class A>
+    inline auto xsentinel_vector<T, S, A>::operator=(const xsentinel_vector& rhs) -> xsentinel_vector&
+    {
+        m_values = rhs.m_values;
+        return *this;
+    }
+
+    template <class T, class S, class A>
+    inline auto xsentinel_vector<T, S, A>::operator=(xsentinel_vector&& rhs) noexcept -> xsentinel_vector&
+    {
+        m_values = std::move(rhs.m_values);
+        return *this;
+    }
+
+    template <class T, class S, class A>
+    inline auto xsentinel_vector<T, S, A>::get_allocator() const noexcept -> allocator_type
+    {
+        return m_values.get_allocator();
+    }
+
+    template <class T, class S, class A>
+    inline bool xsentinel_vector<T, S, A>::empty() const noexcept
+    {
+        return m_values.empty();
+    }
+
+    template <class T, class S, class A>
+    inline auto xsentinel_vector<T, S, A>::size() const noexcept -> size_type
+    {
+        return m_values.size();
+    }
+
+    template <class T, class S, class A>
+    inline auto xsentinel_vector<T, S, A>::max_size() const noexcept -> size_type
+    {
+        return m_values.max_size();
+    }
+
+    // New elements are missing, like the new flags of an optional assembly
+    // are not set.
+    template <class T, class S, class A>
+    inline void xsentinel_vector<T, S, A>::resize(size_type size)
+    {
+        m_values.resize(size, S::value());
+    }
+
+    template <class T, class S, class A>
+    inline void xsentinel_vector<T, S, A>::resize(size_type size, const value_type& value)
+    {
+        m_values.resize(size, encode(value));
+    }
+
+    template <class T, class S, class A>
+    inline void xsentinel_vector<T, S, A>::swap(xsentinel_vector& rhs) noexcept
+    {
+        m_values.swap(rhs.m_values);
+    }
+
+    template <class T, class S, class A>
+    inline auto xsentinel_vector<T, S, A>::operator[](size_type i) noexcept -> reference
+    {
+        return begin()[static_cast<difference_type>(i)];
+    }
+
+    template <class T, class S, class A>
+    inline auto xsentinel_vector<T, S, A>::operator[](size_type i) const noexcept -> const_reference
+    {
+        return cbegin()[static_cast<difference_type>(i)];
+    }
+
+    template <class T, class S, class A>
+    inline auto xsentinel_vector<T, S, A>::front() noexcept -> reference
+    {
+        return (*this)[0];
+    }
+
+    template <class T, class S, class A>
+    inline auto xsentinel_vector<T, S, A>::front() const noexcept -> const_reference
+    {
+        return (*this)[0];
+    }
+
+    template <class T, class S, class A>
+    inline auto xsentinel_vector<T, S, A>::back() noexcept -> reference
+    {
+        return (*this)[size() - 1];
+    }
+
+    template <class T, class S, class A>
+    inline auto xsentinel_vector<T, S, A>::back() const noexcept -> const_reference
+    {
+        return (*this)[size() - 1];
+    }
+
+    template <class T, class S, class A>
+    inline auto xsentinel_vector<T, S, A>::begin() noexcept -> iterator
+    {
+        return iterator(m_values.data());
+    }
+
+    template <class T, class S, class A>
+    inline auto xsentinel_vector<T, S, A>::end() noexcept -> iterator
+    {
+        return iterator(m_values.data() + m_values.size());
+    }
+
+    template <class T, class S, class A>
+    inline auto xsentinel_vector<T, S, A>::begin() const noexcept -> const_iterator
+    {
+        return cbegin();
+    }
+
+    template <class T, class S, class A>
+    inline auto xsentinel_vector<T, S, A>::end() const noexcept -> const_iterator
+    {
+        return cend();
+    }
+
+    template <class T, class S, class A>
+    inline auto xsentinel_vector<T, S, A>::cbegin() const noexcept -> const_iterator
+    {
+        return const_iterator(m_values.data());
+    }
+
+    template <class T, class S, class A>
+    inline auto xsentinel_vector<T, S, A>::cend() const noexcept -> const_iterator
+    {
+        return const_iterator(m_values.data() + m_values.size());
+    }
+
+    template <class T, class S, class A>
+    inline auto xsentinel_vector<T, S, A>::rbegin() noexcept -> reverse_iterator
+    {
+        return reverse_iterator(end());
+    }
+
+    template <class T, class S, class A>
+    inline auto xsentinel_vector<T, S, A>::rend() noexcept -> reverse_iterator
+    {
+        return reverse_iterator(begin());
+    }
+
+    template <class T, class S, class A>
+    inline auto xsentinel_vector<T, S, A>::rbegin() const noexcept -> const_reverse_iterator
+    {
+        return crbegin();
+    }
+
+    template <class T, class S, class A>
+    inline auto xsentinel_vector<T, S, A>::rend() const noexcept -> const_reverse_iterator
+    {
+        return crend();
+    }
+
+    template <class T, class S, class A>
+    inline auto xsentinel_vector<T, S, A>::crbegin() const noexcept -> const_reverse_iterator
+    {
+        return const_reverse_iterator(cend());
+    }
+
+    template <class T, class S, class A>
+    inline auto xsentinel_vector<T, S, A>::crend() const noexcept -> const_reverse_iterator
+    {
+        return const_reverse_iterator(cbegin());
+    }
+
+    /**
+     * Returns the buffer of encoded values, where missing values are
+     * represented by the sentinel.
+     */
+    template <class T, class S, class A>
+    inline auto xsentinel_vector<T, S, A>::values() noexcept -> raw_container&
+    {
+        return m_values;
+    }
+
+    template <class T, class S, class A>
+    inline auto xsentinel_vector<T, S, A>::values() const noexcept -> const raw_container&
+    {
+        return m_values;
+    }
+
+    /**
+     * Returns the container of the values; missing values hold the sentinel.
+     */
+    template <class T, class S, class A>
+    inline auto xsentinel_vector<T, S, A>::value() noexcept -> value_container&
+    {
+        return m_values;
+    }
+
+    template <class T, class S, class A>
+    inline auto xsentinel_vector<T, S, A>::value() const noexcept -> const value_container&
+    {
+        return m_values;
+    }
+
+    /**
+     * Returns the container of the missing flags, computed from the values.
+     */
+    template <class T, class S, class A>
+    inline auto xsentinel_vector<T, S, A>::has_value() noexcept -> flag_container&
+    {
+        return m_flags;
+    }
+
+    template <class T, class S, class A>
+    inline auto xsentinel_vector<T, S, A>::has_value() const noexcept -> const flag_container&
+    {
+        return m_flags;
+    }
+
+    /**
+     * Returns true if no value is missing.
+     */
+    template <class T, class S, class A>
+    inline bool xsentinel_vector<T, S, A>::all_valid() const noexcept
+    {
+        return std::none_of(m_values.cbegin(), m_values.cend(), [](const T& v) { return S::is_sentinel(v); });
+    }
+
+    template <class T, class S, class A>
+    inline T xsentinel_vector<T, S, A>::encode(const value_type& value) noexcept
+    {
+        return value.has_value() ? value.value() : S::value();
+    }
+
+    template <class T, class S, class A>
+    inline bool operator==(const xsentinel_vector<T, S, A>& lhs, const xsentinel_vector<T, S, A>& rhs) noexcept
+    {
+        return lhs.size() == rhs.size() && std::equal(lhs.cbegin(), lhs.cend(), rhs.cbegin(),
+            [](const auto& l, const auto& r) { return l.has_value() ? (r.has_value() && l.value() == r.value()) : !r.has_value(); });
+    }
+
+    template <class T, class S, class A>
+    inline bool operator!=(const xsentinel_vector<T, S, A>& lhs, const xsentinel_vector<T, S, A>& rhs) noexcept
+    {
+        return !(lhs == rhs);
+    }
+
+    template <class T, class S, class A>
+    inline void swap(xsentinel_vector<T, S, A>& lhs, xsentinel_vector<T, S, A>& rhs) noexcept
+    {
+        lhs.swap(rhs);
+    }
+
+    /*************************
+     * missing flags helpers *
+     *************************/
+
+    namespace detail
+    {
+        // Flags of sentinel-encoded containers are derived from the values,
+        // so that they never need to be written.
+        template <class T, class S, class A, xt::layout_type L, class SC, class Tag>
+        struct missing_flags_traits<xt::xarray_container<xsentinel_vector<T, S, A>, L, SC, Tag>>
+        {
+            using data_type = xt::xarray_container<xsentinel_vector<T, S, A>, L, SC, Tag>;
+
+            static bool all_set(const data_type& data)
+            {
+                return data.data().all_valid();
+            }
+
+            static void set_all(data_type&) noexcept
+            {
+            }
+        };
+    }
+}
+
+#endif
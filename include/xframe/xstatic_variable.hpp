@@ -0,0 +1,836 @@
+/***************************************************************************
+* Copyright (c) 2017, Johan Mabille, Sylvain Corlay and Wolf Vollprecht    *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XFRAME_XSTATIC_VARIABLE_HPP
+#define XFRAME_XSTATIC_VARIABLE_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <map>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "xtensor/xoptional_assembly.hpp"
+#include "xtensor/xtensor.hpp"
+
+#include "xaxis_variant.hpp"
+#include "xcoordinate.hpp"
+#include "xvariable.hpp"
+
+/**
+ * Defines a dimension tag named NAME, whose label is "NAME".
+ */
+#define XFRAME_STATIC_DIMENSION(NAME)                   \
+    struct NAME                                         \
+    {                                                   \
+        static const char* name() noexcept              \
+        {                                               \
+            return #NAME;                               \
+        }                                               \
+    };
+
+namespace xf
+{
+
+    /*********************
+     * xstatic_dimension *
+     *********************/
+
+    namespace detail
+    {
+        template <class T, class... D>
+        struct static_contains;
+
+        template <class T>
+        struct static_contains<T> : std::false_type
+        {
+        };
+
+        template <class T, class D0, class... D>
+        struct static_contains<T, D0, D...>
+            : std::integral_constant<bool, std::is_same<T, D0>::value || static_contains<T, D...>::value>
+        {
+        };
+
+        template <class T, class... D>
+        struct static_index;
+
+        template <class T>
+        struct static_index<T>
+        {
+            static_assert(sizeof(T) == 0, "dimension not found in xstatic_dimension");
+        };
+
+        template <class T, class... D>
+        struct static_index<T, T, D...> : std::integral_constant<std::size_t, 0>
+        {
+        };
+
+        template <class T, class D0, class... D>
+        struct static_index<T, D0, D...> : std::integral_constant<std::size_t, 1 + static_index<T, D...>::value>
+        {
+        };
+    }
+
+    /**
+     * @class xstatic_dimension
+     * @brief Compile-time list of dimension tags.
+     *
+     * Dimension tags are types providing a static name() method, usually
+     * defined with XFRAME_STATIC_DIMENSION.
+     *
+     * @tparam D the dimension tags, in the order of the dimensions of the data.
+     */
+    template <class... D>
+    struct xstatic_dimension
+    {
+        static constexpr std::size_t size() noexcept
+        {
+            return sizeof...(D);
+        }
+
+        template <class T>
+        static constexpr bool contains() noexcept
+        {
+            return detail::static_contains<T, D...>::value;
+        }
+
+        template <class T>
+        static constexpr std::size_t index_of() noexcept
+        {
+            return detail::static_index<T, D...>::value;
+        }
+
+        template <class K>
+        static std::vector<K> labels()
+        {
+            return std::vector<K>({K(D::name())...});
+        }
+    };
+
+    namespace detail
+    {
+        template <class D1, class D2>
+        struct static_union;
+
+        template <class... D1>
+        struct static_union<xstatic_dimension<D1...>, xstatic_dimension<>>
+        {
+            using type = xstatic_dimension<D1...>;
+        };
+
+        template <class... D1, class D20, class... D2>
+        struct static_union<xstatic_dimension<D1...>, xstatic_dimension<D20, D2...>>
+        {
+            using head_type = std::conditional_t<static_contains<D20, D1...>::value,
+                                                 xstatic_dimension<D1...>,
+                                                 xstatic_dimension<D1..., D20>>;
+            using type = typename static_union<head_type, xstatic_dimension<D2...>>::type;
+        };
+    }
+
+    /**
+     * Dimensions of the result of an operation between variables with the
+     * dimensions D1 and D2: the dimensions of D1 followed by the ones of D2
+     * that D1 does not contain.
+     */
+    template <class D1, class D2>
+    using static_union_t = typename detail::static_union<D1, D2>::type;
+
+    /********************
+     * xstatic_variable *
+     ********************/
+
+    template <class T, class DM, class S = std::size_t>
+    class xstatic_variable;
+
+    /**
+     * @class xstatic_variable
+     * @brief Variable with a static rank and compile-time dimension names.
+     *
+     * The xstatic_variable class holds its data in xtensor containers and
+     * resolves dimension names at compile time: selecting or broadcasting
+     * does not involve any lookup in a dimension mapping. It can be
+     * converted from and to an xvariable_container.
+     *
+     * @tparam T the value type.
+     * @tparam D the dimension tags.
+     * @tparam S the integer type used to represent positions in axes.
+     */
+    template <class T, class... D, class S>
+    class xstatic_variable<T, xstatic_dimension<D...>, S>
+    {
+    public:
+
+        static constexpr std::size_t rank = sizeof...(D);
+
+        using self_type = xstatic_variable<T, xstatic_dimension<D...>, S>;
+        using dimension_type = xstatic_dimension<D...>;
+        using value_type = T;
+        using data_type = xt::xoptional_assembly<xt::xtensor<T, rank>, xt::xtensor<bool, rank>>;
+        using reference = typename data_type::reference;
+        using const_reference = typename data_type::const_reference;
+        using size_type = std::size_t;
+        using shape_type = std::array<size_type, rank>;
+        using axis_type = xaxis_variant<XFRAME_DEFAULT_LABEL_LIST, S, hash_map_tag>;
+        using axis_list = std::array<axis_type, rank>;
+        using key_type = typename axis_type::key_type;
+        using name_type = fstring;
+        using coordinate_type = xcoordinate<name_type, XFRAME_DEFAULT_LABEL_LIST, S, hash_map_tag>;
+        using variable_type = xvariable_container<coordinate_type, XFRAME_DEFAULT_DATA_CONTAINER(T)>;
+
+        xstatic_variable() = default;
+        explicit xstatic_variable(const axis_list& axes);
+        xstatic_variable(const axis_list& axes, const data_type& data);
+        xstatic_variable(axis_list&& axes, data_type&& data);
+
+        template <class CCT, class ECT>
+        explicit xstatic_variable(const xvariable_container<CCT, ECT>& var);
+
+        const axis_list& axes() const noexcept;
+
+        template <class Dim>
+        const axis_type& axis() const noexcept;
+
+        shape_type shape() const noexcept;
+        size_type size() const noexcept;
+
+        data_type& data() noexcept;
+        const data_type& data() const noexcept;
+
+        template <class... Args>
+        reference locate(Args&&... labels);
+
+        template <class... Args>
+        const_reference locate(Args&&... labels) const;
+
+        template <class... Dims, class... Args>
+        reference select(Args&&... labels);
+
+        template <class... Dims, class... Args>
+        const_reference select(Args&&... labels) const;
+
+        template <class... Dims, class... Args>
+        reference iselect(Args... indices);
+
+        template <class... Dims, class... Args>
+        const_reference iselect(Args... indices) const;
+
+        variable_type to_variable() const;
+
+    private:
+
+        template <class... Dims, class... Args>
+        shape_type select_index(Args&&... labels) const;
+
+        template <class... Dims, class... Args>
+        static shape_type iselect_index(Args... indices) noexcept;
+
+        template <class... Args, std::size_t... I>
+        shape_type locate_index(std::index_sequence<I...>, Args&&... labels) const;
+
+        void check_shape() const;
+
+        axis_list m_axes;
+        data_type m_data;
+    };
+
+    template <class T, class... D, class S>
+    constexpr std::size_t xstatic_variable<T, xstatic_dimension<D...>, S>::rank;
+
+    template <class T, class DM, class S>
+    bool operator==(const xstatic_variable<T, DM, S>& lhs, const xstatic_variable<T, DM, S>& rhs);
+
+    template <class T, class DM, class S>
+    bool operator!=(const xstatic_variable<T, DM, S>& lhs, const xstatic_variable<T, DM, S>& rhs);
+
+    /***********************************
+     * xstatic_variable implementation *
+     ***********************************/
+
+    namespace detail
+    {
+        template <std::size_t N, class SH>
+        inline bool increment_static_index(const SH& shape, std::array<std::size_t, N>& index) noexcept
+        {
+            std::size_t i = N;
+            while (i != 0)
+            {
+                --i;
+                if (++index[i] != shape[i])
+                {
+                    return true;
+                }
+                index[i] = 0;
+            }
+            return false;
+        }
+
+        template <class A, std::size_t N>
+        inline std::array<std::size_t, N> static_shape(const std::array<A, N>& axes) noexcept
+        {
+            std::array<std::size_t, N> res;
+            std::transform(axes.cbegin(), axes.cend(), res.begin(), [](const A& a) { return a.size(); });
+            return res;
+        }
+
+        inline bool static_shape_empty(const std::array<std::size_t, 0>&) noexcept
+        {
+            return false;
+        }
+
+        template <std::size_t N>
+        inline bool static_shape_empty(const std::array<std::size_t, N>& shape) noexcept
+        {
+            return std::find(shape.cbegin(), shape.cend(), std::size_t(0)) != shape.cend();
+        }
+    }
+
+    /**
+     * @name Constructors
+     */
+    //@{
+    /**
+     * Constructs a variable with the given axes; the data is uninitialized.
+     * @param axes the axes, in the order of the dimension tags.
+     */
+    template <class T, class... D, class S>
+    inline xstatic_variable<T, xstatic_dimension<D...>, S>::xstatic_variable(const axis_list& axes)
+        : m_axes(axes), m_data(detail::static_shape(axes))
+    {
+    }
+
+    /**
+     * Constructs a variable with the given axes and data.
+     * @param axes the axes, in the order of the dimension tags.
+     * @param data the data, whose shape must match the axes.
+     */
+    template <class T, class... D, class S>
+    inline xstatic_variable<T, xstatic_dimension<D...>, S>::xstatic_variable(const axis_list& axes, const data_type& data)
+        : m_axes(axes), m_data(data)
+    {
+        check_shape();
+    }
+
+    template <class T, class... D, class S>
+    inline xstatic_variable<T, xstatic_dimension<D...>, S>::xstatic_variable(axis_list&& axes, data_type&& data)
+        : m_axes(std::move(axes)), m_data(std::move(data))
+    {
+        check_shape();
+    }
+
+    /**
+     * Converts an xvariable_container. The variable must have exactly the
+     * dimensions D, in any order; its data is transposed to the order of D.
+     */
+    template <class T, class... D, class S>
+    template <class CCT, class ECT>
+    inline xstatic_variable<T, xstatic_dimension<D...>, S>::xstatic_variable(const xvariable_container<CCT, ECT>& var)
+        : m_axes({{axis_type(var.coordinates()[name_type(D::name())])...}}), m_data()
+    {
+        if (var.dimension() != rank)
+        {
+            throw std::runtime_error("Incompatible dimensions in xstatic_variable conversion");
+        }
+        shape_type pos = {{var.dimension_mapping()[name_type(D::name())]...}};
+        shape_type sh = shape();
+        m_data.resize(sh);
+        if (detail::static_shape_empty(sh))
+        {
+            return;
+        }
+        shape_type index = {};
+        shape_type src_index = {};
+        do
+        {
+            for (std::size_t i = 0; i < rank; ++i)
+            {
+                src_index[pos[i]] = index[i];
+            }
+            m_data.element(index.cbegin(), index.cend()) = var.data().element(src_index.cbegin(), src_index.cend());
+        }
+        while (detail::increment_static_index(sh, index));
+    }
+    //@}
+
+    /**
+     * Returns the axes, in the order of the dimension tags.
+     */
+    template <class T, class... D, class S>
+    inline auto xstatic_variable<T, xstatic_dimension<D...>, S>::axes() const noexcept -> const axis_list&
+    {
+        return m_axes;
+    }
+
+    /**
+     * Returns the axis of the dimension Dim.
+     */
+    template <class T, class... D, class S>
+    template <class Dim>
+    inline auto xstatic_variable<T, xstatic_dimension<D...>, S>::axis() const noexcept -> const axis_type&
+    {
+        return std::get<dimension_type::template index_of<Dim>()>(m_axes);
+    }
+
+    template <class T, class... D, class S>
+    inline auto xstatic_variable<T, xstatic_dimension<D...>, S>::shape() const noexcept -> shape_type
+    {
+        return detail::static_shape(m_axes);
+    }
+
+    template <class T, class... D, class S>
+    inline auto xstatic_variable<T, xstatic_dimension<D...>, S>::size() const noexcept -> size_type
+    {
+        return m_data.size();
+    }
+
+    template <class T, class... D, class S>
+    inline auto xstatic_variable<T, xstatic_dimension<D...>, S>::data() noexcept -> data_type&
+    {
+        return m_data;
+    }
+
+    template <class T, class... D, class S>
+    inline auto xstatic_variable<T, xstatic_dimension<D...>, S>::data() const noexcept -> const data_type&
+    {
+        return m_data;
+    }
+
+    /**
+     * Returns a reference to the element with the given labels, in the
+     * order of the dimension tags.
+     */
+    template <class T, class... D, class S>
+    template <class... Args>
+    inline auto xstatic_variable<T, xstatic_dimension<D...>, S>::locate(Args&&... labels) -> reference
+    {
+        shape_type index = locate_index(std::make_index_sequence<rank>(), std::forward<Args>(labels)...);
+        return m_data.element(index.cbegin(), index.cend());
+    }
+
+    template <class T, class... D, class S>
+    template <class... Args>
+    inline auto xstatic_variable<T, xstatic_dimension<D...>, S>::locate(Args&&... labels) const -> const_reference
+    {
+        shape_type index = locate_index(std::make_index_sequence<rank>(), std::forward<Args>(labels)...);
+        return m_data.element(index.cbegin(), index.cend());
+    }
+
+    /**
+     * Returns a reference to the element with the given labels, the
+     * dimensions being given by the tags Dims, in any order:
+     * \code{.cpp}
+     * var.select<lon, lat>(3.5, 12.);
+     * \endcode
+     */
+    template <class T, class... D, class S>
+    template <class... Dims, class... Args>
+    inline auto xstatic_variable<T, xstatic_dimension<D...>, S>::select(Args&&... labels) -> reference
+    {
+        shape_type index = select_index<Dims...>(std::forward<Args>(labels)...);
+        return m_data.element(index.cbegin(), index.cend());
+    }
+
+    template <class T, class... D, class S>
+    template <class... Dims, class... Args>
+    inline auto xstatic_variable<T, xstatic_dimension<D...>, S>::select(Args&&... labels) const -> const_reference
+    {
+        shape_type index = select_index<Dims...>(std::forward<Args>(labels)...);
+        return m_data.element(index.cbegin(), index.cend());
+    }
+
+    /**
+     * Returns a reference to the element with the given positions, the
+     * dimensions being given by the tags Dims, in any order. The positions
+     * are permuted at compile time.
+     */
+    template <class T, class... D, class S>
+    template <class... Dims, class... Args>
+    inline auto xstatic_variable<T, xstatic_dimension<D...>, S>::iselect(Args... indices) -> reference
+    {
+        shape_type index = iselect_index<Dims...>(indices...);
+        return m_data.element(index.cbegin(), index.cend());
+    }
+
+    template <class T, class... D, class S>
+    template <class... Dims, class... Args>
+    inline auto xstatic_variable<T, xstatic_dimension<D...>, S>::iselect(Args... indices) const -> const_reference
+    {
+        shape_type index = iselect_index<Dims...>(indices...);
+        return m_data.element(index.cbegin(), index.cend());
+    }
+
+    /**
+     * Converts the variable to an xvariable_container with the same
+     * dimension order.
+     */
+    template <class T, class... D, class S>
+    inline auto xstatic_variable<T, xstatic_dimension<D...>, S>::to_variable() const -> variable_type
+    {
+        typename coordinate_type::map_type coords;
+        auto names = dimension_type::template labels<name_type>();
+        for (std::size_t i = 0; i < rank; ++i)
+        {
+            coords.emplace(names[i], m_axes[i]);
+        }
+        variable_type res(std::move(coords), std::move(names));
+        std::copy(m_data.cbegin(), m_data.cend(), res.data().begin());
+        return res;
+    }
+
+    template <class T, class... D, class S>
+    template <class... Dims, class... Args>
+    inline auto xstatic_variable<T, xstatic_dimension<D...>, S>::select_index(Args&&... labels) const -> shape_type
+    {
+        static_assert(sizeof...(Dims) == rank, "select requires a label for each dimension");
+        static_assert(sizeof...(Args) == rank, "select requires a label for each dimension");
+        return iselect_index<Dims...>(
+            m_axes[dimension_type::template index_of<Dims>()][labels]...);
+    }
+
+    template <class T, class... D, class S>
+    template <class... Dims, class... Args>
+    inline auto xstatic_variable<T, xstatic_dimension<D...>, S>::iselect_index(Args... indices) noexcept -> shape_type
+    {
+        static_assert(sizeof...(Dims) == rank, "iselect requires a position for each dimension");
+        static_assert(sizeof...(Args) == rank, "iselect requires a position for each dimension");
+        shape_type res = {};
+        std::array<std::size_t, rank> positions = {{dimension_type::template index_of<Dims>()...}};
+        std::array<size_type, rank> values = {{static_cast<size_type>(indices)...}};
+        for (std::size_t i = 0; i < rank; ++i)
+        {
+            res[positions[i]] = values[i];
+        }
+        return res;
+    }
+
+    template <class T, class... D, class S>
+    template <class... Args, std::size_t... I>
+    inline auto xstatic_variable<T, xstatic_dimension<D...>, S>::locate_index(std::index_sequence<I...>, Args&&... labels) const -> shape_type
+    {
+        static_assert(sizeof...(Args) == rank, "locate requires a label for each dimension");
+        return shape_type({{static_cast<size_type>(m_axes[I][labels])...}});
+    }
+
+    template <class T, class... D, class S>
+    inline void xstatic_variable<T, xstatic_dimension<D...>, S>::check_shape() const
+    {
+        shape_type sh = shape();
+        if (m_data.dimension() != rank || !std::equal(sh.cbegin(), sh.cend(), m_data.shape().cbegin()))
+        {
+            throw std::runtime_error("Data shape does not match the axes of xstatic_variable");
+        }
+    }
+
+    template <class T, class DM, class S>
+    inline bool operator==(const xstatic_variable<T, DM, S>& lhs, const xstatic_variable<T, DM, S>& rhs)
+    {
+        return lhs.axes() == rhs.axes() && lhs.data() == rhs.data();
+    }
+
+    template <class T, class DM, class S>
+    inline bool operator!=(const xstatic_variable<T, DM, S>& lhs, const xstatic_variable<T, DM, S>& rhs)
+    {
+        return !(lhs == rhs);
+    }
+
+    /***********************
+     * static broadcasting *
+     ***********************/
+
+    namespace detail
+    {
+        constexpr std::size_t static_npos = std::numeric_limits<std::size_t>::max();
+
+        template <class Join, class Dim, class V1, class V2>
+        inline typename V1::axis_type static_broadcast_axis_impl(const V1& v1, const V2& v2,
+                                                                 std::true_type, std::true_type)
+        {
+            auto res = v1.template axis<Dim>();
+            axis_broadcast<Join>::apply(res, v2.template axis<Dim>());
+            return res;
+        }
+
+        template <class Join, class Dim, class V1, class V2>
+        inline typename V1::axis_type static_broadcast_axis_impl(const V1& v1, const V2&,
+                                                                 std::true_type, std::false_type)
+        {
+            return v1.template axis<Dim>();
+        }
+
+        template <class Join, class Dim, class V1, class V2>
+        inline typename V1::axis_type static_broadcast_axis_impl(const V1&, const V2& v2,
+                                                                 std::false_type, std::true_type)
+        {
+            return v2.template axis<Dim>();
+        }
+
+        // Axis of the result for the dimension Dim, joining the axes of
+        // the operands holding this dimension.
+        template <class Join, class Dim, class V1, class V2>
+        inline typename V1::axis_type static_broadcast_axis(const V1& v1, const V2& v2)
+        {
+            using dim1 = typename V1::dimension_type;
+            using dim2 = typename V2::dimension_type;
+            return static_broadcast_axis_impl<Join, Dim>(v1, v2,
+                                                   std::integral_constant<bool, dim1::template contains<Dim>()>(),
+                                                   std::integral_constant<bool, dim2::template contains<Dim>()>());
+        }
+
+        // Position in the operand of each label of the result axis,
+        // static_npos for labels missing from the operand.
+        template <class A>
+        inline std::vector<std::size_t> static_positions(const A& res_axis, const A& axis)
+        {
+            std::vector<std::size_t> res(res_axis.size());
+            for (std::size_t i = 0; i < res.size(); ++i)
+            {
+                auto label = res_axis.label(i);
+                res[i] = axis.contains(label) ? static_cast<std::size_t>(axis[label]) : static_npos;
+            }
+            return res;
+        }
+
+        // Maps the positions of the result on the ones of an operand; dimensions
+        // missing from the operand are broadcast. Presence is tracked apart from
+        // the strides since xtensor gives a null stride to dimensions of size 1.
+        template <class DR, class V>
+        class static_operand_mapping;
+
+        template <class... DR, class V>
+        class static_operand_mapping<xstatic_dimension<DR...>, V>
+        {
+        public:
+
+            static constexpr std::size_t rank = sizeof...(DR);
+            using result_axes = std::array<typename V::axis_type, rank>;
+
+            static_operand_mapping(const result_axes& axes, const V& v)
+                : m_positions({{positions<DR>(axes, v)...}}),
+                  m_strides({{stride<DR>(v)...}}),
+                  m_present({{V::dimension_type::template contains<DR>()...}})
+            {
+            }
+
+            // Returns the flat offset in the operand, static_npos if the
+            // element is missing from the operand.
+            std::size_t offset(const std::array<std::size_t, rank>& index) const noexcept
+            {
+                std::size_t res = 0;
+                for (std::size_t i = 0; i < rank; ++i)
+                {
+                    if (m_present[i])
+                    {
+                        std::size_t p = m_positions[i][index[i]];
+                        if (p == static_npos)
+                        {
+                            return static_npos;
+                        }
+                        res += p * m_strides[i];
+                    }
+                }
+                return res;
+            }
+
+        private:
+
+            template <class Dim>
+            static std::vector<std::size_t> positions(const result_axes& axes, const V& v)
+            {
+                return positions_impl<Dim>(axes, v, std::integral_constant<bool, V::dimension_type::template contains<Dim>()>());
+            }
+
+            template <class Dim>
+            static std::vector<std::size_t> positions_impl(const result_axes& axes, const V& v, std::true_type)
+            {
+                return static_positions(axes[xstatic_dimension<DR...>::template index_of<Dim>()], v.template axis<Dim>());
+            }
+
+            template <class Dim>
+            static std::vector<std::size_t> positions_impl(const result_axes&, const V&, std::false_type)
+            {
+                return std::vector<std::size_t>();
+            }
+
+            template <class Dim>
+            static std::size_t stride(const V& v)
+            {
+                return stride_impl<Dim>(v, std::integral_constant<bool, V::dimension_type::template contains<Dim>()>());
+            }
+
+            template <class Dim>
+            static std::size_t stride_impl(const V& v, std::true_type)
+            {
+                return static_cast<std::size_t>(v.data().value().strides()[V::dimension_type::template index_of<Dim>()]);
+            }
+
+            template <class Dim>
+            static std::size_t stride_impl(const V&, std::false_type)
+            {
+                return 0;
+            }
+
+            std::array<std::vector<std::size_t>, rank> m_positions;
+            std::array<std::size_t, rank> m_strides;
+            std::array<bool, rank> m_present;
+        };
+
+        template <class F, class V1, class V2, class R>
+        inline void static_apply_trivial(F&& f, const V1& v1, const V2& v2, R& res)
+        {
+            const auto& val1 = v1.data().value();
+            const auto& val2 = v2.data().value();
+            const auto& flag1 = v1.data().has_value();
+            const auto& flag2 = v2.data().has_value();
+            auto& val = res.data().value();
+            auto& flag = res.data().has_value();
+            for (std::size_t i = 0; i < val.size(); ++i)
+            {
+                val.data()[i] = f(val1.data()[i], val2.data()[i]);
+                flag.data()[i] = flag1.data()[i] && flag2.data()[i];
+            }
+        }
+
+        template <class F, class V1, class V2, class R>
+        inline void static_apply_broadcast(F&& f, const V1& v1, const V2& v2, R& res)
+        {
+            using result_dimension = typename R::dimension_type;
+            constexpr std::size_t rank = R::rank;
+            static_operand_mapping<result_dimension, V1> map1(res.axes(), v1);
+            static_operand_mapping<result_dimension, V2> map2(res.axes(), v2);
+            auto shape = res.shape();
+            if (static_shape_empty(shape))
+            {
+                return;
+            }
+            const auto& val1 = v1.data().value();
+            const auto& val2 = v2.data().value();
+            const auto& flag1 = v1.data().has_value();
+            const auto& flag2 = v2.data().has_value();
+            auto& val = res.data().value();
+            auto& flag = res.data().has_value();
+            std::array<std::size_t, rank> index = {};
+            std::size_t i = 0;
+            do
+            {
+                std::size_t o1 = map1.offset(index);
+                std::size_t o2 = map2.offset(index);
+                if (o1 != static_npos && o2 != static_npos)
+                {
+                    val.data()[i] = f(val1.data()[o1], val2.data()[o2]);
+                    flag.data()[i] = flag1.data()[o1] && flag2.data()[o2];
+                }
+                else
+                {
+                    flag.data()[i] = false;
+                }
+                ++i;
+            }
+            while (increment_static_index(shape, index));
+        }
+
+        // Operands with the same dimensions and labels are computed
+        // with a single loop over the buffers.
+        template <class F, class V, class R>
+        inline void static_apply_dispatch(F&& f, const V& v1, const V& v2, R& res)
+        {
+            if (v1.axes() == v2.axes())
+            {
+                static_apply_trivial(std::forward<F>(f), v1, v2, res);
+            }
+            else
+            {
+                static_apply_broadcast(std::forward<F>(f), v1, v2, res);
+            }
+        }
+
+        template <class F, class V1, class V2, class R>
+        inline void static_apply_dispatch(F&& f, const V1& v1, const V2& v2, R& res)
+        {
+            static_apply_broadcast(std::forward<F>(f), v1, v2, res);
+        }
+
+        template <class R, class Join, class F, class V1, class V2, class... DR>
+        inline R static_apply_impl(F&& f, const V1& v1, const V2& v2, xstatic_dimension<DR...>)
+        {
+            typename R::axis_list axes = {{static_broadcast_axis<Join, DR>(v1, v2)...}};
+            R res(axes);
+            static_apply_dispatch(std::forward<F>(f), v1, v2, res);
+            return res;
+        }
+
+        template <class Join, class F, class T1, class D1, class T2, class D2, class S>
+        inline auto static_apply(F&& f, const xstatic_variable<T1, D1, S>& v1, const xstatic_variable<T2, D2, S>& v2)
+        {
+            using value_type = std::decay_t<decltype(f(std::declval<T1>(), std::declval<T2>()))>;
+            using result_type = xstatic_variable<value_type, static_union_t<D1, D2>, S>;
+            return static_apply_impl<result_type, Join>(std::forward<F>(f), v1, v2, static_union_t<D1, D2>());
+        }
+
+        template <class F, class T, class D, class S>
+        inline auto static_apply_scalar(F&& f, const xstatic_variable<T, D, S>& v)
+        {
+            using value_type = std::decay_t<decltype(f(std::declval<T>()))>;
+            xstatic_variable<value_type, D, S> res(v.axes());
+            const auto& val = v.data().value();
+            auto& res_val = res.data().value();
+            for (std::size_t i = 0; i < val.size(); ++i)
+            {
+                res_val.data()[i] = f(val.data()[i]);
+            }
+            res.data().has_value() = v.data().has_value();
+            return res;
+        }
+    }
+
+    /**
+     * Applies the binary function f to the variables v1 and v2. The
+     * dimensions of the result are resolved at compile time; when both
+     * operands have the same dimensions and labels, the values are
+     * computed with a single loop over the buffers. Labels are joined
+     * according to the \c Join parameter.
+     */
+    template <class Join = XFRAME_DEFAULT_JOIN, class F, class T1, class D1, class T2, class D2, class S>
+    inline auto static_apply(F&& f, const xstatic_variable<T1, D1, S>& v1, const xstatic_variable<T2, D2, S>& v2)
+    {
+        return detail::static_apply<Join>(std::forward<F>(f), v1, v2);
+    }
+
+#define XFRAME_STATIC_BINARY_OPERATOR(OP, FUNCTOR)                                                                     \
+    template <class T1, class D1, class T2, class D2, class S>                                                          \
+    inline auto operator OP(const xstatic_variable<T1, D1, S>& v1, const xstatic_variable<T2, D2, S>& v2)             \
+    {                                                                                                                   \
+        return detail::static_apply<XFRAME_DEFAULT_JOIN>(FUNCTOR<>(), v1, v2);                                         \
+    }                                                                                                                   \
+                                                                                                                        \
+    template <class T, class D, class S, class E, class = std::enable_if_t<std::is_arithmetic<E>::value>>             \
+    inline auto operator OP(const xstatic_variable<T, D, S>& v, const E& e)                                            \
+    {                                                                                                                   \
+        return detail::static_apply_scalar([e](const T& t) { return FUNCTOR<>()(t, e); }, v);                          \
+    }                                                                                                                   \
+                                                                                                                        \
+    template <class E, class T, class D, class S, class = std::enable_if_t<std::is_arithmetic<E>::value>>             \
+    inline auto operator OP(const E& e, const xstatic_variable<T, D, S>& v)                                            \
+    {                                                                                                                   \
+        return detail::static_apply_scalar([e](const T& t) { return FUNCTOR<>()(e, t); }, v);                          \
+    }
+
+    XFRAME_STATIC_BINARY_OPERATOR(+, std::plus)
+    XFRAME_STATIC_BINARY_OPERATOR(-, std::minus)
+    XFRAME_STATIC_BINARY_OPERATOR(*, std::multiplies)
+    XFRAME_STATIC_BINARY_OPERATOR(/, std::divides)
+
+#undef XFRAME_STATIC_BINARY_OPERATOR
+}
+
+#endif
@@ -11,6 +11,7 @@
 
 #include "xtensor/xoptional_assembly.hpp"
 
+#include "xmissing_flags.hpp"
 #include "xvariable_assign.hpp"
 #include "xvariable_base.hpp"
 #include "xvariable_math.hpp"
@@ -101,9 +102,12 @@ namespace xf
         template <class E>
         xvariable_container& operator=(const xt::xexpression<E>& e);
 
+        bool all_valid() const;
+
     private:
 
         data_closure_type m_data;
+        mutable bool m_has_missing = false;
 
         data_type& data_impl() noexcept;
         const data_type& data_impl() const noexcept;
@@ -252,9 +256,29 @@ namespace xf
         return semantic_base::assign(e);
     }
 
+    /**
+     * Returns true if the variable holds no missing value. Flags can be cleared
+     * through views or references on the data that the variable does not see,
+     * therefore only a negative result is cached, until the data is accessed
+     * through a non-const method; a positive result is computed again on each
+     * call, in constant time when the flags are stored in an xbitmask.
+     */
+    template <class CCT, class ECT>
+    inline bool xvariable_container<CCT, ECT>::all_valid() const
+    {
+        if (m_has_missing)
+        {
+            return false;
+        }
+        bool res = detail::all_flags_set(m_data);
+        m_has_missing = !res;
+        return res;
+    }
+
     template <class CCT, class ECT>
     inline auto xvariable_container<CCT, ECT>::data_impl() noexcept -> data_type&
     {
+        m_has_missing = false;
         return m_data;
     }
 
@@ -9,9 +9,127 @@
 #ifndef XFRAME_XVARIABLE_ASSIGN_HPP
 #define XFRAME_XVARIABLE_ASSIGN_HPP
 
+#include <algorithm>
+#include <memory>
+
 #include "xtensor/xassign.hpp"
+#include "xtensor/xoperation.hpp"
 #include "xcoordinate.hpp"
+#include "xframe_counters.hpp"
 #include "xframe_expression.hpp"
+#include "xmissing_flags.hpp"
+
+namespace xf
+{
+    template <class CCT, class ECT>
+    class xvariable_container;
+
+    template <class F, class R, class... CT>
+    class xvariable_function;
+
+    template <class CT>
+    class xvariable_scalar;
+
+    template <class CT>
+    class xexpand_dims_view;
+
+    template <class CT>
+    class xvariable_view;
+
+    namespace detail
+    {
+        /**
+         * Describes how the operands of an expression refer to the
+         * destination of its assignment: not at all, only as the
+         * destination itself, so that each element is read at the
+         * position it is written to, or in an unknown way.
+         */
+        enum class alias_kind
+        {
+            none,
+            aligned,
+            unknown
+        };
+
+        inline alias_kind merge_alias(alias_kind lhs, alias_kind rhs) noexcept
+        {
+            return lhs < rhs ? rhs : lhs;
+        }
+
+        // Operands of other kinds than variables, scalars, functions and
+        // expand_dims views, such as selection views, are assumed to alias
+        // the destination.
+        template <class E1, class E2>
+        inline alias_kind operand_alias(const E1& /*e1*/, const E2& /*e2*/) noexcept
+        {
+            return alias_kind::unknown;
+        }
+
+        template <class E1, class CT>
+        inline alias_kind operand_alias(const E1& /*e1*/, const xvariable_scalar<CT>& /*e2*/) noexcept
+        {
+            return alias_kind::none;
+        }
+
+        template <class E1, class CCT, class ECT>
+        inline alias_kind operand_alias(const E1& e1, const xvariable_container<CCT, ECT>& e2) noexcept
+        {
+            const void* data1 = std::addressof(e1.data());
+            const void* data2 = std::addressof(e2.data());
+            const void* coords1 = std::addressof(e1.coordinates());
+            const void* coords2 = std::addressof(e2.coordinates());
+            if (data1 == data2 && coords1 == coords2)
+            {
+                return alias_kind::aligned;
+            }
+            return data1 == data2 || coords1 == coords2 ? alias_kind::unknown : alias_kind::none;
+        }
+
+        template <class E1, class F, class R, class... CT>
+        alias_kind operand_alias(const E1& e1, const xvariable_function<F, R, CT...>& e2) noexcept;
+
+        // An expand_dims view repeats the values of its underlying expression;
+        // it cannot be aligned with the destination.
+        template <class E1, class CT>
+        inline alias_kind operand_alias(const E1& e1, const xexpand_dims_view<CT>& e2) noexcept
+        {
+            return operand_alias(e1, e2.expression()) == alias_kind::none ? alias_kind::none : alias_kind::unknown;
+        }
+
+        template <class E1, class F, class R, class... CT>
+        inline alias_kind operand_alias(const E1& e1, const xvariable_function<F, R, CT...>& e2) noexcept
+        {
+            auto func = [&e1](alias_kind res, const auto& arg) { return merge_alias(res, operand_alias(e1, arg)); };
+            return xt::accumulate(func, alias_kind::none, e2.arguments());
+        }
+
+        // Copies the first block of a storage to the nb_blocks - 1 following
+        // ones.
+        template <class S>
+        inline void replicate_storage(S& storage, std::size_t block, std::size_t nb_blocks)
+        {
+            const S& src = storage;
+            for (std::size_t i = 1; i < nb_blocks; ++i)
+            {
+                std::copy(src.begin(), src.begin() + block, storage.begin() + i * block);
+            }
+        }
+
+        template <class D>
+        inline void replicate_blocks(D& data, std::size_t block, std::size_t nb_blocks, std::false_type)
+        {
+            replicate_storage(data.value().storage(), block, nb_blocks);
+            replicate_storage(data.has_value().storage(), block, nb_blocks);
+        }
+
+        // Missing values are encoded in the values themselves
+        template <class D>
+        inline void replicate_blocks(D& data, std::size_t block, std::size_t nb_blocks, std::true_type)
+        {
+            replicate_storage(data.storage().value(), block, nb_blocks);
+        }
+    }
+}
 
 namespace xt
 {
@@ -37,6 +155,10 @@ namespace xt
         template <class E1, class E2>
         static void assert_compatible_shape(const xexpression<E1>& e1, const xexpression<E2>& e2);
 
+        template <class E1, class E2>
+        static void assign_resized_xexpression(xexpression<E1>& e1, const xexpression<E2>& e2,
+                                               xf::xtrivial_broadcast trivial);
+
     private:
 
         template <class E1, class E2>
@@ -46,8 +168,51 @@ namespace xt
         static void assign_optional_tensor(xexpression<E1>& e1, const xexpression<E2>& e2, bool trivial);
 
         template <class E1, class E2>
-        static void assign_resized_xexpression(xexpression<E1>& e1, const xexpression<E2>& e2,
-                                               xf::xtrivial_broadcast trivial);
+        static void assign_optional_tensor(xexpression<E1>& e1, const xexpression<E2>& e2, bool trivial, std::false_type);
+
+        template <class E1, class E2>
+        static void assign_optional_tensor(xexpression<E1>& e1, const xexpression<E2>& e2, bool trivial, std::true_type);
+
+        template <class E1, class E2>
+        static void assign_valid_tensor(xexpression<E1>& e1, const xexpression<E2>& e2, bool trivial);
+
+        template <class E1, class E2>
+        static void assign_missing_tensor(xexpression<E1>& e1, const xexpression<E2>& e2, bool trivial, std::false_type);
+
+        template <class E1, class E2>
+        static void assign_missing_tensor(xexpression<E1>& e1, const xexpression<E2>& e2, bool trivial, std::true_type);
+
+        template <class E1, class E2>
+        static void assign_optional_tensor_impl(xexpression<E1>& e1, const xexpression<E2>& e2, bool trivial, std::false_type);
+
+        template <class E1, class E2>
+        static void assign_optional_tensor_impl(xexpression<E1>& e1, const xexpression<E2>& e2, bool trivial, std::true_type);
+
+        template <class E1, class E2>
+        static bool assign_expanded(xexpression<E1>& e1, const E2& e2, xf::xtrivial_broadcast trivial);
+
+        template <class E1, class CT>
+        static bool assign_expanded(xexpression<E1>& e1, const xf::xexpand_dims_view<CT>& e2, xf::xtrivial_broadcast trivial);
+
+        template <class E1, class E2>
+        static bool assign_strided(xexpression<E1>& e1, const E2& e2, xf::xtrivial_broadcast trivial);
+
+        template <class E1, class CT>
+        static bool assign_strided(xexpression<E1>& e1, const xf::xvariable_view<CT>& e2, xf::xtrivial_broadcast trivial);
+
+        template <class E1, class CT>
+        static bool assign_strided_impl(xexpression<E1>& e1, const xf::xvariable_view<CT>& e2, std::false_type);
+
+        template <class E1, class CT>
+        static bool assign_strided_impl(xexpression<E1>& e1, const xf::xvariable_view<CT>& e2, std::true_type);
+
+        template <class CCT, class ECT, class E2, class C, class D>
+        static bool computed_assign_in_place(xf::xvariable_container<CCT, ECT>& e1, const xexpression<E2>& e2,
+                                             C& coords, D& dims, xf::xtrivial_broadcast trivial);
+
+        template <class E1, class E2, class C, class D>
+        static bool computed_assign_in_place(E1& e1, const xexpression<E2>& e2,
+                                             C& coords, D& dims, xf::xtrivial_broadcast trivial);
     };
 
     /***************************************
@@ -100,22 +265,25 @@ namespace xt
             end = detail::increment_index(e1.derived_cast().shape(), index);
         }
         while(!end);
+        XFRAME_COUNT_N(m_realigned_elements, e1.derived_cast().size())
     }
 
     template <class E1, class E2>
     inline void xexpression_assigner<xvariable_expression_tag>::assign_xexpression(xexpression<E1>& e1,
                                                                                    const xexpression<E2>& e2)
     {
-        XFRAME_TRACE("ASSIGN EXPRESSION - BEGIN");
+        XFRAME_TRACE_SPAN(span, "assign_xexpression")
         xf::xtrivial_broadcast trivial = resize(e1, e2);
         assign_resized_xexpression(e1, e2, trivial);
-        XFRAME_TRACE("ASSIGN EXPRESSION - END" << std::endl);
+        XFRAME_TRACE_SPAN_SIZE(span, e1.derived_cast().size())
+        XFRAME_TRACE_SPAN_SLOW_PATH(span, !trivial.m_same_labels)
     }
 
     template <class E1, class E2>
     inline void xexpression_assigner<xvariable_expression_tag>::computed_assign(xexpression<E1>& e1,
                                                                                 const xexpression<E2>& e2)
     {
+        XFRAME_TRACE_SPAN(span, "computed_assign")
         using coordinate_type = typename E1::coordinate_type;
         using dimension_type = typename E1::dimension_type;
         coordinate_type c;
@@ -125,14 +293,69 @@ namespace xt
         trivial.m_same_labels &= dim_trivial;
         if (d.size() > e1.derived_cast().dimension_mapping().size() || !trivial.m_same_labels)
         {
-            typename E1::temporary_type tmp(std::move(c), std::move(d));
-            assign_resized_xexpression(tmp, e2, trivial);
-            e1.derived_cast().assign_temporary(std::move(tmp));
+            if (!computed_assign_in_place(e1.derived_cast(), e2, c, d, trivial))
+            {
+                XFRAME_TRACE_SPAN(tmp_span, "temporary")
+                XFRAME_COUNT(m_temporaries)
+                typename E1::temporary_type tmp(std::move(c), std::move(d));
+                XFRAME_TRACE_SPAN_SIZE(tmp_span, tmp.size())
+                assign_resized_xexpression(tmp, e2, trivial);
+                e1.derived_cast().assign_temporary(std::move(tmp));
+            }
         }
         else
         {
             assign_resized_xexpression(e1, e2, trivial);
         }
+        XFRAME_TRACE_SPAN_SIZE(span, e1.derived_cast().size())
+        XFRAME_TRACE_SPAN_SLOW_PATH(span, !trivial.m_same_labels)
+    }
+
+    // The expression is evaluated straight into the destination when none of
+    // its operands refers to it, after resizing it, or when the destination
+    // only appears as itself among the operands and keeps its coordinates:
+    // each element is then read before being overwritten. Otherwise, the
+    // values of the destination would be needed after being modified, and a
+    // temporary is required; this is always the case for a compound
+    // assignment such as res += e growing the destination, since res is
+    // then an operand.
+    template <class CCT, class ECT, class E2, class C, class D>
+    inline bool xexpression_assigner<xvariable_expression_tag>::computed_assign_in_place(xf::xvariable_container<CCT, ECT>& e1,
+                                                                                         const xexpression<E2>& e2,
+                                                                                         C& coords,
+                                                                                         D& dims,
+                                                                                         xf::xtrivial_broadcast trivial)
+    {
+        using alias_kind = xf::detail::alias_kind;
+        alias_kind alias = xf::detail::operand_alias(e1, e2.derived_cast());
+        if (alias == alias_kind::unknown)
+        {
+            return false;
+        }
+        bool same_coordinates = dims.size() == e1.dimension_mapping().size() && coords == e1.coordinates();
+        if (alias == alias_kind::aligned && !same_coordinates)
+        {
+            return false;
+        }
+        XFRAME_TRACE_SPAN(span, "in_place")
+        XFRAME_COUNT(m_in_place_assignments)
+        if (!same_coordinates)
+        {
+            e1.resize(std::move(coords), std::move(dims));
+        }
+        XFRAME_TRACE_SPAN_SIZE(span, e1.size())
+        assign_resized_xexpression(e1, e2, trivial);
+        return true;
+    }
+
+    template <class E1, class E2, class C, class D>
+    inline bool xexpression_assigner<xvariable_expression_tag>::computed_assign_in_place(E1& /*e1*/,
+                                                                                         const xexpression<E2>& /*e2*/,
+                                                                                         C& /*coords*/,
+                                                                                         D& /*dims*/,
+                                                                                         xf::xtrivial_broadcast /*trivial*/)
+    {
+        return false;
     }
 
     template <class E1, class E2, class F>
@@ -170,7 +393,9 @@ namespace xt
         xf::xtrivial_broadcast res = e2.derived_cast().broadcast_coordinates(c);
         bool dim_trivial = e2.derived_cast().broadcast_dimensions(d, res.m_same_dimensions);
         res.m_same_labels &= dim_trivial;
+        XFRAME_TRACE_SPAN(span, "resize")
         e1.derived_cast().resize(c, d);
+        XFRAME_TRACE_SPAN_SIZE(span, e1.derived_cast().size())
         return res;
     }
 
@@ -178,12 +403,203 @@ namespace xt
     inline void xexpression_assigner<xvariable_expression_tag>::assign_optional_tensor(xexpression<E1>& e1,
                                                                                        const xexpression<E2>& e2,
                                                                                        bool trivial)
+    {
+        assign_optional_tensor(e1, e2, trivial, xf::detail::has_compact_flags<E1>());
+    }
+
+    // Setting every flag of an array of bool costs as much as assigning
+    // them: the values and the flags are assigned together.
+    template <class E1, class E2>
+    inline void xexpression_assigner<xvariable_expression_tag>::assign_optional_tensor(xexpression<E1>& e1,
+                                                                                       const xexpression<E2>& e2,
+                                                                                       bool trivial,
+                                                                                       std::false_type)
+    {
+        assign_optional_tensor_impl(e1, e2, trivial, std::false_type());
+    }
+
+    template <class E1, class E2>
+    inline void xexpression_assigner<xvariable_expression_tag>::assign_optional_tensor(xexpression<E1>& e1,
+                                                                                       const xexpression<E2>& e2,
+                                                                                       bool trivial,
+                                                                                       std::true_type)
+    {
+        if (xf::detail::expression_all_valid(e2.derived_cast()))
+        {
+            assign_valid_tensor(e1, e2, trivial);
+        }
+        else
+        {
+            assign_missing_tensor(e1, e2, trivial, xf::detail::has_sentinel_data<E1>());
+        }
+    }
+
+    // No operand holds a missing value: values are computed with the plain
+    // tensor kernels, bypassing the optional wrappers, and the flags are set
+    // at once.
+    template <class E1, class E2>
+    inline void xexpression_assigner<xvariable_expression_tag>::assign_valid_tensor(xexpression<E1>& e1,
+                                                                                    const xexpression<E2>& e2,
+                                                                                    bool trivial)
+    {
+        auto& data = e1.derived_cast().data();
+        auto&& values = data.value();
+        xexpression_assigner<xtensor_expression_tag>::assign_data(values, e2.derived_cast().data().value(), trivial);
+        xf::detail::set_all_flags(data);
+    }
+
+    template <class E1, class E2>
+    inline void xexpression_assigner<xvariable_expression_tag>::assign_missing_tensor(xexpression<E1>& e1,
+                                                                                      const xexpression<E2>& e2,
+                                                                                      bool trivial,
+                                                                                      std::false_type)
+    {
+        assign_optional_tensor_impl(e1, e2, trivial, xf::detail::has_bitmask_flags<E1>());
+    }
+
+    // The destination encodes missing values in-band: the values and the
+    // sentinels are written in a single pass over its buffer.
+    template <class E1, class E2>
+    inline void xexpression_assigner<xvariable_expression_tag>::assign_missing_tensor(xexpression<E1>& e1,
+                                                                                      const xexpression<E2>& e2,
+                                                                                      bool trivial,
+                                                                                      std::true_type)
+    {
+        auto& data = e1.derived_cast().data();
+        using sentinel_traits = typename std::decay_t<decltype(data.data())>::sentinel_traits;
+        const auto& rhs = e2.derived_cast().data();
+        auto&& values = data.value();
+        xexpression_assigner<xtensor_expression_tag>::assign_data(values,
+                                                                  xt::where(rhs.has_value(), rhs.value(), sentinel_traits::value()),
+                                                                  trivial);
+    }
+
+    template <class E1, class E2>
+    inline void xexpression_assigner<xvariable_expression_tag>::assign_optional_tensor_impl(xexpression<E1>& e1,
+                                                                                            const xexpression<E2>& e2,
+                                                                                            bool trivial,
+                                                                                            std::false_type)
     {
         xexpression_assigner<xoptional_expression_tag>::assign_data(e1.derived_cast().data(),
                                                                     e2.derived_cast().data(),
                                                                     trivial);
     }
 
+    // When the missing flags of the destination and of all the operands are
+    // stored in bitmasks, missingness is propagated a word at a time and only
+    // the values go through the tensor assignment.
+    template <class E1, class E2>
+    inline void xexpression_assigner<xvariable_expression_tag>::assign_optional_tensor_impl(xexpression<E1>& e1,
+                                                                                            const xexpression<E2>& e2,
+                                                                                            bool trivial,
+                                                                                            std::true_type)
+    {
+        auto& flags = e1.derived_cast().data().has_value();
+        if (trivial && xf::detail::assign_bitmask_conjunction(flags, e2.derived_cast()))
+        {
+            xexpression_assigner<xtensor_expression_tag>::assign_data(e1.derived_cast().data().value(),
+                                                                      e2.derived_cast().data().value(),
+                                                                      trivial);
+        }
+        else
+        {
+            assign_optional_tensor_impl(e1, e2, trivial, std::false_type());
+        }
+    }
+
+    template <class E1, class E2>
+    inline bool xexpression_assigner<xvariable_expression_tag>::assign_expanded(xexpression<E1>& /*e1*/,
+                                                                                const E2& /*e2*/,
+                                                                                xf::xtrivial_broadcast /*trivial*/)
+    {
+        return false;
+    }
+
+    // The extra dimensions of an expand_dims view have a null stride: when
+    // they precede the dimensions of the underlying expression, its values
+    // are assigned once to the first block of the destination, which is
+    // then copied to the following blocks.
+    template <class E1, class CT>
+    inline bool xexpression_assigner<xvariable_expression_tag>::assign_expanded(xexpression<E1>& e1,
+                                                                                const xf::xexpand_dims_view<CT>& e2,
+                                                                                xf::xtrivial_broadcast trivial)
+    {
+        auto& data = e1.derived_cast().data();
+        const auto& view_data = e2.data();
+        if (!trivial.m_same_dimensions || data.layout() != layout_type::row_major || data.size() == 0)
+        {
+            return false;
+        }
+        const auto& shape = view_data.shape();
+        const auto& strides = view_data.strides();
+        std::size_t nb_blocks = 1;
+        std::size_t d = 0;
+        for (; d < shape.size() && strides[d] == 0; ++d)
+        {
+            nb_blocks *= shape[d];
+        }
+        for (std::size_t i = d; i < shape.size(); ++i)
+        {
+            if (strides[i] == 0 && shape[i] != 1)
+            {
+                return false;
+            }
+        }
+        if (nb_blocks <= 1)
+        {
+            return false;
+        }
+        XFRAME_TRACE_SPAN(span, "assign_expanded")
+        XFRAME_TRACE_SPAN_SIZE(span, data.size())
+        std::size_t block = data.size() / nb_blocks;
+        std::copy_n(view_data.cbegin(), block, data.begin());
+        xf::detail::replicate_blocks(data, block, nb_blocks, xf::detail::has_sentinel_data<E1>());
+        return true;
+    }
+
+    template <class E1, class E2>
+    inline bool xexpression_assigner<xvariable_expression_tag>::assign_strided(xexpression<E1>& /*e1*/,
+                                                                               const E2& /*e2*/,
+                                                                               xf::xtrivial_broadcast /*trivial*/)
+    {
+        return false;
+    }
+
+    // A view sliced with ranges only is read through its strided data
+    // rather than through its dynamic view.
+    template <class E1, class CT>
+    inline bool xexpression_assigner<xvariable_expression_tag>::assign_strided(xexpression<E1>& e1,
+                                                                               const xf::xvariable_view<CT>& e2,
+                                                                               xf::xtrivial_broadcast trivial)
+    {
+        if (!trivial.m_same_dimensions || !e2.is_strided())
+        {
+            return false;
+        }
+        return assign_strided_impl(e1, e2, xf::detail::has_sentinel_data<E1>());
+    }
+
+    template <class E1, class CT>
+    inline bool xexpression_assigner<xvariable_expression_tag>::assign_strided_impl(xexpression<E1>& e1,
+                                                                                    const xf::xvariable_view<CT>& e2,
+                                                                                    std::false_type)
+    {
+        XFRAME_TRACE_SPAN(span, "assign_strided")
+        XFRAME_TRACE_SPAN_SIZE(span, e1.derived_cast().size())
+        xexpression_assigner<xoptional_expression_tag>::assign_data(e1.derived_cast().data(), e2.strided_data(), true);
+        return true;
+    }
+
+    // Sentinel-encoded destinations are assigned through their values only,
+    // which the generic path handles.
+    template <class E1, class CT>
+    inline bool xexpression_assigner<xvariable_expression_tag>::assign_strided_impl(xexpression<E1>& /*e1*/,
+                                                                                    const xf::xvariable_view<CT>& /*e2*/,
+                                                                                    std::true_type)
+    {
+        return false;
+    }
+
     template <class E1, class E2>
     inline void xexpression_assigner<xvariable_expression_tag>::assign_resized_xexpression(xexpression<E1>& e1,
                                                                                            const xexpression<E2>& e2,
@@ -191,10 +607,21 @@ namespace xt
     {
         if (trivial.m_same_labels)
         {
-            assign_optional_tensor(e1, e2, trivial.m_same_dimensions);
+            XFRAME_TRACE_SPAN(span, "assign_trivial")
+            XFRAME_TRACE_SPAN_SIZE(span, e1.derived_cast().size())
+            XFRAME_TRACE_SPAN_SLOW_PATH(span, !trivial.m_same_dimensions)
+            XFRAME_COUNT(m_trivial_assignments)
+            if (!assign_expanded(e1, e2.derived_cast(), trivial) && !assign_strided(e1, e2.derived_cast(), trivial))
+            {
+                assign_optional_tensor(e1, e2, trivial.m_same_dimensions);
+            }
         }
         else
         {
+            XFRAME_TRACE_SPAN(span, "assign_realigned")
+            XFRAME_TRACE_SPAN_SIZE(span, e1.derived_cast().size())
+            XFRAME_TRACE_SPAN_SLOW_PATH(span, true)
+            XFRAME_COUNT(m_realigned_assignments)
             assign_data(e1, e2, false);
         }
     }
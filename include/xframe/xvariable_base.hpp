@@ -78,7 +78,7 @@ namespace xf
         using coordinate_initializer = std::initializer_list<typename coordinate_type::value_type>;
         using key_type = typename coordinate_map::key_type;
 
-        using named_axis_type = xnamed_axis<key_type, typename axis_type::mapped_type>;
+        using named_axis_type = xnamed_axis<key_type, typename axis_type::mapped_type, typename axis_type::map_container_tag>;
 
         template <std::size_t N = dynamic()>
         using selector_traits = xselector_traits<coordinate_type, dimension_type, N>;
@@ -96,6 +96,7 @@ namespace xf
         using locator_type = typename selector_traits<N>::locator_type;
         template <std::size_t N = dynamic()>
         using locator_sequence_type = typename selector_traits<N>::locator_sequence_type;
+        using batch_selector_type = typename selector_traits<>::batch_selector_type;
 
         static const_reference missing();
 
@@ -121,7 +122,7 @@ namespace xf
         named_axis_type operator[](const key_type& key) const;
 
         template <class LT>
-        xnamed_axis<key_type, typename axis_type::mapped_type, hash_map_tag, XFRAME_DEFAULT_LABEL_LIST, LT> axis(const key_type& key) const;
+        xnamed_axis<key_type, typename axis_type::mapped_type, typename axis_type::map_container_tag, XFRAME_DEFAULT_LABEL_LIST, LT> axis(const key_type& key) const;
 
         template <class... Args>
         reference operator()(Args... args);
@@ -183,6 +184,9 @@ namespace xf
         template <std::size_t N = dynamic()>
         const_reference iselect(iselector_sequence_type<N>&& selector) const;
 
+        template <class O>
+        O select_batch(const batch_selector_type& selector, O output) const;
+
     protected:
 
         xvariable_base() = default;
@@ -325,9 +329,9 @@ namespace xf
 
     template <class D>
     template <class LT>
-    inline auto xvariable_base<D>::axis(const key_type& key) const -> xnamed_axis<key_type, typename axis_type::mapped_type, hash_map_tag, XFRAME_DEFAULT_LABEL_LIST, LT>
+    inline auto xvariable_base<D>::axis(const key_type& key) const -> xnamed_axis<key_type, typename axis_type::mapped_type, typename axis_type::map_container_tag, XFRAME_DEFAULT_LABEL_LIST, LT>
     {
-        return xnamed_axis<key_type, typename axis_type::mapped_type, hash_map_tag, XFRAME_DEFAULT_LABEL_LIST, LT>(key, coordinates()[key]);
+        return xnamed_axis<key_type, typename axis_type::mapped_type, typename axis_type::map_container_tag, XFRAME_DEFAULT_LABEL_LIST, LT>(key, coordinates()[key]);
     }
 
     template <class D>
@@ -470,6 +474,20 @@ namespace xf
         return select_impl(iselector_type<N>(std::move(selector)));
     }
 
+    // Writes the element of each row of the batch to output; the
+    // dimensions of the batch are resolved once for all the rows.
+    template <class D>
+    template <class O>
+    inline O xvariable_base<D>::select_batch(const batch_selector_type& selector, O output) const
+    {
+        selector.for_each_index(coordinates(), dimension_mapping(), [this, &output](const auto& index)
+        {
+            *output = data().element(index.cbegin(), index.cend());
+            ++output;
+        });
+        return output;
+    }
+
     template <class D>
     inline auto xvariable_base<D>::make_dimension_mapping(coordinate_initializer coord) -> dimension_type
     {
@@ -0,0 +1,477 @@
+/***************************************************************************
+* Copyright (c) 2017, Johan Mabille, Sylvain Corlay and Wolf Vollprecht    *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XFRAME_XVARIABLE_COMPARE_HPP
+#define XFRAME_XVARIABLE_COMPARE_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "xtensor/xexpression.hpp"
+#include "xtensor/xutils.hpp"
+
+#include "xbitmask.hpp"
+#include "xframe_expression.hpp"
+#include "xframe_utils.hpp"
+#include "xparallel.hpp"
+
+namespace xf
+{
+
+    /**********************
+     * xcomparison_result *
+     **********************/
+
+    /**
+     * @class xcomparison_result
+     * @brief Outcome of the element-wise comparison of two variables.
+     *
+     * Two elements mismatch when only one of them is missing, or when
+     * both hold a value and these values differ. Elements are counted
+     * only when both variables have the same coordinates and dimension
+     * mapping.
+     */
+    struct xcomparison_result
+    {
+        using size_type = std::size_t;
+
+        static constexpr size_type npos = std::numeric_limits<size_type>::max();
+
+        /// Whether the variables have the same coordinates and dimension mapping
+        bool m_same_coordinates = false;
+        /// Number of elements compared
+        size_type m_size = 0;
+        /// Number of elements holding different values
+        size_type m_value_mismatches = 0;
+        /// Number of elements missing in only one of the variables
+        size_type m_missing_mismatches = 0;
+        /// Row-major position of the first mismatch, npos if there is none
+        size_type m_first_mismatch = npos;
+        /// Largest absolute difference between values held by both variables
+        double m_max_abs_diff = 0.;
+
+        bool equal() const noexcept;
+        size_type mismatches() const noexcept;
+    };
+
+    template <class E1, class E2>
+    std::enable_if_t<xvariable_comparable<E1, E2>::value, xcomparison_result>
+    compare(const xt::xexpression<E1>& e1, const xt::xexpression<E2>& e2, std::size_t nb_threads = 1);
+
+    template <class E1, class E2>
+    std::enable_if_t<xvariable_comparable<E1, E2>::value, xcomparison_result>
+    compare_close(const xt::xexpression<E1>& e1, const xt::xexpression<E2>& e2,
+                  double rtol = 1e-05, double atol = 1e-08, std::size_t nb_threads = 1);
+
+    template <class E1, class E2>
+    std::enable_if_t<xvariable_comparable<E1, E2>::value, bool>
+    allclose(const xt::xexpression<E1>& e1, const xt::xexpression<E2>& e2,
+             double rtol = 1e-05, double atol = 1e-08, std::size_t nb_threads = 1);
+
+    /*************************************
+     * xcomparison_result implementation *
+     *************************************/
+
+    /**
+     * Returns true if the variables have the same coordinates and
+     * no mismatching element.
+     */
+    inline bool xcomparison_result::equal() const noexcept
+    {
+        return m_same_coordinates && mismatches() == 0;
+    }
+
+    /**
+     * Returns the number of mismatching elements.
+     */
+    inline auto xcomparison_result::mismatches() const noexcept -> size_type
+    {
+        return m_value_mismatches + m_missing_mismatches;
+    }
+
+    /************************
+     * xvariable comparison *
+     ************************/
+
+    namespace detail
+    {
+        // Number of elements compared by a task: large enough to amortize
+        // the scheduling of the task, small enough to balance the load of
+        // the threads on large variables.
+        constexpr std::size_t compare_task_size = 65536;
+
+        template <class T1, class T2>
+        using both_arithmetic = xtl::conjunction<std::is_arithmetic<T1>, std::is_arithmetic<T2>>;
+
+        template <class T1, class T2>
+        inline std::enable_if_t<both_arithmetic<T1, T2>::value, double>
+        value_distance(const T1& lhs, const T2& rhs) noexcept
+        {
+            return std::abs(static_cast<double>(lhs) - static_cast<double>(rhs));
+        }
+
+        template <class T1, class T2>
+        inline std::enable_if_t<!both_arithmetic<T1, T2>::value, double>
+        value_distance(const T1& lhs, const T2& rhs) noexcept
+        {
+            return lhs == rhs ? 0. : std::numeric_limits<double>::infinity();
+        }
+
+        struct exact_predicate
+        {
+            template <class T1, class T2>
+            bool operator()(const T1& lhs, const T2& rhs) const noexcept
+            {
+                return lhs == rhs;
+            }
+        };
+
+        // Same semantic as numpy.isclose: NaN values are never close.
+        struct close_predicate
+        {
+            double m_rtol;
+            double m_atol;
+
+            template <class T1, class T2>
+            std::enable_if_t<both_arithmetic<T1, T2>::value, bool>
+            operator()(const T1& lhs, const T2& rhs) const noexcept
+            {
+                double r = static_cast<double>(rhs);
+                return std::abs(static_cast<double>(lhs) - r) <= m_atol + m_rtol * std::abs(r);
+            }
+
+            template <class T1, class T2>
+            std::enable_if_t<!both_arithmetic<T1, T2>::value, bool>
+            operator()(const T1& lhs, const T2& rhs) const noexcept
+            {
+                return lhs == rhs;
+            }
+        };
+
+        inline void merge_comparison(xcomparison_result& res, const xcomparison_result& part)
+        {
+            if (res.m_first_mismatch == xcomparison_result::npos)
+            {
+                res.m_first_mismatch = part.m_first_mismatch;
+            }
+            res.m_size += part.m_size;
+            res.m_value_mismatches += part.m_value_mismatches;
+            res.m_missing_mismatches += part.m_missing_mismatches;
+            res.m_max_abs_diff = part.m_max_abs_diff > res.m_max_abs_diff ? part.m_max_abs_diff : res.m_max_abs_diff;
+        }
+
+        /****************
+         * flat storage *
+         ****************/
+
+        template <class D, class = void>
+        struct has_flat_storage : std::false_type
+        {
+        };
+
+        template <class D>
+        struct has_flat_storage<D, xt::void_t<decltype(std::declval<const D&>().value().data().data()),
+                                              decltype(std::declval<const D&>().value().strides()),
+                                              decltype(std::declval<const D&>().has_value().data())>>
+            : std::true_type
+        {
+        };
+
+        // The flat storages of two data containers can be compared element-wise
+        // when they are dense, row-major and laid out with the same strides.
+        template <class D1, class D2>
+        inline bool flat_storage_compatible(const D1& d1, const D2& d2)
+        {
+            const auto& v1 = d1.value();
+            const auto& v2 = d2.value();
+            return v1.layout() == xt::layout_type::row_major &&
+                v2.layout() == xt::layout_type::row_major &&
+                v1.data().size() == v1.size() &&
+                v2.data().size() == v2.size() &&
+                d1.has_value().data().size() == v1.size() &&
+                d2.has_value().data().size() == v2.size() &&
+                v1.strides().size() == v2.strides().size() &&
+                std::equal(v1.strides().cbegin(), v1.strides().cend(), v2.strides().cbegin());
+        }
+
+        // Compares values known to be all valid; the loop is free of branches
+        // so that the compiler can vectorize it.
+        template <class T1, class T2, class P>
+        inline void compare_values(const T1* v1, const T2* v2, std::size_t first, std::size_t last,
+                                   const P& pred, xcomparison_result& res)
+        {
+            std::size_t mismatches = 0;
+            double max_diff = 0.;
+            for (std::size_t i = first; i < last; ++i)
+            {
+                mismatches += static_cast<std::size_t>(!pred(v1[i], v2[i]));
+                double diff = value_distance(v1[i], v2[i]);
+                max_diff = diff > max_diff ? diff : max_diff;
+            }
+            res.m_size = last - first;
+            res.m_value_mismatches = mismatches;
+            res.m_max_abs_diff = max_diff;
+            if (mismatches != 0)
+            {
+                std::size_t i = first;
+                while (pred(v1[i], v2[i]))
+                {
+                    ++i;
+                }
+                res.m_first_mismatch = i;
+            }
+        }
+
+        template <class T1, class T2, class F1, class F2, class P>
+        inline void compare_flagged_values(const T1* v1, const T2* v2, const F1& f1, const F2& f2,
+                                           std::size_t first, std::size_t last,
+                                           const P& pred, xcomparison_result& res)
+        {
+            std::size_t value_mismatches = 0;
+            std::size_t missing_mismatches = 0;
+            double max_diff = 0.;
+            for (std::size_t i = first; i < last; ++i)
+            {
+                bool h1 = f1[i];
+                bool h2 = f2[i];
+                bool both = h1 && h2;
+                missing_mismatches += static_cast<std::size_t>(h1 != h2);
+                value_mismatches += static_cast<std::size_t>(both && !pred(v1[i], v2[i]));
+                double diff = both ? value_distance(v1[i], v2[i]) : 0.;
+                max_diff = diff > max_diff ? diff : max_diff;
+            }
+            res.m_size = last - first;
+            res.m_value_mismatches = value_mismatches;
+            res.m_missing_mismatches = missing_mismatches;
+            res.m_max_abs_diff = max_diff;
+            if (value_mismatches + missing_mismatches != 0)
+            {
+                std::size_t i = first;
+                while (bool(f1[i]) == bool(f2[i]) && (!f1[i] || pred(v1[i], v2[i])))
+                {
+                    ++i;
+                }
+                res.m_first_mismatch = i;
+            }
+        }
+
+        template <class D1, class D2, class P>
+        inline void compare_flat_storage(const D1& d1, const D2& d2, const P& pred,
+                                         std::size_t nb_threads, xcomparison_result& res)
+        {
+            const auto* v1 = d1.value().data().data();
+            const auto* v2 = d2.value().data().data();
+            const auto& f1 = d1.has_value().data();
+            const auto& f2 = d2.has_value().data();
+            bool check_flags = !(flag_storage_traits<std::decay_t<decltype(f1)>>::all_set(f1) &&
+                                 flag_storage_traits<std::decay_t<decltype(f2)>>::all_set(f2));
+
+            const std::size_t size = d1.value().size();
+            const std::size_t nb_tasks = (size + compare_task_size - 1) / compare_task_size;
+            std::vector<xcomparison_result> parts(nb_tasks);
+            parallel_for(nb_tasks, nb_threads, [&](std::size_t task)
+            {
+                std::size_t first = task * compare_task_size;
+                std::size_t last = std::min(first + compare_task_size, size);
+                if (check_flags)
+                {
+                    compare_flagged_values(v1, v2, f1, f2, first, last, pred, parts[task]);
+                }
+                else
+                {
+                    compare_values(v1, v2, first, last, pred, parts[task]);
+                }
+            });
+
+            for (const auto& part : parts)
+            {
+                merge_comparison(res, part);
+            }
+        }
+
+        /********************
+         * generic elements *
+         ********************/
+
+        template <class T, class = void>
+        struct is_optional_element : std::false_type
+        {
+        };
+
+        template <class T>
+        struct is_optional_element<T, xt::void_t<decltype(std::declval<const T&>().has_value()),
+                                                 decltype(std::declval<const T&>().value())>>
+            : std::true_type
+        {
+        };
+
+        template <class T>
+        inline bool element_has_value(const T& t, std::true_type)
+        {
+            return t.has_value();
+        }
+
+        template <class T>
+        inline bool element_has_value(const T&, std::false_type)
+        {
+            return true;
+        }
+
+        template <class T>
+        inline decltype(auto) element_value(const T& t, std::true_type)
+        {
+            return t.value();
+        }
+
+        template <class T>
+        inline const T& element_value(const T& t, std::false_type)
+        {
+            return t;
+        }
+
+        // Fallback for expressions without flat storage: elements are
+        // iterated in row-major order on the calling thread.
+        template <class D1, class D2, class P>
+        inline void compare_elements(const D1& d1, const D2& d2, const P& pred, xcomparison_result& res)
+        {
+            auto iter1 = d1.cbegin();
+            auto iter2 = d2.cbegin();
+            std::size_t size = static_cast<std::size_t>(d1.size());
+            for (std::size_t i = 0; i < size; ++i, ++iter1, ++iter2)
+            {
+                const auto& x1 = *iter1;
+                const auto& x2 = *iter2;
+                using opt1 = is_optional_element<std::decay_t<decltype(x1)>>;
+                using opt2 = is_optional_element<std::decay_t<decltype(x2)>>;
+                bool h1 = element_has_value(x1, opt1());
+                bool h2 = element_has_value(x2, opt2());
+                bool mismatch = h1 != h2;
+                if (h1 && h2)
+                {
+                    const auto& val1 = element_value(x1, opt1());
+                    const auto& val2 = element_value(x2, opt2());
+                    double diff = value_distance(val1, val2);
+                    res.m_max_abs_diff = diff > res.m_max_abs_diff ? diff : res.m_max_abs_diff;
+                    if (!pred(val1, val2))
+                    {
+                        ++res.m_value_mismatches;
+                        mismatch = true;
+                    }
+                }
+                else if (mismatch)
+                {
+                    ++res.m_missing_mismatches;
+                }
+                if (mismatch && res.m_first_mismatch == xcomparison_result::npos)
+                {
+                    res.m_first_mismatch = i;
+                }
+            }
+            res.m_size = size;
+        }
+
+        template <class D1, class D2, class P>
+        inline void compare_data(const D1& d1, const D2& d2, const P& pred, std::size_t nb_threads,
+                                 xcomparison_result& res, std::true_type)
+        {
+            if (flat_storage_compatible(d1, d2))
+            {
+                compare_flat_storage(d1, d2, pred, nb_threads, res);
+            }
+            else
+            {
+                compare_elements(d1, d2, pred, res);
+            }
+        }
+
+        template <class D1, class D2, class P>
+        inline void compare_data(const D1& d1, const D2& d2, const P& pred, std::size_t /*nb_threads*/,
+                                 xcomparison_result& res, std::false_type)
+        {
+            compare_elements(d1, d2, pred, res);
+        }
+
+        template <class E1, class E2, class P>
+        inline xcomparison_result compare_impl(const E1& e1, const E2& e2, const P& pred, std::size_t nb_threads)
+        {
+            xcomparison_result res;
+            res.m_same_coordinates = e1.coordinates() == e2.coordinates() &&
+                e1.dimension_mapping() == e2.dimension_mapping();
+            if (res.m_same_coordinates)
+            {
+                const auto& d1 = e1.data();
+                const auto& d2 = e2.data();
+                using d1_type = std::decay_t<decltype(d1)>;
+                using d2_type = std::decay_t<decltype(d2)>;
+                using flat = xtl::conjunction<has_flat_storage<d1_type>, has_flat_storage<d2_type>>;
+                compare_data(d1, d2, pred, nb_threads, res, flat());
+            }
+            return res;
+        }
+    }
+
+    /**
+     * Compares two variables element-wise. The coordinates and the dimension
+     * mappings are compared first, so that variables sharing their coordinates
+     * are not compared axis by axis. When both variables hold their data in
+     * dense containers, the value and flag buffers are compared directly, in
+     * tasks distributed over \c nb_threads threads; other expressions are
+     * compared element by element.
+     * @param e1 the first variable.
+     * @param e2 the second variable.
+     * @param nb_threads the maximal number of threads used.
+     * @return the number and the position of the mismatching elements.
+     * @sa compare_close
+     */
+    template <class E1, class E2>
+    inline std::enable_if_t<xvariable_comparable<E1, E2>::value, xcomparison_result>
+    compare(const xt::xexpression<E1>& e1, const xt::xexpression<E2>& e2, std::size_t nb_threads)
+    {
+        return detail::compare_impl(e1.derived_cast(), e2.derived_cast(), detail::exact_predicate(), nb_threads);
+    }
+
+    /**
+     * Compares two variables element-wise up to a tolerance: two values
+     * \c a and \c b are close if <tt>|a - b| <= atol + rtol * |b|</tt>.
+     * Missing elements match missing elements only.
+     * @param e1 the first variable.
+     * @param e2 the second variable.
+     * @param rtol the relative tolerance.
+     * @param atol the absolute tolerance.
+     * @param nb_threads the maximal number of threads used.
+     * @return the number and the position of the elements which are not close.
+     * @sa compare
+     */
+    template <class E1, class E2>
+    inline std::enable_if_t<xvariable_comparable<E1, E2>::value, xcomparison_result>
+    compare_close(const xt::xexpression<E1>& e1, const xt::xexpression<E2>& e2,
+                  double rtol, double atol, std::size_t nb_threads)
+    {
+        return detail::compare_impl(e1.derived_cast(), e2.derived_cast(), detail::close_predicate{rtol, atol}, nb_threads);
+    }
+
+    /**
+     * Returns true if two variables have the same coordinates and
+     * all their elements are close.
+     * @sa compare_close
+     */
+    template <class E1, class E2>
+    inline std::enable_if_t<xvariable_comparable<E1, E2>::value, bool>
+    allclose(const xt::xexpression<E1>& e1, const xt::xexpression<E2>& e2,
+             double rtol, double atol, std::size_t nb_threads)
+    {
+        return compare_close(e1, e2, rtol, atol, nb_threads).equal();
+    }
+}
+
+#endif
@@ -9,9 +9,12 @@
 #ifndef XFRAME_XVARIABLE_FUNCTION_HPP
 #define XFRAME_XVARIABLE_FUNCTION_HPP
 
+#include <memory>
+
 #include "xtensor/xoptional.hpp"
 
 #include "xcoordinate.hpp"
+#include "xcoordinate_cache.hpp"
 #include "xselecting.hpp"
 #include "xvariable_meta.hpp"
 #include "xvariable_scalar.hpp"
@@ -105,9 +108,15 @@ namespace xf
         const_reference select(selector_sequence_type<N>&& selector) const;
 
         const std::tuple<xvariable_closure_t<CT>...>& arguments() const { return m_e; }
+        const functor_type& functor() const { return m_f; }
+
+        bool all_valid() const;
 
     private:
 
+        template <std::size_t... I>
+        bool all_valid_impl(std::index_sequence<I...>) const;
+
         template <class Join>
         void compute_coordinates() const;
 
@@ -120,16 +129,23 @@ namespace xf
         template <class Join, std::size_t... I, class S>
         const_reference select_impl(std::index_sequence<I...>, S&& selector) const;
 
-        template <std::size_t...I>
+        template <std::size_t... I>
         bool merge_dimension_mapping(std::index_sequence<I...>, dimension_type& dims) const;
 
+        struct coordinate_state
+        {
+            coordinate_type m_coordinate;
+            dimension_type m_dimension_mapping;
+            join::join_id m_join_id;
+            xtrivial_broadcast m_trivial_broadcast;
+        };
+
         std::tuple<xvariable_closure_t<CT>...> m_e;
         functor_type m_f;
-        mutable coordinate_type m_coordinate;
-        mutable dimension_type m_dimension_mapping;
-        mutable join::join_id m_join_id;
-        mutable bool m_coordinate_computed;
-        mutable xtrivial_broadcast m_trivial_broadcast;
+        // Only allocated when the coordinates of this node are queried,
+        // i.e. at the root of an expression tree: inner nodes forward the
+        // broadcast to their operands and never hold coordinates.
+        mutable std::shared_ptr<const coordinate_state> m_state;
     };
 
     template <class F, class R, class... CT>
@@ -144,10 +160,7 @@ namespace xf
     inline xvariable_function<F, R, CT...>::xvariable_function(Func&& f, CT... e) noexcept
         : m_e(e...),
           m_f(std::forward<Func>(f)),
-          m_coordinate(),
-          m_dimension_mapping(),
-          m_join_id(join::inner::id()),
-          m_coordinate_computed(false)
+          m_state(nullptr)
     {
     }
 
@@ -180,7 +193,7 @@ namespace xf
     inline auto xvariable_function<F, R, CT...>::coordinates() const -> const coordinate_type&
     {
         compute_coordinates<Join>();
-        return m_coordinate;
+        return m_state->m_coordinate;
     }
 
     template <class F, class R, class... CT>
@@ -188,7 +201,7 @@ namespace xf
     inline auto xvariable_function<F, R, CT...>::dimension_mapping() const -> const dimension_type&
     {
         compute_coordinates<Join>();
-        return m_dimension_mapping;
+        return m_state->m_dimension_mapping;
     }
 
     template <class F, class R, class... CT>
@@ -239,7 +252,7 @@ namespace xf
         bool ret = true;
         if(trivial_bc)
         {
-            dims = detail::get_first_non_scalar(m_e).dimension_mapping();
+            ret = detail::get_first_non_scalar(m_e).broadcast_dimensions(dims, true);
         }
         else
         {
@@ -281,17 +294,76 @@ namespace xf
         return select_impl<Join>(std::make_index_sequence<sizeof...(CT)>(), std::move(selector));
     }
 
+    /**
+     * Returns true if none of the operands of the function holds a missing
+     * value. The function then holds no missing value either when the labels
+     * of its operands are the same; otherwise, a join over different labels
+     * may still produce missing values where an operand lacks a label.
+     */
+    template <class F, class R, class... CT>
+    inline bool xvariable_function<F, R, CT...>::all_valid() const
+    {
+        return all_valid_impl(std::make_index_sequence<sizeof...(CT)>());
+    }
+
+    template <class F, class R, class... CT>
+    template <std::size_t... I>
+    inline bool xvariable_function<F, R, CT...>::all_valid_impl(std::index_sequence<I...>) const
+    {
+        bool res = true;
+        bool dummy[] = { true, (res = res && detail::expression_all_valid(std::get<I>(m_e)))... };
+        (void)dummy;
+        return res;
+    }
+
+    namespace detail
+    {
+        template <class Join, class E>
+        inline bool add_operand_stamp(std::vector<std::size_t>& key, const E& e)
+        {
+            return add_coordinate_stamp(key, e.coordinates());
+        }
+
+        // Nested functions contribute the stamps of their own operands, so
+        // that the key only depends on the leaves of the expression tree.
+        template <class Join, class F, class R, class... CT>
+        inline bool add_operand_stamp(std::vector<std::size_t>& key, const xvariable_function<F, R, CT...>& e)
+        {
+            auto add_stamp = [&key](bool cacheable, const auto& arg) {
+                return add_operand_stamp<Join>(key, arg) && cacheable;
+            };
+            return xt::accumulate(add_stamp, true, e.arguments());
+        }
+    }
+
     template <class F, class R, class... CT>
     template <class Join>
     inline void xvariable_function<F, R, CT...>::compute_coordinates() const
     {
-        if(!m_coordinate_computed || m_join_id != Join::id())
+        if(m_state == nullptr || m_state->m_join_id != Join::id())
         {
-            m_coordinate.clear();
-            m_trivial_broadcast = broadcast_coordinates<Join>(m_coordinate);
-            broadcast_dimensions(m_dimension_mapping, m_trivial_broadcast.m_same_dimensions);
-            m_coordinate_computed = true;
-            m_join_id = Join::id();
+            // The coordinates and the dimension mapping are broadcast in a
+            // single pass over the leaves of the expression tree; the state
+            // is never modified once built, so that copies of the function
+            // can share it.
+            auto state = std::make_shared<coordinate_state>();
+            // The broadcast only depends on the coordinates of the leaves:
+            // when all of them have a stamp, the result is looked up in the
+            // coordinate cache instead of merging the axes again.
+            auto key = detail::make_coordinate_cache_key<Join>();
+            bool cacheable = XFRAME_COORDINATE_CACHE_SIZE != 0 && detail::add_operand_stamp<Join>(key, *this);
+            auto& cache = xcoordinate_cache<coordinate_type>::instance();
+            if (!cacheable || !cache.find(key, state->m_coordinate, state->m_trivial_broadcast))
+            {
+                state->m_trivial_broadcast = broadcast_coordinates<Join>(state->m_coordinate);
+                if (cacheable)
+                {
+                    cache.insert(std::move(key), state->m_coordinate, state->m_trivial_broadcast);
+                }
+            }
+            broadcast_dimensions(state->m_dimension_mapping, state->m_trivial_broadcast.m_same_dimensions);
+            state->m_join_id = Join::id();
+            m_state = std::move(state);
         }
     }
 
@@ -320,7 +392,10 @@ namespace xf
     template <std::size_t...I>
     bool xvariable_function<F, R, CT...>::merge_dimension_mapping(std::index_sequence<I...>, dimension_type& dims) const
     {
-        return xf::broadcast_dimensions(dims, std::get<I>(m_e).dimension_mapping()...);
+        bool res = true;
+        bool dummy[] = { true, (res = std::get<I>(m_e).broadcast_dimensions(dims) && res)... };
+        (void)dummy;
+        return res;
     }
 
     template <class F, class R, class... CT>
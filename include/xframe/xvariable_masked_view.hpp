@@ -10,6 +10,10 @@
 #ifndef XFRAME_XWHERE_VIEW_HPP
 #define XFRAME_XWHERE_VIEW_HPP
 
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
 #include "xtensor/xgenerator.hpp"
 #include "xtensor/xmasked_view.hpp"
 
@@ -290,6 +294,185 @@ namespace xf
         return xvariable_masked_view<EV, EAX>(std::forward<EV>(variable_expr), std::forward<EAX>(axis_expr));
     }
 
+    namespace detail
+    {
+        template <class M, class S>
+        inline std::vector<std::vector<std::size_t>> where_keep_indices(const M& mask, const S& shape, bool drop)
+        {
+            using index_list = std::vector<std::size_t>;
+            const auto& mask_dims = mask.dimensions();
+            const auto& mask_shape = mask.shape();
+            const std::size_t mask_rank = mask_dims.size();
+
+            // flags[i][k] is set when a cell of the mask with position k along
+            // its i-th dimension is true.
+            std::vector<std::vector<char>> flags(mask_rank);
+            for (std::size_t i = 0; i < mask_rank; ++i)
+            {
+                if (mask_shape[i] != static_cast<std::size_t>(shape[mask_dims[i]]))
+                {
+                    throw std::runtime_error("where: axis expression does not match the axes of the variable");
+                }
+                flags[i].resize(mask_shape[i], char(!drop));
+            }
+            if (drop)
+            {
+                index_list index(mask_rank, std::size_t(0));
+                for (std::size_t n = 0; n < mask.size(); ++n)
+                {
+                    if (mask.values()[n])
+                    {
+                        for (std::size_t i = 0; i < mask_rank; ++i)
+                        {
+                            flags[i][index[i]] = 1;
+                        }
+                    }
+                    for (std::size_t i = mask_rank; i != 0; --i)
+                    {
+                        if (++index[i - 1] != mask_shape[i - 1])
+                        {
+                            break;
+                        }
+                        index[i - 1] = 0;
+                    }
+                }
+            }
+
+            std::vector<index_list> res(shape.size());
+            std::size_t j = 0;
+            for (std::size_t d = 0; d < res.size(); ++d)
+            {
+                if (j < mask_rank && mask_dims[j] == d)
+                {
+                    for (std::size_t k = 0; k < flags[j].size(); ++k)
+                    {
+                        if (flags[j][k])
+                        {
+                            res[d].push_back(k);
+                        }
+                    }
+                    ++j;
+                }
+                else
+                {
+                    res[d].resize(static_cast<std::size_t>(shape[d]));
+                    std::iota(res[d].begin(), res[d].end(), std::size_t(0));
+                }
+            }
+            return res;
+        }
+    }
+
+    /**
+     * Returns a new variable holding the values of \c variable_expr where the
+     * axis expression is true, and missing values elsewhere. When \c drop is
+     * true, the labels for which the axis expression is false on the whole
+     * remaining dimensions are removed from the result, so that downstream
+     * computations work on fewer values:
+     * ```
+     * // res only holds the ordinates lower than 6
+     * auto res = where(var, var.axis<int>("ordinate") < 6, true);
+     * ```
+     * The axis expression is evaluated once on the axes of the variable, and
+     * the kept positions of each dimension are computed before the data is
+     * gathered.
+     * @param variable_expr the variable.
+     * @param axis_expr the axis expression.
+     * @param drop whether to remove the labels filtered out.
+     * @return a variable.
+     */
+    template <class EV, class EAX>
+    inline auto where(EV&& variable_expr, EAX&& axis_expr, bool drop)
+    {
+        using variable_type = std::decay_t<EV>;
+        using temporary_type = typename variable_type::temporary_type;
+        using coordinate_map = typename temporary_type::coordinate_map;
+        using dimension_list = typename temporary_type::dimension_list;
+        using const_reference = typename variable_type::const_reference;
+        using index_list = std::vector<std::size_t>;
+
+        const auto& dim_mapping = variable_expr.dimension_mapping();
+        const auto& shape = variable_expr.shape();
+        auto mask = axis_expr.evaluate_axes(dim_mapping);
+        std::vector<index_list> indices = detail::where_keep_indices(mask, shape, drop);
+        const std::size_t rank = indices.size();
+
+        const auto& names = dim_mapping.labels();
+        coordinate_map coords;
+        for (std::size_t d = 0; d < rank; ++d)
+        {
+            const auto& axis = variable_expr.coordinates()[names[d]];
+            if (indices[d].size() == axis.size())
+            {
+                coords.emplace(names[d], axis);
+            }
+            else
+            {
+                std::size_t pos = 0;
+                std::size_t kept = 0;
+                const index_list& keep = indices[d];
+                auto pred = [&keep, &pos, &kept](const auto&) {
+                    bool res = kept < keep.size() && keep[kept] == pos++;
+                    kept += res ? 1 : 0;
+                    return res;
+                };
+                coords.emplace(names[d], axis.filter(pred, keep.size()));
+            }
+        }
+        temporary_type res(std::move(coords), dimension_list(names.cbegin(), names.cend()));
+
+        // Gathers the kept values row by row: only the last index changes
+        // in the inner loop.
+        std::size_t size = 1;
+        for (const auto& keep : indices)
+        {
+            size *= keep.size();
+        }
+        if (size == 0)
+        {
+            return res;
+        }
+        index_list dst_index(rank, std::size_t(0));
+        index_list src_index(rank);
+        for (std::size_t d = 0; d < rank; ++d)
+        {
+            src_index[d] = indices[d].front();
+        }
+        const std::size_t inner_size = rank != 0 ? indices.back().size() : std::size_t(1);
+        const auto& data = variable_expr.data();
+        auto& res_data = res.data();
+        for (std::size_t n = 0; n < size; n += inner_size)
+        {
+            for (std::size_t j = 0; j < inner_size; ++j)
+            {
+                if (rank != 0)
+                {
+                    dst_index.back() = j;
+                    src_index.back() = indices.back()[j];
+                }
+                if (mask.element(src_index.cbegin(), src_index.cend()))
+                {
+                    res_data.element(dst_index.cbegin(), dst_index.cend()) = data.element(src_index.cbegin(), src_index.cend());
+                }
+                else
+                {
+                    res_data.element(dst_index.cbegin(), dst_index.cend()) = detail::static_missing<const_reference>();
+                }
+            }
+            for (std::size_t d = rank > 0 ? rank - 1 : 0; d != 0; --d)
+            {
+                if (++dst_index[d - 1] != indices[d - 1].size())
+                {
+                    src_index[d - 1] = indices[d - 1][dst_index[d - 1]];
+                    break;
+                }
+                dst_index[d - 1] = 0;
+                src_index[d - 1] = indices[d - 1].front();
+            }
+        }
+        return res;
+    }
+
     template <class EV, class EAX>
     inline std::ostream& operator<<(std::ostream& out, const xvariable_masked_view<EV, EAX>& v)
     {
@@ -33,9 +33,9 @@ namespace xt
         const E1& de1 = e1.derived_cast();
         const E2& de2 = e2.derived_cast();
 
-        return de1.data() == de2.data() &&
-            de1.coordinates() == de2.coordinates() &&
-            de1.dimension_mapping() == de2.dimension_mapping();
+        return de1.coordinates() == de2.coordinates() &&
+            de1.dimension_mapping() == de2.dimension_mapping() &&
+            de1.data() == de2.data();
     }
 }
 
@@ -9,6 +9,7 @@
 #ifndef XFRAME_XVARIABLE_SCALAR_HPP
 #define XFRAME_XVARIABLE_SCALAR_HPP
 
+#include "xtl/xoptional.hpp"
 #include "xtensor/xscalar.hpp"
 #include "xcoordinate.hpp"
 
@@ -57,6 +58,8 @@ namespace xf
         template <class Join = XFRAME_DEFAULT_JOIN, std::size_t N = dynamic(), class S = std::size_t>
         const_reference select(const S&) const noexcept;
 
+        bool all_valid() const noexcept;
+
     private:
 
         data_type m_data;
@@ -148,6 +151,27 @@ namespace xf
         // (split_optional_expression_impl needs to catch ref and const ref on xscalar)
         return m_data();
     }
+
+    namespace detail
+    {
+        template <class T>
+        inline bool is_valid_scalar(const T&) noexcept
+        {
+            return true;
+        }
+
+        template <class T, class B>
+        inline bool is_valid_scalar(const xtl::xoptional<T, B>& v) noexcept
+        {
+            return v.has_value();
+        }
+    }
+
+    template <class CT>
+    inline bool xvariable_scalar<CT>::all_valid() const noexcept
+    {
+        return detail::is_valid_scalar(m_data());
+    }
 }
 
 #endif
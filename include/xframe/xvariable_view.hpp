@@ -9,7 +9,12 @@
 #ifndef XFRAME_XVARIABLE_VIEW_HPP
 #define XFRAME_XVARIABLE_VIEW_HPP
 
+#include <algorithm>
+#include <memory>
+#include <vector>
+
 #include "xtensor/xdynamic_view.hpp"
+#include "xtensor/xstrided_view.hpp"
 
 #include "xvariable.hpp"
 #include "xcoordinate_system.hpp"
@@ -18,6 +23,236 @@
 namespace xf
 {
 
+    /******************
+     * view_positions *
+     ******************/
+
+    namespace detail
+    {
+        template <class D, class = void>
+        struct has_strided_storage : std::false_type
+        {
+        };
+
+        template <class D>
+        struct has_strided_storage<D, xt::void_t<decltype(std::declval<D&>().value().data()),
+                                                 decltype(std::declval<D&>().value().strides()),
+                                                 decltype(std::declval<D&>().has_value().data())>>
+            : std::true_type
+        {
+        };
+
+        /**
+         * Positions in the underlying expression of the elements of a view,
+         * computed from its coordinates when it is first assigned. Dimensions sliced with a range,
+         * a stepped range, all or a squeeze are strided, other dimensions
+         * (keep and drop slices) are gathered through their position list.
+         */
+        class view_positions
+        {
+        public:
+
+            using size_type = std::size_t;
+            using index_list = std::vector<size_type>;
+
+            view_positions() = default;
+
+            template <class C, class DL, class SQ>
+            view_positions(const C& coords, const DL& dim_labels, const SQ& squeeze);
+
+            size_type dimension() const noexcept;
+            size_type size() const noexcept;
+            const index_list& positions(size_type d) const noexcept;
+            bool is_strided(size_type d) const noexcept;
+
+            template <class S, class F>
+            void for_each_offset(const S& strides, F&& f) const;
+
+            template <class I, class F>
+            void for_each_index(I& index, F&& f) const;
+
+        private:
+
+            std::vector<index_list> m_positions;
+            std::vector<std::ptrdiff_t> m_steps;
+            std::vector<char> m_strided;
+        };
+
+        /**
+         * @param coords the coordinates of the view.
+         * @param dim_labels the dimension labels of the underlying expression.
+         * @param squeeze the squeezed dimensions, mapping an underlying
+         *                dimension to its position.
+         */
+        template <class C, class DL, class SQ>
+        inline view_positions::view_positions(const C& coords, const DL& dim_labels, const SQ& squeeze)
+            : m_positions(dim_labels.size()), m_steps(dim_labels.size(), 0), m_strided(dim_labels.size(), 1)
+        {
+            for (size_type d = 0; d < dim_labels.size(); ++d)
+            {
+                index_list& pos = m_positions[d];
+                auto iter = squeeze.find(d);
+                if (iter != squeeze.end())
+                {
+                    pos.push_back(static_cast<size_type>(iter->second));
+                    continue;
+                }
+                const auto& axis = coords[dim_labels[d]];
+                pos.resize(axis.size());
+                for (size_type i = 0; i < pos.size(); ++i)
+                {
+                    pos[i] = static_cast<size_type>(axis.index(i));
+                }
+                if (pos.size() > 1)
+                {
+                    m_steps[d] = static_cast<std::ptrdiff_t>(pos[1]) - static_cast<std::ptrdiff_t>(pos[0]);
+                    for (size_type i = 2; i < pos.size() && m_strided[d]; ++i)
+                    {
+                        m_strided[d] = static_cast<std::ptrdiff_t>(pos[i]) - static_cast<std::ptrdiff_t>(pos[i - 1]) == m_steps[d];
+                    }
+                }
+            }
+        }
+
+        inline auto view_positions::dimension() const noexcept -> size_type
+        {
+            return m_positions.size();
+        }
+
+        inline auto view_positions::size() const noexcept -> size_type
+        {
+            size_type res = 1;
+            for (const auto& pos : m_positions)
+            {
+                res *= pos.size();
+            }
+            return res;
+        }
+
+        inline auto view_positions::positions(size_type d) const noexcept -> const index_list&
+        {
+            return m_positions[d];
+        }
+
+        inline bool view_positions::is_strided(size_type d) const noexcept
+        {
+            return m_strided[d] != 0;
+        }
+
+        /**
+         * Calls \c f(offset, n) for the n-th element of the view in row-major
+         * order, where offset is the offset of the element in the underlying
+         * storage. The innermost dimension is walked with a constant stride
+         * when it is strided.
+         * @param strides the strides of the underlying storage.
+         * @param f the function to call.
+         */
+        template <class S, class F>
+        inline void view_positions::for_each_offset(const S& strides, F&& f) const
+        {
+            const size_type rank = dimension();
+            if (rank == 0)
+            {
+                f(size_type(0), size_type(0));
+                return;
+            }
+            if (size() == 0)
+            {
+                return;
+            }
+
+            std::vector<index_list> offsets(rank);
+            for (size_type d = 0; d < rank; ++d)
+            {
+                offsets[d].resize(m_positions[d].size());
+                for (size_type i = 0; i < offsets[d].size(); ++i)
+                {
+                    offsets[d][i] = m_positions[d][i] * static_cast<size_type>(strides[d]);
+                }
+            }
+
+            const index_list& inner = offsets.back();
+            const size_type inner_size = inner.size();
+            const bool inner_strided = is_strided(rank - 1);
+            const std::ptrdiff_t inner_step = m_steps.back() * static_cast<std::ptrdiff_t>(strides[rank - 1]);
+            index_list index(rank - 1, size_type(0));
+            size_type n = 0;
+            bool end = false;
+            while (!end)
+            {
+                size_type base = 0;
+                for (size_type d = 0; d + 1 < rank; ++d)
+                {
+                    base += offsets[d][index[d]];
+                }
+                if (inner_strided)
+                {
+                    std::ptrdiff_t offset = static_cast<std::ptrdiff_t>(base + inner[0]);
+                    for (size_type j = 0; j < inner_size; ++j, offset += inner_step)
+                    {
+                        f(static_cast<size_type>(offset), n++);
+                    }
+                }
+                else
+                {
+                    for (size_type j = 0; j < inner_size; ++j)
+                    {
+                        f(base + inner[j], n++);
+                    }
+                }
+                end = true;
+                for (size_type d = rank - 1; d != 0; --d)
+                {
+                    if (++index[d - 1] != offsets[d - 1].size())
+                    {
+                        end = false;
+                        break;
+                    }
+                    index[d - 1] = 0;
+                }
+            }
+        }
+
+        /**
+         * Calls \c f(index) for each element of the view in row-major order,
+         * where index holds the positions of the element in the underlying
+         * expression.
+         * @param index the index to fill, of size dimension().
+         * @param f the function to call.
+         */
+        template <class I, class F>
+        inline void view_positions::for_each_index(I& index, F&& f) const
+        {
+            const size_type rank = dimension();
+            if (size() == 0)
+            {
+                return;
+            }
+            index_list pos(rank, size_type(0));
+            for (size_type d = 0; d < rank; ++d)
+            {
+                index[d] = m_positions[d][0];
+            }
+            bool end = false;
+            while (!end)
+            {
+                f(index);
+                end = true;
+                for (size_type d = rank; d != 0; --d)
+                {
+                    if (++pos[d - 1] != m_positions[d - 1].size())
+                    {
+                        index[d - 1] = m_positions[d - 1][pos[d - 1]];
+                        end = false;
+                        break;
+                    }
+                    pos[d - 1] = 0;
+                    index[d - 1] = m_positions[d - 1][0];
+                }
+            }
+        }
+    }
+
     /*******************
      * xvariable_view  *
      *******************/
@@ -72,6 +307,7 @@ namespace xf
         using xexpression_type = typename inner_types::xexpression_type;
         using underlying_data_type = typename xexpression_type::data_type;
         using data_type = xt::xdynamic_view<xt::apply_cv_t<CT, underlying_data_type>&, typename underlying_data_type::shape_type>;
+        using strided_data_type = xt::xstrided_view<xt::apply_cv_t<CT, underlying_data_type>&, xt::svector<std::size_t>>;
         using slice_vector = xt::xdynamic_slice_vector;
 
         static constexpr bool is_const = std::is_const<std::remove_reference_t<CT>>::value;
@@ -140,6 +376,10 @@ namespace xf
         data_type& data() noexcept;
         const data_type& data() const noexcept;
 
+        bool is_strided() const noexcept;
+        strided_data_type& strided_data() noexcept;
+        const strided_data_type& strided_data() const noexcept;
+
         template <class... Args>
         reference operator()(Args... args);
 
@@ -202,7 +442,7 @@ namespace xf
 
     private:
 
-        using internal_index_type = std::vector<size_type>;
+        using internal_index_type = index_type<>;
 
         template <std::size_t... I, class... Args>
         reference access_impl(std::index_sequence<I...>, Args... args);
@@ -258,11 +498,23 @@ namespace xf
         template <std::size_t N>
         void adapt_iselector(iselector_sequence_type<N>& selector) const;
 
+        using has_strided_data = std::integral_constant<bool, detail::has_strided_storage<underlying_data_type>::value &&
+                                                              detail::has_data_strides<underlying_data_type>::value>;
+
+        void init_strided_data(const slice_vector& slices, std::true_type);
+        void init_strided_data(const slice_vector& slices, std::false_type);
+
         void assign_temporary_impl(temporary_type&& tmp);
+        const detail::view_positions& positions();
+        bool is_aligned(const temporary_type& tmp) const;
+        void assign_aligned(const temporary_type& tmp, std::true_type);
+        void assign_aligned(const temporary_type& tmp, std::false_type);
 
         CT m_e;
         squeeze_map m_squeeze;
         data_type m_data;
+        std::shared_ptr<strided_data_type> m_strided_data;
+        std::shared_ptr<const detail::view_positions> m_positions;
 
         friend class xt::xview_semantic<xvariable_view<CT>>;
     };
@@ -297,8 +549,11 @@ namespace xf
         : coordinate_base(std::move(coord), std::move(dim)),
           m_e(std::forward<E>(e)),
           m_squeeze(std::move(squeeze)),
-          m_data(xt::dynamic_view(m_e.data(), slices))
+          m_data(xt::dynamic_view(m_e.data(), slices)),
+          m_strided_data(),
+          m_positions()
     {
+        init_strided_data(slices, has_strided_data());
     }
 
     template <class CT>
@@ -348,11 +603,42 @@ namespace xf
         return m_data;
     }
 
+    /**
+     * Returns true if every dimension of the view is sliced with a range,
+     * a stepped range, all or a squeeze, so that its elements can be
+     * accessed through strided_data().
+     */
+    template <class CT>
+    inline bool xvariable_view<CT>::is_strided() const noexcept
+    {
+        return m_strided_data != nullptr;
+    }
+
+    /**
+     * Returns a strided view on the underlying data, holding the same
+     * elements as data(). The view must be strided.
+     */
+    template <class CT>
+    inline auto xvariable_view<CT>::strided_data() noexcept -> strided_data_type&
+    {
+        return *m_strided_data;
+    }
+
+    template <class CT>
+    inline auto xvariable_view<CT>::strided_data() const noexcept -> const strided_data_type&
+    {
+        return *m_strided_data;
+    }
+
     template <class CT>
     template <class... Args>
     inline auto xvariable_view<CT>::operator()(Args... args) ->reference
     {
-        if (m_squeeze.empty())
+        if (is_strided())
+        {
+            return strided_data()(args...);
+        }
+        else if (m_squeeze.empty())
         {
             return access_impl(std::make_index_sequence<sizeof...(Args)>(), args...);
         }
@@ -367,7 +653,11 @@ namespace xf
     template <class... Args>
     inline auto xvariable_view<CT>::operator()(Args... args) const -> const_reference
     {
-        if (m_squeeze.empty())
+        if (is_strided())
+        {
+            return strided_data()(args...);
+        }
+        else if (m_squeeze.empty())
         {
             return access_impl(std::make_index_sequence<sizeof...(Args)>(), args...);
         }
@@ -382,6 +672,10 @@ namespace xf
     template <std::size_t N>
     inline auto xvariable_view<CT>::element(const index_type<N>& index) -> reference
     {
+        if (is_strided())
+        {
+            return strided_data().element(index.cbegin(), index.cend());
+        }
         auto idx = build_element_accessor(index.cbegin(), index.cend());
         return m_e.element(idx.cbegin(), idx.cend());
     }
@@ -390,6 +684,10 @@ namespace xf
     template <std::size_t N>
     inline auto xvariable_view<CT>::element(const index_type<N>& index) const -> const_reference
     {
+        if (is_strided())
+        {
+            return strided_data().element(index.cbegin(), index.cend());
+        }
         auto idx = build_element_accessor(index.cbegin(), index.cend());
         return m_e.element(idx.cbegin(), idx.cend());
     }
@@ -398,6 +696,10 @@ namespace xf
     template <std::size_t N>
     inline auto xvariable_view<CT>::element(index_type<N>&& index) -> reference
     {
+        if (is_strided())
+        {
+            return strided_data().element(index.cbegin(), index.cend());
+        }
         auto idx = build_element_accessor(index.cbegin(), index.cend());
         return m_e.element(idx);
     }
@@ -406,6 +708,10 @@ namespace xf
     template <std::size_t N>
     inline auto xvariable_view<CT>::element(index_type<N>&& index) const -> const_reference
     {
+        if (is_strided())
+        {
+            return strided_data().element(index.cbegin(), index.cend());
+        }
         auto idx = build_element_accessor(index.cbegin(), index.cend());
         return m_e.element(idx);
     }
@@ -745,11 +1051,77 @@ namespace xf
         }
     }
 
+    // Range, stepped range, all and squeeze slices keep the elements of the
+    // view evenly spaced in the underlying data: the view is then given
+    // the shape, the strides and the offset of these elements, so that
+    // they can be read and assigned without going through the slices.
+    // Keep and drop slices are left to the dynamic view.
+    template <class CT>
+    inline void xvariable_view<CT>::init_strided_data(const slice_vector& slices, std::true_type)
+    {
+        auto is_gathered = [](const auto& slice)
+        {
+            return xtl::get_if<xt::xkeep_slice<std::ptrdiff_t>>(&slice) != nullptr ||
+                xtl::get_if<xt::xdrop_slice<std::ptrdiff_t>>(&slice) != nullptr;
+        };
+        if (slices.size() != m_e.dimension() || std::any_of(slices.cbegin(), slices.cend(), is_gathered))
+        {
+            return;
+        }
+
+        using strided_shape_type = xt::svector<std::size_t>;
+        using strides_type = typename strided_data_type::strides_type;
+        using stride_type = typename strides_type::value_type;
+        auto& data = m_e.data();
+        const auto& dim_labels = m_e.dimension_labels();
+        const auto& coords = coordinates();
+        strided_shape_type shape;
+        strides_type strides;
+        std::ptrdiff_t offset = static_cast<std::ptrdiff_t>(data.data_offset());
+        for (size_type d = 0; d < dim_labels.size(); ++d)
+        {
+            std::ptrdiff_t stride = static_cast<std::ptrdiff_t>(data.strides()[d]);
+            auto iter = m_squeeze.find(d);
+            if (iter != m_squeeze.end())
+            {
+                offset += static_cast<std::ptrdiff_t>(iter->second) * stride;
+                continue;
+            }
+            const auto& axis = coords[dim_labels[d]];
+            std::size_t size = axis.size();
+            std::ptrdiff_t first = size != 0 ? static_cast<std::ptrdiff_t>(axis.index(0)) : 0;
+            std::ptrdiff_t step = size > 1 ? static_cast<std::ptrdiff_t>(axis.index(1)) - first : 0;
+            offset += first * stride;
+            shape.push_back(size);
+            strides.push_back(static_cast<stride_type>(step * stride));
+        }
+        m_strided_data = std::make_shared<strided_data_type>(xt::strided_view(data, std::move(shape), std::move(strides),
+                                                                              static_cast<std::size_t>(offset),
+                                                                              xt::layout_type::dynamic));
+    }
+
+    template <class CT>
+    inline void xvariable_view<CT>::init_strided_data(const slice_vector& /*slices*/, std::false_type)
+    {
+    }
+
     template <class CT>
     inline void xvariable_view<CT>::assign_temporary_impl(temporary_type&& tmp)
     {
-        // TODO: improve this with iterators when they are available
         const temporary_type& tmp2 = tmp;
+        if (is_aligned(tmp2))
+        {
+            if (is_strided())
+            {
+                xt::noalias(*m_strided_data) = tmp2.data();
+            }
+            else
+            {
+                assign_aligned(tmp2, detail::has_strided_storage<underlying_data_type>());
+            }
+            return;
+        }
+
         const auto& dim_label = dimension_labels();
         const auto& coords = coordinates();
         std::vector<size_type> index(dim_label.size(), size_type(0));
@@ -766,6 +1138,67 @@ namespace xf
         } while (!end);
     }
 
+    // The positions in the underlying expression are only needed to assign
+    // aligned temporaries; they are built on the first such assignment and
+    // shared by the copies of the view, which have the same coordinates.
+    template <class CT>
+    inline auto xvariable_view<CT>::positions() -> const detail::view_positions&
+    {
+        if (m_positions == nullptr)
+        {
+            m_positions = std::make_shared<const detail::view_positions>(coordinates(), m_e.dimension_labels(), m_squeeze);
+        }
+        return *m_positions;
+    }
+
+    /**
+     * Returns true if the temporary has the same dimensions and the same
+     * labels as the view, so that its elements can be assigned by position.
+     */
+    template <class CT>
+    inline bool xvariable_view<CT>::is_aligned(const temporary_type& tmp) const
+    {
+        const auto& dim_label = dimension_labels();
+        if (tmp.dimension_labels() != dim_label)
+        {
+            return false;
+        }
+        const auto& coords = coordinates();
+        const auto& tmp_coords = tmp.coordinates();
+        return std::all_of(dim_label.cbegin(), dim_label.cend(), [&coords, &tmp_coords](const auto& label)
+        {
+            return tmp_coords[label] == coords[label];
+        });
+    }
+
+    template <class CT>
+    inline void xvariable_view<CT>::assign_aligned(const temporary_type& tmp, std::true_type)
+    {
+        auto& underlying = m_e.data();
+        auto& values = underlying.value().data();
+        auto& flags = underlying.has_value().data();
+        const auto& tmp_values = tmp.data().value().data();
+        const auto& tmp_flags = tmp.data().has_value().data();
+        positions().for_each_offset(underlying.value().strides(), [&](size_type offset, size_type n)
+        {
+            values[offset] = tmp_values[n];
+            flags[offset] = tmp_flags[n];
+        });
+    }
+
+    template <class CT>
+    inline void xvariable_view<CT>::assign_aligned(const temporary_type& tmp, std::false_type)
+    {
+        const detail::view_positions& pos = positions();
+        internal_index_type index(pos.dimension());
+        const auto& tmp_data = tmp.data();
+        auto tmp_iter = tmp_data.cbegin();
+        pos.for_each_index(index, [&](const internal_index_type& idx)
+        {
+            m_e.element(idx) = *tmp_iter++;
+        });
+    }
+
     template <class CT>
     inline std::ostream& operator<<(std::ostream& out, const xvariable_view<CT>& v)
     {
@@ -0,0 +1,72 @@
+/***************************************************************************
+* Copyright (c) 2017, Johan Mabille, Sylvain Corlay, Wolf Vollprecht and   *
+* Martin Renou                                                             *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "test_fixture.hpp"
+
+#include "xframe/xallocator.hpp"
+
+namespace xf
+{
+    using counting_tag = allocator_tag<hash_map_tag, xcounting_allocator<char>>;
+    using counting_saxis_type = xaxis<fstring, std::size_t, counting_tag>;
+    using counting_data_type = XFRAME_ALLOCATOR_DATA_CONTAINER(double, xcounting_allocator<double>);
+
+    TEST(xallocator, counting_allocator)
+    {
+        reset_allocation_stats();
+        {
+            std::vector<int, xcounting_allocator<int>> v(10);
+            xallocation_stats stats = get_allocation_stats();
+            EXPECT_EQ(stats.m_allocations, 1u);
+            EXPECT_EQ(stats.m_allocated_bytes, 10 * sizeof(int));
+            EXPECT_EQ(stats.live_bytes(), 10 * sizeof(int));
+        }
+        xallocation_stats stats = get_allocation_stats();
+        EXPECT_EQ(stats.m_deallocations, 1u);
+        EXPECT_EQ(stats.live_bytes(), 0u);
+
+        xcounting_allocator<int> a1;
+        xcounting_allocator<double> a2(a1);
+        EXPECT_TRUE(a1 == a2);
+
+        reset_allocation_stats();
+        EXPECT_EQ(get_allocation_stats().m_allocations, 0u);
+    }
+
+    TEST(xallocator, axis)
+    {
+        reset_allocation_stats();
+        counting_saxis_type a = { "a", "c", "d" };
+        EXPECT_GT(get_allocation_stats().m_allocations, 0u);
+        EXPECT_EQ(a["c"], 1u);
+        EXPECT_TRUE(a.contains("d"));
+
+        counting_saxis_type b = { "a", "b" };
+        counting_saxis_type res;
+        merge_axes(res, a, b);
+        EXPECT_EQ(res.size(), 4u);
+        EXPECT_EQ(res["b"], 1u);
+    }
+
+    TEST(xallocator, data_container)
+    {
+        using counting_variable_type = xvariable_container<coordinate_type, counting_data_type>;
+        variable_type v = make_test_variable();
+
+        reset_allocation_stats();
+        counting_variable_type res = v + v;
+        EXPECT_GE(get_allocation_stats().m_allocations, 2u);
+        EXPECT_EQ(res.locate("a", 1), 2.);
+        EXPECT_FALSE(res.locate("a", 4).has_value());
+    }
+}
@@ -0,0 +1,157 @@
+/***************************************************************************
+* Copyright (c) 2017, Johan Mabille, Sylvain Corlay, Wolf Vollprecht and   *
+* Martin Renou                                                             *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include "test_fixture.hpp"
+
+#include "xframe/xarrow.hpp"
+
+namespace xf
+{
+    // Table with dimensions x: { 3, 5 } and y: { 10, 20 }, holding
+    // the rows (5, 20) -> 2.5 and (3, 10) -> N/A
+    struct arrow_test_table
+    {
+        arrow_test_table()
+        {
+            x_dictionary_schema = make_schema("i", "", nullptr);
+            y_dictionary_schema = make_schema("i", "", nullptr);
+            x_schema = make_schema("c", "x", &x_dictionary_schema);
+            y_schema = make_schema("c", "y", &y_dictionary_schema);
+            value_schema = make_schema("g", "value", nullptr);
+            schema_children = { &x_schema, &y_schema, &value_schema };
+            schema = make_schema("+s", "", nullptr);
+            schema.n_children = 3;
+            schema.children = schema_children.data();
+
+            x_dictionary_buffers = { nullptr, x_labels.data() };
+            y_dictionary_buffers = { nullptr, y_labels.data() };
+            x_buffers = { nullptr, x_indices.data() };
+            y_buffers = { nullptr, y_indices.data() };
+            value_buffers = { &validity, values.data() };
+            x_dictionary_array = make_array(2, 0, x_dictionary_buffers.data(), nullptr);
+            y_dictionary_array = make_array(2, 0, y_dictionary_buffers.data(), nullptr);
+            x_array = make_array(2, 0, x_buffers.data(), &x_dictionary_array);
+            y_array = make_array(2, 0, y_buffers.data(), &y_dictionary_array);
+            value_array = make_array(2, 1, value_buffers.data(), nullptr);
+            array_children = { &x_array, &y_array, &value_array };
+            struct_buffers = { nullptr };
+            array = make_array(2, 0, struct_buffers.data(), nullptr);
+            array.n_buffers = 1;
+            array.n_children = 3;
+            array.children = array_children.data();
+        }
+
+        static ArrowSchema make_schema(const char* format, const char* name, ArrowSchema* dictionary)
+        {
+            return ArrowSchema{ format, name, nullptr, 0, 0, nullptr, dictionary, nullptr, nullptr };
+        }
+
+        static ArrowArray make_array(int64_t length, int64_t null_count, const void** buffers, ArrowArray* dictionary)
+        {
+            return ArrowArray{ length, null_count, 0, 2, 0, buffers, nullptr, dictionary, nullptr, nullptr };
+        }
+
+        std::array<int, 2> x_labels = {{ 3, 5 }};
+        std::array<int, 2> y_labels = {{ 10, 20 }};
+        std::array<std::int8_t, 2> x_indices = {{ 1, 0 }};
+        std::array<std::int8_t, 2> y_indices = {{ 1, 0 }};
+        std::array<double, 2> values = {{ 2.5, 0. }};
+        std::uint8_t validity = 1;
+
+        ArrowSchema x_dictionary_schema, y_dictionary_schema, x_schema, y_schema, value_schema, schema;
+        std::array<ArrowSchema*, 3> schema_children;
+        ArrowArray x_dictionary_array, y_dictionary_array, x_array, y_array, value_array, array;
+        std::array<ArrowArray*, 3> array_children;
+        std::array<const void*, 2> x_dictionary_buffers, y_dictionary_buffers, x_buffers, y_buffers, value_buffers;
+        std::array<const void*, 1> struct_buffers;
+    };
+
+    TEST(xarrow, to_arrow)
+    {
+        variable_type var = make_test_variable();
+        ArrowSchema schema;
+        ArrowArray array;
+        to_arrow(var, &schema, &array);
+
+        EXPECT_STREQ(schema.format, "+s");
+        ASSERT_EQ(schema.n_children, 3);
+        EXPECT_STREQ(schema.children[0]->name, "abscissa");
+        EXPECT_STREQ(schema.children[0]->dictionary->format, "u");
+        EXPECT_STREQ(schema.children[1]->name, "ordinate");
+        EXPECT_STREQ(schema.children[1]->dictionary->format, "i");
+        EXPECT_STREQ(schema.children[2]->format, "g");
+        EXPECT_EQ(array.length, 9);
+
+        const ArrowArray& values = *array.children[2];
+        EXPECT_EQ(values.buffers[1], var.data().value().raw_data());
+        EXPECT_EQ(values.null_count, 2);
+
+        const ArrowArray& ordinate = *array.children[1];
+        const std::int32_t* indices = static_cast<const std::int32_t*>(ordinate.buffers[1]);
+        EXPECT_EQ(indices[0], 0);
+        EXPECT_EQ(indices[1], 1);
+        EXPECT_EQ(indices[3], 0);
+        EXPECT_EQ(ordinate.dictionary->buffers[1], get_labels<int>(var.coordinates()["ordinate"]).data());
+
+        schema.release(&schema);
+        array.release(&array);
+        EXPECT_EQ(schema.release, nullptr);
+        EXPECT_EQ(array.release, nullptr);
+    }
+
+    TEST(xarrow, from_arrow)
+    {
+        variable_type var = make_test_variable();
+        ArrowSchema schema;
+        ArrowArray array;
+        to_arrow(var, &schema, &array);
+        variable_type res = from_arrow<double>(schema, array);
+        EXPECT_EQ(res, var);
+        schema.release(&schema);
+        array.release(&array);
+
+        arrow_test_table table;
+        auto res2 = from_arrow<double>(table.schema, table.array);
+        EXPECT_EQ(res2.locate(5, 20), 2.5);
+        EXPECT_FALSE(res2.locate(3, 10).has_value());
+        EXPECT_FALSE(res2.locate(3, 20).has_value());
+        EXPECT_FALSE(res2.locate(5, 10).has_value());
+
+        // Slicing the table skips the row (5, 20)
+        table.array.offset = 1;
+        table.array.length = 1;
+        auto res3 = from_arrow<double>(table.schema, table.array);
+        EXPECT_FALSE(res3.locate(5, 20).has_value());
+        EXPECT_FALSE(res3.locate(3, 10).has_value());
+    }
+
+    TEST(xarrow, adapt_arrow)
+    {
+        variable_type var = make_test_variable();
+        ArrowSchema schema;
+        ArrowArray array;
+        to_arrow(var, &schema, &array);
+
+        auto res = adapt_arrow<double>(schema, array);
+        EXPECT_EQ(res.data().value().raw_data(), var.data().value().raw_data());
+        EXPECT_EQ(res.coordinates(), var.coordinates());
+        EXPECT_EQ(res.dimension_mapping(), var.dimension_mapping());
+        EXPECT_EQ(res.locate("a", 1), var.locate("a", 1));
+        EXPECT_EQ(res.locate("a", 4), var.locate("a", 4));
+        EXPECT_EQ(res.locate("c", 1), var.locate("c", 1));
+        EXPECT_EQ(res.locate("d", 2), var.locate("d", 2));
+        schema.release(&schema);
+        array.release(&array);
+
+        arrow_test_table table;
+        EXPECT_ANY_THROW(adapt_arrow<double>(table.schema, table.array));
+    }
+}
@@ -102,6 +102,73 @@ namespace xf
         EXPECT_THROW(a["d"], std::out_of_range);
     }
 
+    TEST(xaxis, positions)
+    {
+        iaxis_type a = { 1, 3, 4, 7, 9, 12, 15, 20 };
+        std::vector<int> sorted_labels = { 3, 3, 9, 20 };
+        std::vector<std::size_t> res(sorted_labels.size());
+        a.positions(sorted_labels.cbegin(), sorted_labels.cend(), res.begin());
+        EXPECT_EQ(res, std::vector<std::size_t>({ 1, 1, 4, 7 }));
+
+        std::vector<int> unsorted_labels = { 15, 1, 7 };
+        res.resize(unsorted_labels.size());
+        a.positions(unsorted_labels.cbegin(), unsorted_labels.cend(), res.begin());
+        EXPECT_EQ(res, std::vector<std::size_t>({ 6, 0, 3 }));
+
+        std::vector<int> missing_labels = { 3, 5 };
+        EXPECT_THROW(a.positions(missing_labels.cbegin(), missing_labels.cend(), res.begin()), std::out_of_range);
+
+        std::vector<int> partially_sorted_labels = { 3, 9, 4, 20 };
+        res.resize(partially_sorted_labels.size());
+        a.positions(partially_sorted_labels.cbegin(), partially_sorted_labels.cend(), res.begin());
+        EXPECT_EQ(res, std::vector<std::size_t>({ 1, 4, 2, 7 }));
+
+        std::vector<double> double_labels = { 3., 4.5 };
+        EXPECT_THROW(a.positions(double_labels.cbegin(), double_labels.cend(), res.begin()), std::invalid_argument);
+
+        axis_type b = { "c", "a", "b" };
+        label_type slabels = { "a", "b" };
+        res.resize(slabels.size());
+        b.positions(slabels.cbegin(), slabels.cend(), res.begin());
+        EXPECT_EQ(res, std::vector<std::size_t>({ 1, 2 }));
+    }
+
+    TEST(xaxis, range_bounds)
+    {
+        iaxis_type a = { 1, 3, 4, 7, 9, 12 };
+        auto b1 = a.range_bounds(3, 9);
+        EXPECT_EQ(b1.first, 1u);
+        EXPECT_EQ(b1.second, 5u);
+
+        auto b2 = a.range_bounds(2, 10);
+        EXPECT_EQ(b2.first, 1u);
+        EXPECT_EQ(b2.second, 5u);
+
+        auto b3 = a.range_bounds(13, 20);
+        EXPECT_EQ(b3.first, 6u);
+        EXPECT_EQ(b3.second, 6u);
+
+        auto b4 = a.range_bounds(5, 6);
+        EXPECT_EQ(b4.first, b4.second);
+
+        axis_type b = { "c", "a", "b" };
+        auto b5 = b.range_bounds(fstring("a"), fstring("b"));
+        EXPECT_EQ(b5.first, 1u);
+        EXPECT_EQ(b5.second, 3u);
+        EXPECT_THROW(b.range_bounds(fstring("a"), fstring("d")), std::out_of_range);
+    }
+
+    TEST(xaxis, contains_all)
+    {
+        iaxis_type a = { 1, 3, 4, 7, 9 };
+        std::vector<int> l1 = { 1, 4, 9 };
+        std::vector<int> l2 = { 9, 3, 1 };
+        std::vector<int> l3 = { 1, 5 };
+        EXPECT_TRUE(a.contains_all(l1.cbegin(), l1.cend()));
+        EXPECT_TRUE(a.contains_all(l2.cbegin(), l2.cend()));
+        EXPECT_FALSE(a.contains_all(l3.cbegin(), l3.cend()));
+    }
+
     TEST(xaxis, iterator)
     {
         axis_type a = { "a", "b", "c" };
@@ -294,4 +361,42 @@ namespace xf
         EXPECT_EQ(a["a"], 0u);
         EXPECT_EQ(a["b"], 1u);
     }
+
+    TEST(xaxis, shared_labels)
+    {
+        axis_type a = { "a", "b", "d", "e" };
+        axis_type b = a;
+        EXPECT_EQ(&(a.labels()), &(b.labels()));
+        EXPECT_EQ(a, b);
+
+        axis_type c = { "b", "d" };
+        bool t = intersect_axes(b, c);
+        EXPECT_FALSE(t);
+        EXPECT_NE(&(a.labels()), &(b.labels()));
+        EXPECT_EQ(a.size(), 4u);
+        EXPECT_EQ(a["e"], 3u);
+        EXPECT_EQ(b, c);
+        EXPECT_FALSE(b.contains("a"));
+        EXPECT_EQ(b["d"], 1u);
+    }
+
+    TEST(xaxis, fingerprint)
+    {
+        axis_type a = { "a", "b", "d", "e" };
+        axis_type b = { "a", "b", "d", "e" };
+        axis_type c = { "a", "b", "e", "d" };
+        EXPECT_EQ(a.fingerprint(), b.fingerprint());
+        EXPECT_NE(a.fingerprint(), c.fingerprint());
+
+        axis_type tmp = a;
+        EXPECT_TRUE(merge_axes(tmp, a, b));
+        EXPECT_EQ(&(tmp.labels()), &(a.labels()));
+        EXPECT_TRUE(intersect_axes(tmp, b));
+        EXPECT_EQ(&(tmp.labels()), &(a.labels()));
+
+        axis_type d = { "a", "b", "f" };
+        EXPECT_FALSE(intersect_axes(tmp, d));
+        EXPECT_NE(tmp.fingerprint(), a.fingerprint());
+        EXPECT_EQ(tmp.fingerprint(), axis_type({ "a", "b" }).fingerprint());
+    }
 }
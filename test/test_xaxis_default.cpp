@@ -183,4 +183,24 @@ namespace xf
         EXPECT_EQ(res[26], 0u);
         EXPECT_EQ(res[35], 9u);
     }
+
+    TEST(xaxis_default, range_bounds)
+    {
+        axis_default_type a(10);
+        auto b1 = a.range_bounds(2, 5);
+        EXPECT_EQ(b1.first, 2u);
+        EXPECT_EQ(b1.second, 6u);
+
+        auto b2 = a.range_bounds(-3, 20);
+        EXPECT_EQ(b2.first, 0u);
+        EXPECT_EQ(b2.second, 10u);
+
+        auto b3 = a.range_bounds(6, 4);
+        EXPECT_EQ(b3.first, b3.second);
+
+        xaxis_default<std::size_t> u(10);
+        auto b4 = u.range_bounds(std::size_t(2), std::size_t(20));
+        EXPECT_EQ(b4.first, 2u);
+        EXPECT_EQ(b4.second, 10u);
+    }
 }
@@ -7,6 +7,8 @@
 * The full license is in the file LICENSE, distributed with this software. *
 ****************************************************************************/
 
+#include <array>
+
 #include "gtest/gtest.h"
 
 #include "xtensor/xarray.hpp"
@@ -78,6 +80,42 @@ namespace xf
         EXPECT_EQ(func2({{"abs", 10}, {"ord", 5}}), 29);
     }
 
+    TEST(xaxis_function, evaluate_axes)
+    {
+        auto axis1 = named_axis(fstring("abs"), axis({0, 2, 5}));
+        auto axis2 = named_axis(fstring("ord"), axis({'a', 'c', 'i'}));
+        auto dim = dimension_type({"abs", "ord"});
+
+        auto func1 = axis1 < 4;
+        auto res1 = func1.evaluate_axes(dim);
+        EXPECT_EQ(res1.size(), 3u);
+        EXPECT_EQ(res1.dimensions()[0], 0u);
+
+        auto func2 = equal(axis2, 'c') || axis1 + 1 > 4;
+        auto res2 = func2.evaluate_axes(dim);
+        EXPECT_EQ(res2.size(), 9u);
+        for (std::size_t i = 0; i < 3; ++i)
+        {
+            for (std::size_t j = 0; j < 3; ++j)
+            {
+                std::array<std::size_t, 2> index = {{i, j}};
+                EXPECT_EQ(res2.element(index.cbegin(), index.cend()), func2({{"abs", i}, {"ord", j}}));
+            }
+        }
+
+        auto dim2 = dimension_type({"ord", "alt", "abs"});
+        auto res3 = func2.evaluate_axes(dim2);
+        std::array<std::size_t, 3> index = {{1, 4, 0}};
+        EXPECT_EQ(res3.element(index.cbegin(), index.cend()), true);
+        index = {{2, 4, 1}};
+        EXPECT_EQ(res3.element(index.cbegin(), index.cend()), false);
+        index = {{2, 4, 2}};
+        EXPECT_EQ(res3.element(index.cbegin(), index.cend()), true);
+
+        auto dim3 = dimension_type({"ord"});
+        EXPECT_ANY_THROW(func1.evaluate_axes(dim3));
+    }
+
     TEST(xaxis_function, mask)
     {
         auto axis1 = named_axis(fstring("abs"), axis({0, 2, 5}));
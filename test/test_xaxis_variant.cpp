@@ -65,4 +65,25 @@ namespace xf
         EXPECT_EQ(2u, a2);
         EXPECT_THROW(a[3], std::out_of_range);
     }
+
+    TEST(xaxis_variant, positions)
+    {
+        auto a = axis_variant_type(axis({ "a", "c", "d", "f" }));
+        std::vector<axis_variant_type::key_type> labels = { fstring("c"), fstring("f"), fstring("a") };
+        std::vector<std::size_t> res(labels.size());
+        a.positions(labels.cbegin(), labels.cend(), res.begin());
+        EXPECT_EQ(res, std::vector<std::size_t>({ 1, 3, 0 }));
+        EXPECT_TRUE(a.contains_all(labels.cbegin(), labels.cend()));
+
+        labels.push_back(fstring("b"));
+        EXPECT_FALSE(a.contains_all(labels.cbegin(), labels.cend()));
+        res.resize(labels.size());
+        EXPECT_THROW(a.positions(labels.cbegin(), labels.cend(), res.begin()), std::out_of_range);
+
+        auto d = axis_variant_type(axis(5));
+        std::vector<int> ilabels = { 4, 2 };
+        res.resize(ilabels.size());
+        d.positions(ilabels.cbegin(), ilabels.cend(), res.begin());
+        EXPECT_EQ(res, std::vector<std::size_t>({ 4, 2 }));
+    }
 }
@@ -0,0 +1,139 @@
+/***************************************************************************
+* Copyright (c) 2017, Johan Mabille, Sylvain Corlay, Wolf Vollprecht and   *
+* Martin Renou                                                             *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include "test_fixture.hpp"
+
+#include "xframe/xbitmask.hpp"
+
+namespace xf
+{
+    using bitmask_data_type = XFRAME_BITMASK_DATA_CONTAINER(double);
+    using bitmask_variable_type = xvariable_container<coordinate_type, bitmask_data_type>;
+
+    inline bitmask_variable_type make_test_bitmask_variable()
+    {
+        data_type d = make_test_data();
+        xbitmask_array flags = d.has_value();
+        bitmask_data_type bd(d.value(), std::move(flags));
+        return bitmask_variable_type(std::move(bd), make_test_coordinate(), dimension_type({"abscissa", "ordinate"}));
+    }
+
+    TEST(xbitmask, constructor)
+    {
+        xbitmask m1;
+        EXPECT_TRUE(m1.empty());
+        EXPECT_TRUE(m1.all());
+
+        xbitmask m2(70, true);
+        EXPECT_EQ(m2.size(), 70u);
+        EXPECT_EQ(m2.nb_words(), 2u);
+        EXPECT_TRUE(m2.all());
+        EXPECT_EQ(m2.count(), 70u);
+
+        xbitmask m3 = { true, false, true };
+        EXPECT_TRUE(m3[0]);
+        EXPECT_FALSE(m3[1]);
+        EXPECT_TRUE(m3[2]);
+        EXPECT_FALSE(m3.all());
+    }
+
+    TEST(xbitmask, access)
+    {
+        xbitmask m(100, true);
+        m[65] = false;
+        EXPECT_FALSE(m[65]);
+        EXPECT_FALSE(m.all());
+        EXPECT_EQ(m.count(), 99u);
+
+        m[65] = true;
+        EXPECT_TRUE(m.all());
+
+        auto it = m.begin() + 3;
+        *it = false;
+        EXPECT_FALSE(m[3]);
+        EXPECT_EQ(m.end() - m.begin(), 100);
+        EXPECT_EQ(std::count(m.cbegin(), m.cend(), false), 1);
+    }
+
+    TEST(xbitmask, resize)
+    {
+        xbitmask m(10, true);
+        m.resize(80, true);
+        EXPECT_TRUE(m.all());
+        m.resize(90);
+        EXPECT_FALSE(m.all());
+        EXPECT_EQ(m.count(), 80u);
+        m.resize(5);
+        EXPECT_TRUE(m.all());
+    }
+
+    TEST(xbitmask, word_operations)
+    {
+        xbitmask m1(130, true);
+        xbitmask m2(130, true);
+        m1[3] = false;
+        m2[129] = false;
+
+        xbitmask a = m1 & m2;
+        EXPECT_EQ(a.count(), 128u);
+        EXPECT_FALSE(a[3]);
+        EXPECT_FALSE(a[129]);
+
+        xbitmask o = m1 | m2;
+        EXPECT_TRUE(o.all());
+
+        std::vector<const xbitmask*> masks = { &m1, &m2 };
+        xbitmask c(130);
+        c.assign_conjunction(masks.cbegin(), masks.cend());
+        EXPECT_EQ(c, a);
+
+        xbitmask m3(10);
+        EXPECT_ANY_THROW(m1 &= m3);
+    }
+
+    TEST(xbitmask, variable)
+    {
+        bitmask_variable_type a = make_test_bitmask_variable();
+        variable_type b = make_test_variable();
+        EXPECT_EQ(a.locate("a", 1), b.locate("a", 1));
+        EXPECT_EQ(a.locate("a", 4), b.locate("a", 4));
+        EXPECT_EQ(a.locate("c", 1), b.locate("c", 1));
+        EXPECT_FALSE(a.locate("a", 4).has_value());
+
+        bitmask_variable_type res = a + a;
+        EXPECT_EQ(res.locate("a", 1), 2.);
+        EXPECT_FALSE(res.locate("a", 4).has_value());
+        EXPECT_FALSE(res.locate("c", 1).has_value());
+        EXPECT_EQ(res.data().has_value().data().count(), 7u);
+
+        bitmask_variable_type res2 = a * 2.;
+        EXPECT_EQ(res2.locate("d", 4), 18.);
+        EXPECT_FALSE(res2.locate("a", 4).has_value());
+    }
+
+    TEST(xbitmask, conjunction)
+    {
+        bitmask_variable_type a = make_test_bitmask_variable();
+        const auto& a_flags = a.data().has_value();
+
+        xbitmask_array flags(a_flags.shape());
+        EXPECT_TRUE(detail::assign_bitmask_conjunction(flags, a + a));
+        EXPECT_EQ(flags.data(), a_flags.data());
+
+        // Same number of flags, but laid out differently
+        xbitmask_array flat_flags(xbitmask_array::shape_type({ a_flags.size() }), true);
+        EXPECT_FALSE(detail::assign_bitmask_conjunction(flat_flags, a + a));
+        EXPECT_TRUE(flat_flags.data().all());
+
+        xt::xarray<bool> bool_flags(a_flags.shape(), true);
+        EXPECT_FALSE(detail::assign_bitmask_conjunction(bool_flags, a + a));
+    }
+}
@@ -0,0 +1,168 @@
+/***************************************************************************
+* Copyright (c) 2017, Johan Mabille, Sylvain Corlay, Wolf Vollprecht and   *
+* Martin Renou                                                             *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include "test_fixture.hpp"
+
+#include "xframe/xchunked_store.hpp"
+
+#ifndef XFRAME_TEST_DATA_DIR
+#define XFRAME_TEST_DATA_DIR "."
+#endif
+
+namespace xf
+{
+    // Removes the variables stored by a test, even if it fails
+    class chunked_store_cleaner
+    {
+    public:
+
+        chunked_store_cleaner(const xchunked_store& store, std::vector<std::string> names)
+            : m_store(store), m_names(std::move(names))
+        {
+        }
+
+        ~chunked_store_cleaner()
+        {
+            for (const auto& name : m_names)
+            {
+                m_store.remove(name);
+            }
+        }
+
+    private:
+
+        const xchunked_store& m_store;
+        std::vector<std::string> m_names;
+    };
+
+    TEST(xchunked_store, codec)
+    {
+        std::vector<double> values = { 1., 1., 1., 2., 3., 4., 4., 4., 4., 4., -1.5, 0. };
+        auto buffer = xchunk_codec::encode(values.data(), values.size());
+        std::vector<double> decoded(values.size());
+        xchunk_codec::decode(buffer, decoded.data(), decoded.size());
+        EXPECT_EQ(values, decoded);
+
+        std::vector<std::uint8_t> flags(1000, std::uint8_t(1));
+        flags[500] = std::uint8_t(0);
+        auto flag_buffer = xchunk_codec::encode(flags.data(), flags.size());
+        EXPECT_LT(flag_buffer.size(), flags.size() / 10);
+        std::vector<std::uint8_t> decoded_flags(flags.size());
+        xchunk_codec::decode(flag_buffer, decoded_flags.data(), decoded_flags.size());
+        EXPECT_EQ(flags, decoded_flags);
+
+        flag_buffer.pop_back();
+        EXPECT_ANY_THROW(xchunk_codec::decode(flag_buffer, decoded_flags.data(), decoded_flags.size()));
+    }
+
+    TEST(xchunked_store, load)
+    {
+        variable_type var = make_test_variable();
+        auto store = chunked_store(XFRAME_TEST_DATA_DIR, 2);
+        chunked_store_cleaner cleaner(store, { "test_chunked_load" });
+        store.dump("test_chunked_load", var, { 2, 2 });
+
+        auto chunked = store.open<double>("test_chunked_load");
+        EXPECT_EQ(chunked.nb_chunks(), 4u);
+        EXPECT_EQ(chunked.coordinates(), var.coordinates());
+        EXPECT_EQ(chunked.dimension_mapping(), var.dimension_mapping());
+
+        variable_type res = chunked.load();
+        EXPECT_EQ(res, var);
+    }
+
+    TEST(xchunked_store, select)
+    {
+        variable_type var = make_test_variable();
+        auto store = chunked_store(XFRAME_TEST_DATA_DIR);
+        chunked_store_cleaner cleaner(store, { "test_chunked_select" });
+        store.dump("test_chunked_select", var, { 2, 1 });
+        auto chunked = store.open<double>("test_chunked_select");
+
+        variable_type res = chunked.select({{ "abscissa", range("c", "d") }, { "ordinate", range(2, 4) }});
+        EXPECT_EQ(res.coordinates()["abscissa"].size(), 2u);
+        EXPECT_EQ(res.coordinates()["ordinate"].size(), 2u);
+        EXPECT_EQ(res.locate("c", 2), var.locate("c", 2));
+        EXPECT_EQ(res.locate("c", 4), var.locate("c", 4));
+        EXPECT_EQ(res.locate("d", 2), var.locate("d", 2));
+        EXPECT_EQ(res.locate("d", 4), var.locate("d", 4));
+
+        variable_type res2 = chunked.locate("c", all());
+        EXPECT_EQ(res2.dimension_mapping().size(), 1u);
+        EXPECT_EQ(res2.locate(1), var.locate("c", 1));
+        EXPECT_EQ(res2.locate(2), var.locate("c", 2));
+        EXPECT_EQ(res2.locate(4), var.locate("c", 4));
+    }
+
+    TEST(xchunked_store, select_keep)
+    {
+        variable_type var = make_test_variable();
+        auto store = chunked_store(XFRAME_TEST_DATA_DIR);
+        chunked_store_cleaner cleaner(store, { "test_chunked_select_keep" });
+        store.dump("test_chunked_select_keep", var, { 2, 2 });
+        auto chunked = store.open<double>("test_chunked_select_keep");
+
+        variable_type res = chunked.select({{ "abscissa", keep("d", "a") }});
+        const auto& abscissa = res.coordinates()["abscissa"];
+        EXPECT_EQ(abscissa.size(), 2u);
+        EXPECT_EQ(res.shape()[0], 2u);
+        EXPECT_EQ(res.iselect({{ "abscissa", 0 }, { "ordinate", 0 }}), var.locate("a", 1));
+        EXPECT_EQ(res.iselect({{ "abscissa", 1 }, { "ordinate", 2 }}), var.locate("d", 4));
+        EXPECT_EQ(res.locate("a", 1), var.locate("a", 1));
+        EXPECT_EQ(res.locate("a", 2), var.locate("a", 2));
+        EXPECT_EQ(res.locate("d", 1), var.locate("d", 1));
+        EXPECT_EQ(res.locate("d", 4), var.locate("d", 4));
+
+        variable_type res2 = chunked.select({{ "abscissa", keep("c", "c") }, { "ordinate", keep(4, 1, 4) }});
+        EXPECT_EQ(res2.coordinates()["abscissa"].size(), 1u);
+        EXPECT_EQ(res2.coordinates()["ordinate"].size(), 2u);
+        EXPECT_EQ(res2.shape()[0], 1u);
+        EXPECT_EQ(res2.shape()[1], 2u);
+        EXPECT_EQ(res2.iselect({{ "abscissa", 0 }, { "ordinate", 1 }}), var.locate("c", 4));
+        EXPECT_EQ(res2.locate("c", 1), var.locate("c", 1));
+        EXPECT_EQ(res2.locate("c", 4), var.locate("c", 4));
+    }
+
+    TEST(xchunked_store, errors)
+    {
+        variable_type var = make_test_variable();
+        auto store = chunked_store(XFRAME_TEST_DATA_DIR);
+        chunked_store_cleaner cleaner(store, { "test_chunked_errors" });
+        EXPECT_ANY_THROW(store.dump("test_chunked_errors", var, { 2 }));
+        EXPECT_ANY_THROW(store.dump("test_chunked_errors", var, { 0, 2 }));
+        EXPECT_ANY_THROW(store.open<double>("test_chunked_missing"));
+
+        store.dump("test_chunked_errors", var, { 3, 3 });
+        EXPECT_ANY_THROW(store.open<int>("test_chunked_errors"));
+        EXPECT_ANY_THROW(store.open<std::int64_t>("test_chunked_errors"));
+        EXPECT_ANY_THROW(store.open<double>("test_chunked_errors").locate("a", 1, 2));
+    }
+
+    TEST(xchunked_store, overwrite)
+    {
+        variable_type var = make_test_variable();
+        auto store = chunked_store(XFRAME_TEST_DATA_DIR);
+        chunked_store_cleaner cleaner(store, { "test_chunked_overwrite" });
+        store.dump("test_chunked_overwrite", var, { 1, 1 });
+        store.dump("test_chunked_overwrite", var, { 2, 2 });
+        std::string prefix = std::string(XFRAME_TEST_DATA_DIR) + "/test_chunked_overwrite";
+        EXPECT_FALSE(std::ifstream(prefix + ".c.2.2").good());
+        EXPECT_TRUE(std::ifstream(prefix + ".c.1.1").good());
+
+        variable_type res = store.open<double>("test_chunked_overwrite").load();
+        EXPECT_EQ(res, var);
+
+        store.remove("test_chunked_overwrite");
+        EXPECT_FALSE(std::ifstream(prefix + ".meta").good());
+        EXPECT_FALSE(std::ifstream(prefix + ".c.0.0").good());
+        EXPECT_ANY_THROW(store.open<double>("test_chunked_overwrite"));
+    }
+}
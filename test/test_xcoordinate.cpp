@@ -168,4 +168,23 @@ namespace xf
         broadcast_coordinates<join::inner>(cres2, c2, c1);
         EXPECT_EQ(cres2, coord_res);
     }
+
+    TEST(xcoordinate, stamp)
+    {
+        auto c1 = make_test_coordinate();
+        auto c2 = c1;
+        EXPECT_EQ(c1.stamp(), c2.stamp());
+
+        auto c3 = make_test_coordinate();
+        EXPECT_NE(c1.stamp(), c3.stamp());
+
+        auto c4 = std::move(c2);
+        EXPECT_EQ(c4.stamp(), c1.stamp());
+        EXPECT_NE(c2.stamp(), c1.stamp());
+
+        broadcast_coordinates<join::outer>(c4, make_test_coordinate3());
+        EXPECT_NE(c4.stamp(), c1.stamp());
+        c4.clear();
+        EXPECT_NE(c4.stamp(), c1.stamp());
+    }
 }
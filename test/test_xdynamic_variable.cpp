@@ -353,6 +353,35 @@ namespace xf
         EXPECT_EQ(tle00, v(0, 0));
     }
 
+    TEST(xdynamic_variable, get_if)
+    {
+        auto v = make_test_variable();
+        auto dv = make_dynamic(v);
+        const auto& cdv = dv;
+
+        variable_type* pv = dv.get_if<variable_type>();
+        ASSERT_NE(pv, nullptr);
+        EXPECT_EQ(*pv, v);
+        EXPECT_EQ(cdv.get_if<variable_type>(), pv);
+        EXPECT_EQ(dv.get_if<int_variable_type>(), nullptr);
+
+        pv->locate("a", 1) = 10.;
+        EXPECT_EQ(const_opt_cast(cdv.locate("a", 1)), 10.);
+    }
+
+    TEST(xdynamic_variable, visit)
+    {
+        auto v = make_test_variable();
+        auto dv = make_dynamic(v);
+        auto size = [](const auto& var) { return var.data().size(); };
+        EXPECT_EQ((dv.visit<int_variable_type, variable_type>(size)), v.size());
+
+        auto iv = make_test_int_variable();
+        const auto idv = make_dynamic(iv);
+        EXPECT_EQ((idv.visit<variable_type, int_variable_type>(size)), iv.size());
+        EXPECT_ANY_THROW(idv.visit<variable_type>(size));
+    }
+
     TEST(xdynamic_variable, print)
     {
         auto v = make_test_variable();
@@ -250,4 +250,92 @@ namespace xf
         EXPECT_ANY_THROW(res1.select({{"new_dim", 2}, {"new_dim2", 0}, {"abscissa", "d"}, {"ordinate", 4}}));
         EXPECT_EQ(res1.select<join::outer>({{"new_dim", 2}, {"new_dim2", 0}, {"abscissa", "d"}, {"ordinate", 4}}), missing);
     }
+
+    TEST(xexpand_dims, broadcast)
+    {
+        auto var = make_test_variable();
+
+        auto res = expand_dims(var, {{"scenario", axis(4)}});
+        std::vector<std::size_t> expected_shape = {4, 3, 3};
+        EXPECT_EQ(res.shape(), expected_shape);
+        EXPECT_EQ(res.size(), std::size_t(36));
+        EXPECT_EQ(res.coordinates()["scenario"].size(), std::size_t(4));
+        EXPECT_TRUE(res.data().strides()[0] == 0);
+
+        for (int i = 0; i < 4; ++i)
+        {
+            EXPECT_EQ(res.locate(i, "d", 1), 7.0);
+            EXPECT_EQ(res.locate(i, "d", 4), 9.0);
+        }
+
+        var.locate("d", 1) = 10.;
+        EXPECT_EQ(res.locate(3, "d", 1), 10.);
+    }
+
+    TEST(xexpand_dims, broadcast_function)
+    {
+        auto var = make_test_variable();
+        auto missing = xtl::missing<double>();
+        auto res = expand_dims(var, {{"scenario", axis(4)}});
+
+        variable_type doubled = res + res;
+        EXPECT_EQ(doubled.coordinates(), res.coordinates());
+        for (int i = 0; i < 4; ++i)
+        {
+            EXPECT_EQ(doubled.locate(i, "d", 1), 14.0);
+            EXPECT_EQ(doubled.locate(i, "a", 4), missing);
+        }
+
+        data_type scenario_data = {0., 1., 2., 3.};
+        variable_type scenario(scenario_data, coordinate<fstring>({{fstring("scenario"), axis(4)}}), dimension_type({"scenario"}));
+        variable_type shifted = res + scenario;
+        for (int i = 0; i < 4; ++i)
+        {
+            EXPECT_EQ(shifted.select({{"scenario", i}, {"abscissa", "d"}, {"ordinate", 1}}), 7.0 + i);
+        }
+    }
+
+    TEST(xexpand_dims, assign_broadcast)
+    {
+        auto var = make_test_variable();
+        const auto& abscissa = var.coordinates()["abscissa"];
+        const auto& ordinate = var.coordinates()["ordinate"];
+
+        variable_type res = expand_dims(var, {{"scenario", axis(4)}});
+        std::vector<std::size_t> expected_shape = {4, 3, 3};
+        EXPECT_EQ(res.shape(), expected_shape);
+        for (int i = 0; i < 4; ++i)
+        {
+            for (std::size_t j = 0; j < abscissa.size(); ++j)
+            {
+                for (std::size_t k = 0; k < ordinate.size(); ++k)
+                {
+                    EXPECT_EQ(res.locate(i, abscissa.label(j), ordinate.label(k)),
+                              var.locate(abscissa.label(j), ordinate.label(k)));
+                }
+            }
+        }
+
+        variable_type res2 = expand_dims(var, {{"new_dim", 1}});
+        EXPECT_EQ(res2.locate("d", 0, 1), var.locate("d", 1));
+        EXPECT_EQ(res2.locate("a", 0, 4), var.locate("a", 4));
+    }
+
+    TEST(xexpand_dims, function)
+    {
+        auto var = make_test_variable();
+        auto missing = xtl::missing<double>();
+
+        auto res = expand_dims(var + var, {"new_dim"});
+        std::vector<std::size_t> expected_shape = {1, 3, 3};
+        EXPECT_EQ(res.shape(), expected_shape);
+        EXPECT_EQ(res.locate(0, "d", 1), 14.0);
+        EXPECT_EQ(res.locate(0, "a", 4), missing);
+
+        variable_type evaluated = res;
+        EXPECT_EQ(evaluated.locate(0, "d", 1), 14.0);
+        EXPECT_EQ(evaluated.locate(0, "a", 4), missing);
+
+        EXPECT_ANY_THROW(expand_dims(var + var, {{"scenario", axis(4)}}));
+    }
 }
@@ -0,0 +1,174 @@
+/***************************************************************************
+* Copyright (c) 2017, Johan Mabille, Sylvain Corlay and Wolf Vollprecht    *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <numeric>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "xtensor/xbuilder.hpp"
+
+#include "test_fixture.hpp"
+
+#include "xframe/xbitmask.hpp"
+#include "xframe/xexpression_plan.hpp"
+
+namespace xf
+{
+    TEST(xexpression_plan, same_labels)
+    {
+        DEFINE_TEST_VARIABLES();
+        auto plan = prepare(a + a * 2.);
+        EXPECT_TRUE(plan.trivial_broadcast().m_same_labels);
+        EXPECT_EQ(plan.coordinates(), a.coordinates());
+
+        variable_type res;
+        plan.execute(res);
+        variable_type expected = a + a * 2.;
+        EXPECT_EQ(res, expected);
+
+        a.locate("d", 2) = 10.;
+        plan.execute(res);
+        EXPECT_EQ(res.locate("d", 2), 30.);
+        expected = a + a * 2.;
+        EXPECT_EQ(res, expected);
+    }
+
+    TEST(xexpression_plan, different_labels)
+    {
+        DEFINE_TEST_VARIABLES();
+        auto plan = prepare((a + b) * a);
+        EXPECT_FALSE(plan.trivial_broadcast().m_same_labels);
+        EXPECT_EQ(plan.coordinates(), make_intersect_coordinate());
+        EXPECT_EQ(plan.dimension_mapping(), b.dimension_mapping());
+
+        variable_type res;
+        plan.execute(res);
+        variable_type expected = (a + b) * a;
+        EXPECT_EQ(res, expected);
+
+        a.locate("d", 1) = 3.;
+        plan.execute(res, 2);
+        expected = (a + b) * a;
+        EXPECT_EQ(res, expected);
+
+        variable_type res2 = plan.evaluate();
+        EXPECT_EQ(res2, res);
+    }
+
+    TEST(xexpression_plan, outer_join)
+    {
+        DEFINE_TEST_VARIABLES();
+        auto plan = prepare<join::outer>(a + b);
+        EXPECT_EQ(plan.coordinates(), make_merge_coordinate());
+
+        variable_type res;
+        plan.execute(res);
+        EXPECT_EQ(res.coordinates(), make_merge_coordinate());
+        EXPECT_EQ(res.select({{"abscissa", "a"}, {"ordinate", 1}, {"altitude", 2}}),
+                  a.locate("a", 1) + b.select({{"abscissa", "a"}, {"ordinate", 1}, {"altitude", 2}}));
+        EXPECT_FALSE(res.select({{"abscissa", "c"}, {"ordinate", 2}, {"altitude", 1}}).has_value());
+        EXPECT_FALSE(res.select({{"abscissa", "e"}, {"ordinate", 2}, {"altitude", 1}}).has_value());
+    }
+
+    TEST(xexpression_plan, parallel)
+    {
+        const std::size_t n = 100;
+        std::vector<int> labels1(n);
+        std::vector<int> labels2(n);
+        std::iota(labels1.begin(), labels1.end(), 0);
+        std::iota(labels2.begin(), labels2.end(), 1);
+        auto coords1 = coordinate<fstring>({{fstring("abscissa"), iaxis_type(labels1)},
+                                            {fstring("ordinate"), iaxis_type(labels1)}});
+        auto coords2 = coordinate<fstring>({{fstring("abscissa"), iaxis_type(labels2)},
+                                            {fstring("ordinate"), iaxis_type(labels2)}});
+        xt::xarray<double> values = xt::arange<double>(double(n * n));
+        values.reshape({n, n});
+        data_type data1(values);
+        data_type data2(xt::xarray<double>(values * 2.));
+        variable_type v1(data1, coords1, dimension_type({"abscissa", "ordinate"}));
+        variable_type v2(data2, coords2, dimension_type({"abscissa", "ordinate"}));
+        v1.locate(50, 50).has_value() = false;
+        v2.locate(99, 1).has_value() = false;
+
+        auto plan = prepare(v1 * v2 + v1);
+        EXPECT_FALSE(plan.trivial_broadcast().m_same_labels);
+
+        variable_type serial = plan.evaluate();
+        EXPECT_GT(serial.size(), 4096u);
+        variable_type threaded = plan.evaluate(4);
+        EXPECT_EQ(threaded, serial);
+        variable_type expected = v1 * v2 + v1;
+        EXPECT_EQ(threaded, expected);
+        EXPECT_FALSE(threaded.locate(50, 50).has_value());
+        EXPECT_FALSE(threaded.locate(99, 1).has_value());
+        EXPECT_EQ(threaded.locate(1, 2), v1.locate(1, 2) * v2.locate(1, 2) + v1.locate(1, 2));
+    }
+
+    TEST(xexpression_plan, parallel_bitmask)
+    {
+        using bitmask_data_type = XFRAME_BITMASK_DATA_CONTAINER(double);
+        using bitmask_variable_type = xvariable_container<coordinate_type, bitmask_data_type>;
+
+        const std::size_t n = 100;
+        std::vector<int> labels1(n);
+        std::vector<int> labels2(n);
+        std::iota(labels1.begin(), labels1.end(), 0);
+        std::iota(labels2.begin(), labels2.end(), 1);
+        auto coords1 = coordinate<fstring>({{fstring("abscissa"), iaxis_type(labels1)},
+                                            {fstring("ordinate"), iaxis_type(labels1)}});
+        auto coords2 = coordinate<fstring>({{fstring("abscissa"), iaxis_type(labels2)},
+                                            {fstring("ordinate"), iaxis_type(labels2)}});
+        xt::xarray<double> values = xt::arange<double>(double(n * n));
+        values.reshape({n, n});
+        data_type optional1(values);
+        data_type optional2(xt::xarray<double>(values * 2.));
+        xbitmask_array flags1 = optional1.has_value();
+        xbitmask_array flags2 = optional2.has_value();
+        bitmask_data_type data1(optional1.value(), std::move(flags1));
+        bitmask_data_type data2(optional2.value(), std::move(flags2));
+        bitmask_variable_type v1(data1, coords1, dimension_type({"abscissa", "ordinate"}));
+        bitmask_variable_type v2(data2, coords2, dimension_type({"abscissa", "ordinate"}));
+        v1.locate(50, 50).has_value() = false;
+        v2.locate(99, 1).has_value() = false;
+
+        auto plan = prepare(v1 * v2 + v1);
+        EXPECT_FALSE(plan.trivial_broadcast().m_same_labels);
+
+        bitmask_variable_type serial;
+        plan.execute(serial);
+        EXPECT_GT(serial.size(), 4096u);
+        bitmask_variable_type threaded;
+        plan.execute(threaded, 4);
+        EXPECT_EQ(threaded, serial);
+        EXPECT_FALSE(threaded.locate(50, 50).has_value());
+        EXPECT_FALSE(threaded.locate(99, 1).has_value());
+        EXPECT_FALSE(threaded.data().has_value().data().all());
+        EXPECT_EQ(threaded.locate(1, 2), v1.locate(1, 2) * v2.locate(1, 2) + v1.locate(1, 2));
+
+        v1.locate(50, 50).has_value() = true;
+        v2.locate(99, 1).has_value() = true;
+        plan.execute(threaded, 4);
+        EXPECT_TRUE(threaded.locate(50, 50).has_value());
+        EXPECT_TRUE(threaded.data().has_value().data().all());
+    }
+
+    TEST(xexpression_plan, modified_coordinates)
+    {
+        DEFINE_TEST_VARIABLES();
+        auto plan = prepare(a + b);
+        variable_type res;
+        plan.execute(res);
+
+        a.locate("d", 2) = 10.;
+        EXPECT_NO_THROW(plan.execute(res));
+
+        b = make_test_variable2();
+        EXPECT_ANY_THROW(plan.execute(res));
+    }
+}
@@ -0,0 +1,93 @@
+/***************************************************************************
+* Copyright (c) 2017, Johan Mabille, Sylvain Corlay, Wolf Vollprecht and   *
+* Martin Renou                                                             *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include "test_fixture.hpp"
+
+#include "xframe/xframe_counters.hpp"
+
+namespace xf
+{
+    TEST(xframe_counters, snapshot_reset)
+    {
+        reset_counters();
+        auto& storage = detail::counter_storage();
+        storage.m_realigned_assignments.fetch_add(2);
+        storage.m_realigned_elements.fetch_add(18);
+        storage.m_index_builds.fetch_add(1);
+
+        xframe_counters res = get_counters();
+        EXPECT_EQ(res.m_trivial_assignments, 0u);
+        EXPECT_EQ(res.m_realigned_assignments, 2u);
+        EXPECT_EQ(res.m_realigned_elements, 18u);
+        EXPECT_EQ(res.m_index_builds, 1u);
+
+        reset_counters();
+        res = get_counters();
+        EXPECT_EQ(res.m_realigned_assignments, 0u);
+        EXPECT_EQ(res.m_realigned_elements, 0u);
+        EXPECT_EQ(res.m_index_builds, 0u);
+    }
+
+#if XFRAME_ENABLE_COUNTERS
+    // The tests below check the instrumented sites; they are built by the
+    // test_xframe_counters target, see test/CMakeLists.txt
+
+    TEST(xframe_counters, axis)
+    {
+        saxis_type a = {"a", "c", "d"};
+        saxis_type b = {"a", "b", "e"};
+        saxis_type res;
+
+        reset_counters();
+        saxis_type c = {"b", "d"};
+        EXPECT_EQ(get_counters().m_index_builds, 1u);
+
+        reset_counters();
+        res.merge(a, b);
+        EXPECT_EQ(get_counters().m_axis_merges, 1u);
+        EXPECT_EQ(get_counters().m_index_builds, 1u);
+
+        reset_counters();
+        saxis_type same = a;
+        same.merge(a);
+        EXPECT_EQ(get_counters().m_axis_merges, 1u);
+        EXPECT_EQ(get_counters().m_index_builds, 0u);
+
+        reset_counters();
+        same.intersect(c);
+        EXPECT_EQ(get_counters().m_axis_intersections, 1u);
+        EXPECT_EQ(get_counters().m_index_builds, 1u);
+    }
+
+    TEST(xframe_counters, assignment)
+    {
+        DEFINE_TEST_VARIABLES();
+
+        reset_counters();
+        variable_type res = a + a;
+        EXPECT_EQ(get_counters().m_trivial_assignments, 1u);
+        EXPECT_EQ(get_counters().m_realigned_assignments, 0u);
+        EXPECT_EQ(get_counters().m_realigned_elements, 0u);
+
+        reset_counters();
+        variable_type res2 = a + b;
+        EXPECT_EQ(get_counters().m_trivial_assignments, 0u);
+        EXPECT_EQ(get_counters().m_realigned_assignments, 1u);
+        EXPECT_EQ(get_counters().m_realigned_elements, res2.size());
+
+        reset_counters();
+        variable_type res3 = c;
+        res3 += d;
+        EXPECT_EQ(get_counters().m_temporaries, 1u);
+        EXPECT_EQ(get_counters().m_in_place_assignments, 0u);
+    }
+#endif
+}
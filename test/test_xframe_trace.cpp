@@ -0,0 +1,107 @@
+/***************************************************************************
+* Copyright (c) 2017, Johan Mabille, Sylvain Corlay, Wolf Vollprecht and   *
+* Martin Renou                                                             *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "xframe/xframe_trace.hpp"
+
+namespace xf
+{
+    TEST(xframe_trace, span)
+    {
+        xtrace_ring_buffer buffer(8);
+        {
+            xtrace_span span("no_sink");
+        }
+        EXPECT_EQ(buffer.nb_recorded(), 0u);
+
+        xtrace_sink* previous = set_trace_sink(&buffer);
+        EXPECT_EQ(get_trace_sink(), &buffer);
+        {
+            xtrace_span span("resize");
+            span.set_size(12);
+            span.set_slow_path(true);
+        }
+        set_trace_sink(previous);
+
+        auto events = buffer.snapshot();
+        ASSERT_EQ(events.size(), 1u);
+        EXPECT_EQ(std::string(events[0].m_name), "resize");
+        EXPECT_EQ(events[0].m_size, 12u);
+        EXPECT_TRUE(events[0].m_slow_path);
+    }
+
+    TEST(xframe_trace, ring_buffer)
+    {
+        xtrace_ring_buffer buffer(5);
+        EXPECT_EQ(buffer.capacity(), 8u);
+
+        for (std::size_t i = 0; i < 10; ++i)
+        {
+            xtrace_event event;
+            event.m_size = i;
+            buffer.record(event);
+        }
+        EXPECT_EQ(buffer.nb_recorded(), 10u);
+        EXPECT_EQ(buffer.nb_dropped(), 2u);
+        auto events = buffer.snapshot();
+        ASSERT_EQ(events.size(), 8u);
+        EXPECT_EQ(events.front().m_size, 2u);
+        EXPECT_EQ(events.back().m_size, 9u);
+    }
+
+    TEST(xframe_trace, ring_buffer_concurrent)
+    {
+        xtrace_ring_buffer buffer(1024);
+        std::vector<std::thread> threads;
+        for (std::size_t t = 0; t < 4; ++t)
+        {
+            threads.emplace_back([&buffer]() {
+                for (std::size_t i = 0; i < 100; ++i)
+                {
+                    buffer.record(xtrace_event());
+                }
+            });
+        }
+        for (auto& t : threads)
+        {
+            t.join();
+        }
+        EXPECT_EQ(buffer.nb_recorded(), 400u);
+        EXPECT_EQ(buffer.snapshot().size(), 400u);
+    }
+
+    TEST(xframe_trace, chrome_writer)
+    {
+        std::ostringstream out;
+        {
+            xtrace_chrome_writer writer(out);
+            xtrace_event event;
+            event.m_name = "assign_realigned";
+            event.m_begin = 1500;
+            event.m_duration = 2042;
+            event.m_size = 9;
+            event.m_slow_path = true;
+            writer.record(event);
+            writer.record(event);
+        }
+        std::string res = out.str();
+        EXPECT_EQ(res.find("{\"traceEvents\":["), 0u);
+        EXPECT_NE(res.find("\"name\":\"assign_realigned\""), std::string::npos);
+        EXPECT_NE(res.find("\"ts\":1.500"), std::string::npos);
+        EXPECT_NE(res.find("\"dur\":2.042"), std::string::npos);
+        EXPECT_NE(res.find("\"args\":{\"size\":9,\"slow_path\":true}},"), std::string::npos);
+        EXPECT_EQ(res.substr(res.size() - 4), "\n]}\n");
+    }
+}
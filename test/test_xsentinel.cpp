@@ -0,0 +1,184 @@
+/***************************************************************************
+* Copyright (c) 2017, Johan Mabille, Sylvain Corlay, Wolf Vollprecht and   *
+* Martin Renou                                                             *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+#include "gtest/gtest.h"
+
+#include "test_fixture.hpp"
+
+#include "xframe/xsentinel.hpp"
+
+namespace xf
+{
+    template <>
+    struct xsentinel_data_traits<std::int16_t>
+    {
+        using type = xsentinel_value<std::int16_t, std::numeric_limits<std::int16_t>::lowest()>;
+    };
+
+    using sentinel_data_type = XFRAME_SENTINEL_DATA_CONTAINER(double);
+    using sentinel_variable_type = xvariable_container<coordinate_type, sentinel_data_type>;
+
+    inline sentinel_variable_type make_test_sentinel_variable()
+    {
+        sentinel_data_type d = {{ 1., 2., 3.},
+                                { 4., 5., 6.},
+                                { 7., 8., 9.}};
+        d(0, 2).has_value() = false;
+        d(1, 0).has_value() = false;
+        return sentinel_variable_type(std::move(d), make_test_coordinate(), dimension_type({"abscissa", "ordinate"}));
+    }
+
+    TEST(xsentinel, traits)
+    {
+        EXPECT_TRUE(std::isnan(xsentinel_traits<double>::value()));
+        EXPECT_TRUE(xsentinel_traits<double>::is_sentinel(xsentinel_traits<double>::value()));
+        EXPECT_FALSE(xsentinel_traits<double>::is_sentinel(0.));
+        EXPECT_TRUE((xsentinel_value<int, -1>::is_sentinel(-1)));
+        EXPECT_FALSE((xsentinel_value<int, -1>::is_sentinel(std::numeric_limits<int>::lowest())));
+
+        bool fallback = std::is_same<xsentinel_data_container<int>,
+                                     xt::xoptional_assembly<xt::xarray<int>, xt::xarray<bool>>>::value;
+        EXPECT_TRUE(fallback);
+
+        using short_traits = xsentinel_value<std::int16_t, std::numeric_limits<std::int16_t>::lowest()>;
+        bool specialized = std::is_same<XFRAME_SENTINEL_DATA_CONTAINER(std::int16_t),
+                                        xsentinel_array<std::int16_t, short_traits>>::value;
+        EXPECT_TRUE(specialized);
+    }
+
+    TEST(xsentinel, vector)
+    {
+        xsentinel_vector<double> v = { 1., xtl::missing<double>(), 3. };
+        EXPECT_EQ(v.size(), 3u);
+        EXPECT_EQ(v[0], 1.);
+        EXPECT_FALSE(v[1].has_value());
+        EXPECT_TRUE(std::isnan(v.values()[1]));
+        EXPECT_FALSE(v.all_valid());
+
+        v[1] = 2.;
+        EXPECT_EQ(v[1], 2.);
+        EXPECT_TRUE(v.all_valid());
+
+        v[2].has_value() = false;
+        EXPECT_FALSE(v[2].has_value());
+
+        v.resize(4, xtl::missing<double>());
+        EXPECT_FALSE(v.back().has_value());
+        EXPECT_EQ(std::count_if(v.cbegin(), v.cend(), [](const auto& o) { return o.has_value(); }), 2);
+
+        v.resize(5);
+        EXPECT_FALSE(v.back().has_value());
+        v.has_value().resize(6);
+        EXPECT_FALSE(v.back().has_value());
+        EXPECT_EQ(v.size(), 6u);
+
+        xsentinel_vector<double> mv(2);
+        EXPECT_FALSE(mv[0].has_value());
+        EXPECT_FALSE(mv[1].has_value());
+
+        xsentinel_vector<int, xsentinel_value<int, -1>> iv(2, 4);
+        iv[0] = xtl::missing<int>();
+        EXPECT_EQ(iv.values()[0], -1);
+        EXPECT_EQ(iv[1], 4);
+    }
+
+    TEST(xsentinel, optional_storage)
+    {
+        xsentinel_vector<double> v = { 1., xtl::missing<double>(), 3. };
+        EXPECT_EQ(&v.value(), &v.values());
+        EXPECT_EQ(v.has_value().size(), 3u);
+        EXPECT_TRUE(v.has_value()[0]);
+        EXPECT_FALSE(v.has_value()[1]);
+        EXPECT_EQ(std::count(v.has_value().cbegin(), v.has_value().cend(), true), 2);
+
+        v.has_value()[2] = false;
+        EXPECT_FALSE(v[2].has_value());
+        EXPECT_TRUE(std::isnan(v.value()[2]));
+
+        xsentinel_vector<double> w = v;
+        w.value()[1] = 2.;
+        EXPECT_TRUE(w.has_value()[1]);
+        EXPECT_FALSE(v.has_value()[1]);
+
+        xsentinel_vector<double> u = std::move(w);
+        EXPECT_EQ(u.has_value().size(), 3u);
+        EXPECT_TRUE(u.has_value()[1]);
+    }
+
+    TEST(xsentinel, variable)
+    {
+        sentinel_variable_type a = make_test_sentinel_variable();
+        variable_type b = make_test_variable();
+        EXPECT_EQ(a.locate("a", 1), b.locate("a", 1));
+        EXPECT_EQ(a.locate("d", 4), b.locate("d", 4));
+        EXPECT_FALSE(a.locate("a", 4).has_value());
+        EXPECT_FALSE(a.locate("c", 1).has_value());
+        EXPECT_FALSE(a.all_valid());
+
+        sentinel_variable_type res = a + a;
+        EXPECT_EQ(res.locate("a", 1), 2.);
+        EXPECT_FALSE(res.locate("a", 4).has_value());
+        EXPECT_FALSE(res.locate("c", 1).has_value());
+        EXPECT_TRUE(std::isnan(res.data().data().values()[2]));
+
+        a.locate("a", 4) = 3.;
+        a.locate("c", 1) = 4.;
+        EXPECT_TRUE(a.all_valid());
+        sentinel_variable_type res2 = a * 2.;
+        EXPECT_EQ(res2.locate("a", 4), 6.);
+        EXPECT_TRUE(res2.all_valid());
+    }
+
+    TEST(xsentinel, binary_operation)
+    {
+        sentinel_variable_type a = make_test_sentinel_variable();
+        sentinel_variable_type b = make_test_sentinel_variable();
+        b.locate("d", 2).has_value() = false;
+        b.locate("a", 4) = 10.;
+        EXPECT_EQ(a.data().value()(1, 1), 5.);
+        EXPECT_FALSE(b.data().has_value()(2, 1));
+
+        sentinel_variable_type res = a + b;
+        EXPECT_EQ(res.locate("a", 1), 2.);
+        EXPECT_EQ(res.locate("c", 2), 10.);
+        EXPECT_FALSE(res.locate("a", 4).has_value());
+        EXPECT_FALSE(res.locate("c", 1).has_value());
+        EXPECT_FALSE(res.locate("d", 2).has_value());
+        EXPECT_TRUE(std::isnan(res.data().data().values()[7]));
+
+        variable_type expected = make_test_variable() + make_test_variable();
+        expected.locate("d", 2).has_value() = false;
+        EXPECT_EQ(res.locate("d", 4), expected.locate("d", 4));
+        EXPECT_EQ(res.data().has_value()(2, 1), expected.data().has_value()(2, 1));
+    }
+
+    TEST(xsentinel, integral_sentinel)
+    {
+        using int_data_type = xsentinel_array<int, xsentinel_value<int, -1>>;
+        using int_variable_type = xvariable_container<coordinate_type, int_data_type>;
+        int_data_type d = {{ std::numeric_limits<int>::lowest(), 2, 3},
+                           { 4, 5, 6},
+                           { 7, 8, 9}};
+        d(1, 0).has_value() = false;
+        int_variable_type a(std::move(d), make_test_coordinate(), dimension_type({"abscissa", "ordinate"}));
+        EXPECT_TRUE(a.locate("a", 1).has_value());
+        EXPECT_FALSE(a.locate("c", 1).has_value());
+
+        int_variable_type res = a + 1;
+        EXPECT_EQ(res.locate("c", 2), 6);
+        EXPECT_EQ(res.locate("a", 1), std::numeric_limits<int>::lowest() + 1);
+        EXPECT_FALSE(res.locate("c", 1).has_value());
+        EXPECT_EQ(res.data().data().values()[3], -1);
+    }
+}
@@ -0,0 +1,140 @@
+/***************************************************************************
+* Copyright (c) 2017, Johan Mabille, Sylvain Corlay, Wolf Vollprecht and   *
+* Martin Renou                                                             *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include "test_fixture.hpp"
+
+#include "xframe/xstatic_variable.hpp"
+
+namespace xf
+{
+    namespace st
+    {
+        XFRAME_STATIC_DIMENSION(abscissa)
+        XFRAME_STATIC_DIMENSION(ordinate)
+        XFRAME_STATIC_DIMENSION(altitude)
+    }
+
+    using static_dimension_type = xstatic_dimension<st::abscissa, st::ordinate>;
+    using static_variable_type = xstatic_variable<double, static_dimension_type>;
+    using static_axis_type = static_variable_type::axis_type;
+
+    inline static_variable_type make_test_static_variable()
+    {
+        static_variable_type::data_type d = {{ 1., 2., 3.},
+                                             { 4., 5., 6.},
+                                             { 7., 8., 9.}};
+        d(0, 2).has_value() = false;
+        d(1, 0).has_value() = false;
+        static_variable_type::axis_list axes = {{ static_axis_type(make_test_saxis()),
+                                                  static_axis_type(make_test_iaxis()) }};
+        return static_variable_type(std::move(axes), std::move(d));
+    }
+
+    TEST(xstatic_variable, dimension)
+    {
+        EXPECT_EQ(static_dimension_type::size(), 2u);
+        EXPECT_EQ(static_dimension_type::index_of<st::ordinate>(), 1u);
+        EXPECT_TRUE(static_dimension_type::contains<st::abscissa>());
+        EXPECT_FALSE(static_dimension_type::contains<st::altitude>());
+
+        using union_type = static_union_t<static_dimension_type, xstatic_dimension<st::altitude, st::abscissa>>;
+        bool res = std::is_same<union_type, xstatic_dimension<st::abscissa, st::ordinate, st::altitude>>::value;
+        EXPECT_TRUE(res);
+    }
+
+    TEST(xstatic_variable, constructor)
+    {
+        static_variable_type v = make_test_static_variable();
+        EXPECT_EQ(v.size(), 9u);
+        EXPECT_EQ(v.shape()[0], 3u);
+        EXPECT_EQ(v.axis<st::ordinate>().size(), 3u);
+
+        static_variable_type::data_type d = {{ 1., 2.}};
+        EXPECT_ANY_THROW(static_variable_type(v.axes(), d));
+    }
+
+    TEST(xstatic_variable, access)
+    {
+        static_variable_type v = make_test_static_variable();
+        EXPECT_EQ(v.locate("c", 2), 5.);
+        EXPECT_FALSE(v.locate("a", 4).has_value());
+        EXPECT_EQ((v.select<st::ordinate, st::abscissa>(4, "d")), 9.);
+        EXPECT_EQ((v.iselect<st::ordinate, st::abscissa>(1, 0)), 2.);
+
+        v.select<st::abscissa, st::ordinate>("a", 4) = 3.;
+        EXPECT_EQ(v.locate("a", 4), 3.);
+    }
+
+    TEST(xstatic_variable, conversion)
+    {
+        variable_type var = make_test_variable();
+        static_variable_type v(var);
+        EXPECT_EQ(v.locate("c", 2), var.locate("c", 2));
+        EXPECT_FALSE(v.locate("a", 4).has_value());
+
+        using transposed_type = xstatic_variable<double, xstatic_dimension<st::ordinate, st::abscissa>>;
+        transposed_type t(var);
+        EXPECT_EQ(t.locate(2, "c"), var.locate("c", 2));
+        EXPECT_EQ(t.locate(4, "d"), var.locate("d", 4));
+        EXPECT_FALSE(t.locate(1, "c").has_value());
+
+        auto res = v.to_variable();
+        EXPECT_EQ(res, var);
+    }
+
+    TEST(xstatic_variable, binary_operation)
+    {
+        static_variable_type a = make_test_static_variable();
+        static_variable_type res = a + a;
+        EXPECT_EQ(res.locate("c", 2), 10.);
+        EXPECT_FALSE(res.locate("a", 4).has_value());
+
+        static_variable_type res2 = a * 2.;
+        EXPECT_EQ(res2.locate("d", 1), 14.);
+        static_variable_type res3 = 1. - a;
+        EXPECT_EQ(res3.locate("d", 1), -6.);
+    }
+
+    TEST(xstatic_variable, broadcasting)
+    {
+        static_variable_type a = make_test_static_variable();
+        using altitude_type = xstatic_variable<double, xstatic_dimension<st::altitude, st::abscissa>>;
+        altitude_type::data_type d = {{ 1., 2.}, { 3., 4.}};
+        altitude_type::axis_list axes = {{ static_axis_type(iaxis_type({1, 2})),
+                                           static_axis_type(saxis_type({"c", "d"})) }};
+        altitude_type b(std::move(axes), std::move(d));
+
+        auto res = a + b;
+        bool same_dim = std::is_same<decltype(res)::dimension_type,
+                                     xstatic_dimension<st::abscissa, st::ordinate, st::altitude>>::value;
+        EXPECT_TRUE(same_dim);
+        EXPECT_EQ(res.axis<st::abscissa>().size(), 2u);
+        EXPECT_EQ(res.locate("c", 2, 1), 6.);
+        EXPECT_EQ(res.locate("d", 4, 2), 13.);
+        EXPECT_FALSE(res.locate("c", 1, 2).has_value());
+    }
+
+    TEST(xstatic_variable, broadcasting_single_label)
+    {
+        static_variable_type a = make_test_static_variable();
+        using abscissa_type = xstatic_variable<double, xstatic_dimension<st::abscissa>>;
+        abscissa_type::data_type d = { 10. };
+        abscissa_type::axis_list axes = {{ static_axis_type(saxis_type({"c"})) }};
+        abscissa_type b(std::move(axes), std::move(d));
+
+        auto res = static_apply<join::outer>(std::plus<>(), a, b);
+        EXPECT_EQ(res.axis<st::abscissa>().size(), 3u);
+        EXPECT_EQ(res.locate("c", 2), 15.);
+        EXPECT_EQ(res.locate("c", 4), 16.);
+        EXPECT_FALSE(res.locate("a", 1).has_value());
+        EXPECT_FALSE(res.locate("d", 4).has_value());
+    }
+}
@@ -8,6 +8,8 @@
 
 #include <array>
 #include <cstddef>
+#include <iterator>
+#include <vector>
 #include "gtest/gtest.h"
 #include "test_fixture.hpp"
 #include "xframe/xnamed_axis.hpp"
@@ -216,6 +218,24 @@ namespace xf
         EXPECT_EQ(mis, v.missing());
     }
 
+    TEST(xvariable, select_batch)
+    {
+        auto v = make_test_variable();
+        variable_type::batch_selector_type batch({"ordinate", "abscissa"});
+        batch.push_back({1, "a"});
+        batch.push_back({4, "c"});
+        batch.push_back({2, "d"});
+        EXPECT_EQ(batch.size(), 3u);
+        EXPECT_ANY_THROW(batch.push_back({1}));
+
+        std::vector<variable_type::value_type> res;
+        v.select_batch(batch, std::back_inserter(res));
+        ASSERT_EQ(res.size(), 3u);
+        EXPECT_EQ(res[0], v(0, 0));
+        EXPECT_EQ(res[1], v(1, 2));
+        EXPECT_EQ(res[2], v(2, 1));
+    }
+
     TEST(xvariable, iselect)
     {
         auto v = make_test_variable();
@@ -381,4 +401,18 @@ ordinate: (1, 2, 4, )
         std::string res = oss.str();
         EXPECT_EQ(res, expected);
     }
+
+    TEST(xvariable, all_valid)
+    {
+        variable_type var = make_test_variable();
+        const variable_type& cvar = var;
+        EXPECT_FALSE(cvar.all_valid());
+
+        var.locate("a", 4) = 3.;
+        var.locate("c", 1) = 4.;
+        EXPECT_TRUE(cvar.all_valid());
+
+        var.locate("d", 2).has_value() = false;
+        EXPECT_FALSE(cvar.all_valid());
+    }
 }
@@ -8,6 +8,7 @@
 
 #include "gtest/gtest.h"
 #include "test_fixture.hpp"
+#include "xframe/xframe_counters.hpp"
 
 namespace xf
 {
@@ -464,5 +465,58 @@ namespace xf
         EXPECT_EQ(res(1, 0), 6.);
         EXPECT_EQ(res(1, 1), 9.);
     }
-}
 
+    // The counters are only checked when the file is built with
+    // XFRAME_ENABLE_COUNTERS, see test/CMakeLists.txt
+    TEST(xvariable_assign, computed_assign_in_place)
+    {
+        DEFINE_TEST_VARIABLES();
+        {
+            SCOPED_TRACE("destination not referenced");
+            variable_type res = c;
+            reset_counters();
+            xt::computed_assign(res, a + b);
+            selector_list sl = make_selector_list_ab();
+            EXPECT_EQ(res.coordinates(), make_intersect_coordinate());
+            CHECK_EQUALITY(res, a, b, sl, +)
+#if XFRAME_ENABLE_COUNTERS
+            EXPECT_EQ(get_counters().m_in_place_assignments, 1u);
+            EXPECT_EQ(get_counters().m_temporaries, 0u);
+#endif
+        }
+
+        {
+            SCOPED_TRACE("destination keeping its coordinates");
+            variable_type ab = a + b;
+            variable_type res = ab;
+            const double* buffer = res.data().value().data();
+            reset_counters();
+            res += a;
+            selector_list sl = make_selector_list_ab();
+            EXPECT_EQ(res.coordinates(), ab.coordinates());
+            CHECK_EQUALITY(res, ab, a, sl, +)
+            // Evaluated in place: the destination keeps its buffer
+            EXPECT_EQ(res.data().value().data(), buffer);
+#if XFRAME_ENABLE_COUNTERS
+            EXPECT_EQ(get_counters().m_in_place_assignments, 1u);
+            EXPECT_EQ(get_counters().m_temporaries, 0u);
+#endif
+        }
+
+        {
+            SCOPED_TRACE("destination growing");
+            variable_type cd = c + d;
+            variable_type res = c;
+            reset_counters();
+            res += d;
+            selector_list sl = make_selector_list_cd();
+            EXPECT_EQ(res.coordinates(), cd.coordinates());
+            EXPECT_EQ(res.dimension_mapping(), cd.dimension_mapping());
+            CHECK_EQUALITY(res, c, d, sl, +)
+#if XFRAME_ENABLE_COUNTERS
+            EXPECT_EQ(get_counters().m_in_place_assignments, 0u);
+            EXPECT_EQ(get_counters().m_temporaries, 1u);
+#endif
+        }
+    }
+}
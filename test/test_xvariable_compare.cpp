@@ -0,0 +1,133 @@
+/***************************************************************************
+* Copyright (c) 2017, Johan Mabille, Sylvain Corlay and Wolf Vollprecht    *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <numeric>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "xtensor/xbuilder.hpp"
+
+#include "test_fixture.hpp"
+
+#include "xframe/xvariable_compare.hpp"
+
+namespace xf
+{
+    TEST(xvariable_compare, equal)
+    {
+        DEFINE_TEST_VARIABLES();
+        variable_type a2 = a;
+        EXPECT_EQ(a.coordinates().stamp(), a2.coordinates().stamp());
+
+        xcomparison_result res = compare(a, a2);
+        EXPECT_TRUE(res.m_same_coordinates);
+        EXPECT_TRUE(res.equal());
+        EXPECT_EQ(res.m_size, 9u);
+        EXPECT_EQ(res.mismatches(), 0u);
+        EXPECT_TRUE(res.m_first_mismatch == xcomparison_result::npos);
+        EXPECT_TRUE(a == a2);
+    }
+
+    TEST(xvariable_compare, value_mismatch)
+    {
+        DEFINE_TEST_VARIABLES();
+        variable_type a2 = a;
+        a2.locate("c", 2) = 6.;
+        a2.locate("d", 4) = 12.;
+
+        xcomparison_result res = compare(a, a2);
+        EXPECT_TRUE(res.m_same_coordinates);
+        EXPECT_FALSE(res.equal());
+        EXPECT_EQ(res.m_value_mismatches, 2u);
+        EXPECT_EQ(res.m_missing_mismatches, 0u);
+        EXPECT_EQ(res.m_first_mismatch, 4u);
+        EXPECT_EQ(res.m_max_abs_diff, 3.);
+        EXPECT_FALSE(a == a2);
+    }
+
+    TEST(xvariable_compare, missing_mismatch)
+    {
+        DEFINE_TEST_VARIABLES();
+        variable_type a2 = a;
+        a2.locate("a", 4) = 3.;
+        a2.locate("d", 1).has_value() = false;
+
+        xcomparison_result res = compare(a, a2);
+        EXPECT_EQ(res.m_value_mismatches, 0u);
+        EXPECT_EQ(res.m_missing_mismatches, 2u);
+        EXPECT_EQ(res.m_first_mismatch, 2u);
+        EXPECT_EQ(res.m_max_abs_diff, 0.);
+        EXPECT_FALSE(a == a2);
+    }
+
+    TEST(xvariable_compare, different_coordinates)
+    {
+        DEFINE_TEST_VARIABLES();
+        xcomparison_result res = compare(a, c);
+        EXPECT_FALSE(res.m_same_coordinates);
+        EXPECT_FALSE(res.equal());
+        EXPECT_EQ(res.m_size, 0u);
+        EXPECT_FALSE(a == c);
+    }
+
+    TEST(xvariable_compare, function)
+    {
+        DEFINE_TEST_VARIABLES();
+        variable_type expected = a + a;
+        xcomparison_result res = compare(a * 2., expected);
+        EXPECT_TRUE(res.equal());
+        EXPECT_EQ(res.m_size, 9u);
+        EXPECT_TRUE(a + a == expected);
+    }
+
+    TEST(xvariable_compare, allclose)
+    {
+        DEFINE_TEST_VARIABLES();
+        variable_type a2 = a;
+        a2.locate("c", 2) = 5. + 1e-9;
+
+        EXPECT_FALSE(compare(a, a2).equal());
+        EXPECT_TRUE(compare_close(a, a2).equal());
+        EXPECT_TRUE(xf::allclose(a, a2));
+        EXPECT_FALSE(xf::allclose(a, a2, 0., 1e-12));
+
+        a2.locate("d", 1).has_value() = false;
+        xcomparison_result res = compare_close(a, a2);
+        EXPECT_EQ(res.m_value_mismatches, 0u);
+        EXPECT_EQ(res.m_missing_mismatches, 1u);
+        EXPECT_FALSE(xf::allclose(a, a2));
+    }
+
+    TEST(xvariable_compare, parallel)
+    {
+        const std::size_t n = 200000;
+        std::vector<int> labels(n);
+        std::iota(labels.begin(), labels.end(), 0);
+        auto coords = coordinate<fstring>({{fstring("abscissa"), iaxis_type(std::move(labels))}});
+        data_type data(xt::xarray<double>(xt::arange<double>(double(n))));
+        variable_type v1(data, coords, dimension_type({"abscissa"}));
+        variable_type v2 = v1;
+        EXPECT_TRUE(compare(v1, v2, 4).equal());
+
+        v2.locate(150000) = -1.;
+        v2.locate(70000).has_value() = false;
+        v2.locate(199999) = 199999.5;
+        xcomparison_result res = compare(v1, v2, 4);
+        EXPECT_EQ(res.m_size, n);
+        EXPECT_EQ(res.m_value_mismatches, 2u);
+        EXPECT_EQ(res.m_missing_mismatches, 1u);
+        EXPECT_EQ(res.m_first_mismatch, 70000u);
+        EXPECT_EQ(res.m_max_abs_diff, 150001.);
+
+        xcomparison_result serial = compare(v1, v2);
+        EXPECT_EQ(serial.mismatches(), res.mismatches());
+        EXPECT_EQ(serial.m_first_mismatch, res.m_first_mismatch);
+        EXPECT_EQ(serial.m_max_abs_diff, res.m_max_abs_diff);
+    }
+}
@@ -229,5 +229,106 @@ city: (London, Paris, Brussels, )
         std::string res = oss.str();
         EXPECT_EQ(res, expected);
     }
-}
 
+    TEST(xvariable_function, all_valid)
+    {
+        variable_type a = make_test_variable();
+        variable_type b = make_test_variable();
+        a.locate("a", 4) = 3.;
+        a.locate("c", 1) = 4.;
+        b.locate("a", 4) = 3.;
+        b.locate("c", 1) = 4.;
+        const variable_type& ca = a;
+        const variable_type& cb = b;
+        EXPECT_TRUE((ca + cb).all_valid());
+        EXPECT_TRUE((ca + 2.).all_valid());
+
+        variable_type res = ca * cb + 1.;
+        const variable_type& cres = res;
+        EXPECT_TRUE(cres.all_valid());
+        EXPECT_EQ(cres.locate("a", 4), 10.);
+        EXPECT_EQ(cres.locate("d", 2), 65.);
+
+        variable_type c = make_test_variable();
+        const variable_type& cc = c;
+        EXPECT_FALSE((ca + cc).all_valid());
+        variable_type res2 = ca + cc;
+        const variable_type& cres2 = res2;
+        EXPECT_FALSE(cres2.all_valid());
+        EXPECT_FALSE(cres2.locate("a", 4).has_value());
+        EXPECT_EQ(cres2.locate("a", 1), 2.);
+    }
+
+    TEST(xvariable_function, coordinate_cache)
+    {
+        xfunction_features f;
+        using function_type = decltype(f.m_a + f.m_b);
+        using coordinate_type = function_type::coordinate_type;
+        using cache_type = xcoordinate_cache<coordinate_type, 2>;
+        auto& cache = cache_type::instance();
+        cache.clear();
+
+        auto key1 = detail::make_coordinate_cache_key<join::outer>();
+        EXPECT_TRUE(detail::add_coordinate_stamp(key1, f.m_a.coordinates()));
+        EXPECT_TRUE(detail::add_coordinate_stamp(key1, f.m_b.coordinates()));
+        coordinate_type c;
+        xtrivial_broadcast trivial;
+        EXPECT_FALSE(cache.find(key1, c, trivial));
+
+        coordinate_type merged;
+        xtrivial_broadcast merged_trivial = broadcast_coordinates<join::outer>(merged, f.m_a.coordinates(), f.m_b.coordinates());
+        cache.insert(key1, merged, merged_trivial);
+        EXPECT_EQ(cache.size(), 1u);
+        EXPECT_TRUE(cache.find(key1, c, trivial));
+        EXPECT_EQ(c, make_merge_coordinate());
+        EXPECT_EQ(trivial.m_same_labels, merged_trivial.m_same_labels);
+
+        auto key2 = detail::make_coordinate_cache_key<join::inner>();
+        detail::add_coordinate_stamp(key2, f.m_a.coordinates());
+        detail::add_coordinate_stamp(key2, f.m_b.coordinates());
+        EXPECT_FALSE(cache.find(key2, c, trivial));
+        coordinate_type intersected;
+        xtrivial_broadcast intersected_trivial = broadcast_coordinates<join::inner>(intersected, f.m_a.coordinates(), f.m_b.coordinates());
+        cache.insert(key2, intersected, intersected_trivial);
+        EXPECT_TRUE(cache.find(key2, c, trivial));
+        EXPECT_EQ(c, make_intersect_coordinate());
+
+        f.m_b = make_test_variable2();
+        auto key3 = detail::make_coordinate_cache_key<join::outer>();
+        detail::add_coordinate_stamp(key3, f.m_a.coordinates());
+        detail::add_coordinate_stamp(key3, f.m_b.coordinates());
+        EXPECT_NE(key3, key1);
+        cache.insert(key3, merged, merged_trivial);
+        EXPECT_EQ(cache.size(), 2u);
+        EXPECT_FALSE(cache.find(key1, c, trivial));
+        EXPECT_TRUE(cache.find(key3, c, trivial));
+    }
+
+    TEST(xvariable_function, coordinate_cache_disabled)
+    {
+        xfunction_features f;
+        using function_type = decltype(f.m_a + f.m_b);
+        auto& cache = xcoordinate_cache<function_type::coordinate_type>::instance();
+        cache.clear();
+
+        auto c1 = (f.m_a + f.m_b).coordinates<join::outer>();
+        auto c2 = (f.m_a + f.m_b).coordinates<join::outer>();
+        EXPECT_EQ(cache.size(), 0u);
+        EXPECT_EQ(c1, make_merge_coordinate());
+        EXPECT_EQ(c2, c1);
+    }
+
+    TEST(xvariable_function, nested)
+    {
+        xfunction_features f;
+        auto f1 = (f.m_a + f.m_b) * f.m_a - f.m_b;
+        EXPECT_EQ(f1.coordinates(), make_intersect_coordinate());
+        EXPECT_EQ(f1.dimension_mapping(), f.m_b.dimension_mapping());
+        EXPECT_EQ(f1.coordinates<join::outer>(), make_merge_coordinate());
+        EXPECT_EQ(f1.dimension_mapping<join::outer>(), f.m_b.dimension_mapping());
+
+        auto f2 = (f.m_a + f.m_a) * 2.;
+        EXPECT_EQ(f2.coordinates(), f.m_a.coordinates());
+        EXPECT_EQ(f2.dimension_mapping(), f.m_a.dimension_mapping());
+    }
+}
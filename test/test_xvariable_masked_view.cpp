@@ -240,4 +240,32 @@ namespace xf
         ASSERT_NE(masked_var.data(), test_var.data());
         ASSERT_NE(var.data(), test_var.data());
     }
+
+    TEST(xvariable_masked_view, where_drop)
+    {
+        variable_type var = make_test_view_variable();
+
+        auto res = where(var, var.axis<int>("ordinate") < 6, true);
+        EXPECT_EQ(res.shape()[0], 8u);
+        EXPECT_EQ(res.shape()[1], 4u);
+        EXPECT_FALSE(res.coordinates()["ordinate"].contains(6));
+        EXPECT_EQ(res.select({{"abscissa", "g"}, {"ordinate", 5}}), 35.);
+        EXPECT_FALSE(res.select({{"abscissa", "d"}, {"ordinate", 5}}).has_value());
+
+        auto res2 = where(var, equal(var.axis<fstring>("abscissa"), fstring("c")) && not_equal(var.axis<int>("ordinate"), 2), true);
+        EXPECT_EQ(res2.shape()[0], 1u);
+        EXPECT_EQ(res2.shape()[1], 7u);
+        EXPECT_EQ(res2.select({{"abscissa", "c"}, {"ordinate", 4}}), 10.);
+        EXPECT_ANY_THROW(res2.select({{"abscissa", "c"}, {"ordinate", 2}}));
+
+        auto res3 = where(var, equal(var.axis<fstring>("abscissa"), fstring("a")) || equal(var.axis<int>("ordinate"), 13), true);
+        EXPECT_EQ(res3.size(), 64u);
+        EXPECT_EQ(res3.select({{"abscissa", "n"}, {"ordinate", 13}}), 63.);
+        EXPECT_FALSE(res3.select({{"abscissa", "n"}, {"ordinate", 12}}).has_value());
+
+        auto res4 = where(var, var.axis<int>("ordinate") < 6, false);
+        EXPECT_EQ(res4.size(), 64u);
+        EXPECT_FALSE(res4.select({{"abscissa", "n"}, {"ordinate", 13}}).has_value());
+        EXPECT_EQ(res4.select({{"abscissa", "n"}, {"ordinate", 1}}), 56.);
+    }
 }
@@ -19,6 +19,60 @@ namespace xf
         EXPECT_EQ(view, view2);
     }
 
+    TEST(xvariable_view, select_missing_endpoints)
+    {
+        variable_type var = make_test_view_variable();
+        variable_view_type view = select(var, {{ "abscissa", range("e", "o") }, { "ordinate", range(3, 7, 2) }});
+        variable_view_type view2 = select(var, {{ "abscissa", range("f", "n") }, { "ordinate", range(4, 6, 2) }});
+        EXPECT_EQ(view, view2);
+
+        variable_view_type view3 = select(var, {{ "abscissa", range("i", "l") }, { "ordinate", range(1, 13) }});
+        EXPECT_EQ(view3.size(), 0u);
+    }
+
+    TEST(xvariable_view, assign_positions)
+    {
+        variable_type var = make_test_view_variable();
+        variable_type src = make_test_view_variable();
+
+        auto view = select(var, {{ "abscissa", range("c", "h", 2) }, { "ordinate", keep(2, 8, 13) }});
+        auto src_view = select(src, {{ "abscissa", range("c", "h", 2) }, { "ordinate", keep(2, 8, 13) }});
+        view = src_view + 100.;
+        EXPECT_EQ(var.select({{ "abscissa", "f" }, { "ordinate", 8 }}), 129.);
+        EXPECT_EQ(var.select({{ "abscissa", "h" }, { "ordinate", 13 }}), 147.);
+        EXPECT_EQ(var.select({{ "abscissa", "d" }, { "ordinate", 8 }}), 21.);
+        EXPECT_EQ(var.select({{ "abscissa", "c" }, { "ordinate", 4 }}), 10.);
+
+        auto row = select(var, {{ "abscissa", "g" }});
+        row = select(src, {{ "abscissa", "d" }});
+        EXPECT_EQ(var.select({{ "abscissa", "g" }, { "ordinate", 4 }}), 18.);
+        EXPECT_FALSE(var.select({{ "abscissa", "g" }, { "ordinate", 5 }}).has_value());
+        EXPECT_EQ(var.select({{ "abscissa", "h" }, { "ordinate", 5 }}), 43.);
+    }
+
+    TEST(xvariable_view, strided_data)
+    {
+        variable_type var = make_test_view_variable();
+        auto view = select(var, {{ "abscissa", range("c", "h", 2) }, { "ordinate", 5 }});
+        ASSERT_TRUE(view.is_strided());
+        ASSERT_EQ(view.strided_data().dimension(), 1u);
+        EXPECT_EQ(view.strided_data().shape()[0], 3u);
+        EXPECT_EQ(view.strided_data()(0), 11.);
+        EXPECT_EQ(view.strided_data()(2), 43.);
+        EXPECT_EQ(view(1), 27.);
+
+        variable_type copy = view;
+        EXPECT_EQ(copy.select({{ "abscissa", "f" }}), 27.);
+        EXPECT_EQ(copy.select({{ "abscissa", "h" }}), 43.);
+
+        view = 1.;
+        EXPECT_EQ(var.select({{ "abscissa", "f" }, { "ordinate", 5 }}), 1.);
+        EXPECT_EQ(var.select({{ "abscissa", "g" }, { "ordinate", 5 }}), 35.);
+
+        auto kept = select(var, {{ "abscissa", keep("a", "d") }});
+        EXPECT_FALSE(kept.is_strided());
+    }
+
     TEST(xvariable_view, size)
     {
         variable_type var = make_test_view_variable();
@@ -558,4 +612,22 @@ namespace xf
         EXPECT_EQ(view, view4);
         EXPECT_EQ(view, view5);
     }
+
+    TEST(xvariable_view, all_valid_write_through)
+    {
+        variable_type var = make_test_view_variable();
+        var.locate("d", 5) = 19.;
+        var.locate("d", 6) = 20.;
+        const variable_type& cvar = var;
+        EXPECT_TRUE(cvar.all_valid());
+
+        variable_view_type view = select(var, {{ "abscissa", range("c", "f") }, { "ordinate", range(1, 4) }});
+        view.locate("f", 2).has_value() = false;
+        EXPECT_FALSE(cvar.all_valid());
+
+        variable_type res = cvar + 1.;
+        EXPECT_FALSE(res.locate("f", 2).has_value());
+        EXPECT_EQ(res.locate("c", 2), 10.);
+        EXPECT_EQ(res.locate("d", 5), 20.);
+    }
 }